@@ -0,0 +1,32 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace bench {
+/**
+ * @brief Wall clock stopwatch started on construction.
+ */
+class Timer {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+public:
+  double seconds() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+};
+
+/**
+ * @brief Read a positional integer argument, falling back to a default when it is missing.
+ */
+inline size_t arg(int argc, char **argv, int i, size_t fallback) {
+  return i < argc ? std::stoul(argv[i]) : fallback;
+}
+
+/**
+ * @brief Keep the compiler from discarding a result that is only computed to be measured.
+ */
+template <typename T> void doNotOptimize(const T &value) { asm volatile("" : : "r,m"(value) : "memory"); }
+} // namespace bench
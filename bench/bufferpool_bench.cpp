@@ -0,0 +1,68 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <random>
+
+/**
+ * Hit rate and throughput of a HeapFile as the buffer pool grows.
+ * usage: bufferpool_bench [file pages = 20000] [point lookups = 200000]
+ */
+int main(int argc, char **argv) {
+  const size_t file_pages = bench::arg(argc, argv, 1, 20000);
+  const size_t lookups = bench::arg(argc, argv, 2, 200000);
+
+  db::Database &db = db::getDatabase();
+  const char *name = "bufferpool_bench.db";
+  std::remove(name);
+  db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  db::DbFile &file = db.get(name);
+  for (int i = 0; file.getNumPages() < file_pages; i++) {
+    file.insertTuple({{i, "bench", i * 0.5}});
+  }
+  db.getBufferPool().flushFile(name);
+
+  std::printf("%10s %12s %12s %14s %12s %14s %12s\n", "frames", "scan hit %", "scan reads", "scan MB/s",
+              "point hit %", "point ops/s", "evictions");
+  for (size_t frames : {50, 500, 5000, 50000, 250000}) {
+    db.configureBufferPool({.num_pages = frames});
+    db::BufferPool &bufferPool = db.getBufferPool();
+
+    // Warm up with one scan and measure the second one
+    size_t rows = 0;
+    for (const auto &t : file) {
+      rows++;
+    }
+    db::BufferPoolStats before = bufferPool.getStats();
+    bench::Timer scan_timer;
+    for (const auto &t : file) {
+      rows++;
+    }
+    double scan_seconds = scan_timer.seconds();
+    db::BufferPoolStats stats = bufferPool.getStats();
+    double scan_hits = 100.0 * (stats.hits - before.hits) / (stats.hits + stats.misses - before.hits - before.misses);
+    size_t scan_reads = stats.misses - before.misses;
+
+    // 80% of the lookups go to 20% of the pages
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<size_t> hot(0, file_pages / 5 - 1);
+    std::uniform_int_distribution<size_t> any(0, file_pages - 1);
+    std::bernoulli_distribution is_hot(0.8);
+    before = bufferPool.getStats();
+    bench::Timer point_timer;
+    for (size_t i = 0; i < lookups; i++) {
+      size_t page = is_hot(rng) ? hot(rng) : any(rng);
+      file.getTuple({file, page, 0});
+    }
+    double point_seconds = point_timer.seconds();
+    stats = bufferPool.getStats();
+    double point_hits = 100.0 * (stats.hits - before.hits) / (stats.hits + stats.misses - before.hits - before.misses);
+
+    std::printf("%10zu %12.2f %12zu %14.1f %12.2f %14.0f %12zu\n", frames, scan_hits, scan_reads,
+                file_pages * db::DEFAULT_PAGE_SIZE / scan_seconds / (1 << 20), point_hits, lookups / point_seconds,
+                stats.evictions);
+  }
+  db.remove(name);
+  std::remove(name);
+}
@@ -0,0 +1,81 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HeapPage.hpp>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+struct Workload {
+  const char *name;
+  double writes;
+};
+
+/**
+ * Each thread mixes point reads of a random tuple with in-place updates that rewrite a tuple under a write latch.
+ */
+void run(db::DbFile &file, const db::TupleDesc &td, size_t file_pages, size_t ops, double writes, size_t seed) {
+  db::BufferPool &bufferPool = db::getDatabase().getBufferPool();
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<size_t> page(0, file_pages - 1);
+  std::bernoulli_distribution is_write(writes);
+  for (size_t i = 0; i < ops; i++) {
+    size_t p = page(rng);
+    if (is_write(rng)) {
+      db::WritePageGuard guard = bufferPool.fetchWrite({file.getName(), p});
+      db::HeapPage hp(*guard, td);
+      hp.deleteTuple(0);
+      hp.insertTuple({{static_cast<int>(i), "bench", i * 0.5}});
+    } else {
+      file.getTuple({file, p, 0});
+    }
+  }
+}
+} // namespace
+
+/**
+ * Throughput of concurrent readers and writers on a HeapFile as threads are added, with one shard and with many.
+ * usage: concurrency_bench [file pages = 4000] [frames = 1000] [ops per thread = 50000] [shards = 16]
+ */
+int main(int argc, char **argv) {
+  const size_t file_pages = bench::arg(argc, argv, 1, 4000);
+  const size_t frames = bench::arg(argc, argv, 2, 1000);
+  const size_t ops = bench::arg(argc, argv, 3, 50000);
+  const size_t max_shards = bench::arg(argc, argv, 4, 16);
+
+  db::Database &db = db::getDatabase();
+  const char *name = "concurrency_bench.db";
+  std::remove(name);
+  db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  db::DbFile &file = db.get(name);
+  for (int i = 0; file.getNumPages() < file_pages; i++) {
+    file.insertTuple({{i, "bench", i * 0.5}});
+  }
+  db.getBufferPool().flushFile(name);
+
+  std::printf("%14s %8s %8s %14s %10s\n", "workload", "shards", "threads", "ops/s", "hit %");
+  for (Workload workload : {Workload{"read-only", 0.0}, Workload{"read-mostly", 0.05}, Workload{"balanced", 0.5}}) {
+    for (size_t shards : {size_t{1}, max_shards}) {
+      for (size_t num_threads : {1, 2, 4, 8, 16, 32, 64}) {
+        db.configureBufferPool({.num_pages = frames, .num_shards = shards});
+        std::vector<std::thread> threads;
+        bench::Timer timer;
+        for (size_t t = 0; t < num_threads; t++) {
+          threads.emplace_back(run, std::ref(file), std::cref(td), file_pages, ops, workload.writes, t);
+        }
+        for (auto &thread : threads) {
+          thread.join();
+        }
+        double seconds = timer.seconds();
+        db::BufferPoolStats stats = db.getBufferPool().getStats();
+        std::printf("%14s %8zu %8zu %14.0f %10.2f\n", workload.name, shards, num_threads,
+                    num_threads * ops / seconds, 100.0 * stats.hits / (stats.hits + stats.misses));
+      }
+    }
+  }
+  db.remove(name);
+  std::remove(name);
+}
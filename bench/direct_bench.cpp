@@ -0,0 +1,79 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <fcntl.h>
+#include <fstream>
+#include <random>
+#include <unistd.h>
+
+namespace {
+/**
+ * The size of the kernel page cache in MB, from /proc/meminfo.
+ */
+double pageCacheMb() {
+  std::ifstream meminfo("/proc/meminfo");
+  std::string key;
+  size_t kb;
+  std::string unit;
+  while (meminfo >> key >> kb >> unit) {
+    if (key == "Cached:") {
+      return kb / 1024.0;
+    }
+  }
+  return 0;
+}
+
+void dropCache(const char *name) {
+  int fd = open(name, O_RDONLY);
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+} // namespace
+
+/**
+ * Random page reads and updates through a BufferPool smaller than the file, with and without direct I/O. Reports how
+ * much the kernel page cache grew: with direct I/O the pool is the only copy of the pages in memory.
+ * usage: direct_bench [file MB = 512] [frames = 16384] [ops = 200000]
+ */
+int main(int argc, char **argv) {
+  const size_t file_pages = bench::arg(argc, argv, 1, 512) * (1 << 20) / db::DEFAULT_PAGE_SIZE;
+  const size_t frames = bench::arg(argc, argv, 2, 16384);
+  const size_t ops = bench::arg(argc, argv, 3, 200000);
+
+  const char *name = "direct_bench.db";
+  std::remove(name);
+  int fd = open(name, O_RDWR | O_CREAT, 0644);
+  ftruncate(fd, file_pages * db::DEFAULT_PAGE_SIZE);
+  close(fd);
+  db::Database &db = db::getDatabase();
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  db::file_id_t id = db.get(name).getId();
+
+  std::printf("%8s %12s %16s %16s\n", "direct", "ops/s", "page cache MB", "pool MB");
+  for (bool direct : {false, true}) {
+    db.configureBufferPool({.num_pages = frames, .direct_io = direct});
+    dropCache(name);
+    db::BufferPool &bufferPool = db.getBufferPool();
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<size_t> page(0, file_pages - 1);
+    double cache_before = pageCacheMb();
+    bench::Timer timer;
+    size_t sum = 0;
+    for (size_t i = 0; i < ops; i++) {
+      if (i % 8 == 0) {
+        bufferPool.fetchWrite({id, page(rng)})->at(0)++;
+      } else {
+        sum += bufferPool.fetchRead({id, page(rng)})->at(0);
+      }
+    }
+    bufferPool.flushFile(id);
+    double seconds = timer.seconds();
+    bench::doNotOptimize(sum);
+    std::printf("%8s %12.0f %16.1f %16.1f\n", db.get(id).isDirectIo() ? "on" : direct ? "refused" : "off",
+                ops / seconds, pageCacheMb() - cache_before, frames * db::DEFAULT_PAGE_SIZE / double(1 << 20));
+  }
+  db.remove(name);
+  std::remove(name);
+}
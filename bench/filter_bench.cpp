@@ -0,0 +1,76 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HeapLoader.hpp>
+#include <random>
+
+/**
+ * Warm scans of a HeapFile that fits in the BufferPool for the rows with `id < threshold`, at several selectivities:
+ * filtering Tuples built by the Iterator, filtering DataChunks filled by an unfiltered scan, and pushing the predicate
+ * into the scan with the scalar and the AVX2 evaluation. Reports the rows scanned per second.
+ * usage: filter_bench [rows = 1000000] [scans = 5]
+ */
+int main(int argc, char **argv) {
+  const size_t rows = bench::arg(argc, argv, 1, 1000000);
+  const size_t scans = bench::arg(argc, argv, 2, 5);
+
+  db::Database &db = db::getDatabase();
+  const char *name = "filter_bench.db";
+  std::remove(name);
+  std::remove("filter_bench.db.fsm");
+  db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  db.configureBufferPool({.num_pages = rows / 50 + 64});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  auto &file = dynamic_cast<db::HeapFile &>(db.get(name));
+  std::mt19937 rng(42);
+  {
+    db::HeapLoader loader(file);
+    for (size_t i = 0; i < rows; i++) {
+      int id = static_cast<int>(rng() % 1000000);
+      loader.append({{id, "bench", id * 0.5}});
+    }
+  }
+
+  db::DataChunk chunk(td);
+  std::printf("%12s %14s %14s %14s %14s\n", "selectivity", "tuple rows/s", "chunk rows/s", "scalar rows/s",
+              "simd rows/s");
+  for (double selectivity : {0.001, 0.01, 0.1, 0.5, 1.0}) {
+    int threshold = static_cast<int>(selectivity * 1000000);
+    std::vector<db::Predicate> predicates{{0, db::predicate_op_t::LT, threshold}};
+    double rate[4];
+    size_t found[4] = {};
+    for (int method = 0; method < 4; method++) {
+      db::Filter filter(td, predicates, method == 3);
+      bench::Timer timer;
+      for (size_t i = 0; i < scans; i++) {
+        if (method == 0) {
+          for (const db::Tuple &t : file) {
+            found[method] += std::get<int>(t.get_field(0)) < threshold;
+          }
+        } else if (method == 1) {
+          db::Iterator it = file.begin();
+          while (file.scan(it, chunk)) {
+            for (int id : chunk.ints(0)) {
+              found[method] += id < threshold;
+            }
+          }
+        } else {
+          db::Iterator it = file.begin();
+          while (size_t n = file.scan(it, chunk, filter)) {
+            found[method] += n;
+          }
+        }
+      }
+      rate[method] = scans * rows / timer.seconds();
+    }
+    if (found[0] != found[1] || found[0] != found[2] || found[0] != found[3]) {
+      std::printf("mismatch\n");
+      return 1;
+    }
+    std::printf("%11.1f%% %14.0f %14.0f %14.0f %14.0f\n", selectivity * 100, rate[0], rate[1], rate[2], rate[3]);
+  }
+  db.remove(name);
+  std::remove(name);
+  std::remove("filter_bench.db.fsm");
+}
@@ -0,0 +1,64 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HeapPage.hpp>
+#include <random>
+#include <vector>
+
+/**
+ * Latency of point reads mixed with in-place updates on a HeapFile larger than the pool, with and without the
+ * background flusher. Each miss whose victim is dirty pays for a write before its read.
+ * usage: flusher_bench [file pages = 20000] [frames = 2000] [ops = 200000] [write % = 30]
+ */
+int main(int argc, char **argv) {
+  const size_t file_pages = bench::arg(argc, argv, 1, 20000);
+  const size_t frames = bench::arg(argc, argv, 2, 2000);
+  const size_t ops = bench::arg(argc, argv, 3, 200000);
+  const size_t write_percent = bench::arg(argc, argv, 4, 30);
+
+  db::Database &db = db::getDatabase();
+  const char *name = "flusher_bench.db";
+  std::remove(name);
+  db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  db::DbFile &file = db.get(name);
+  for (int i = 0; file.getNumPages() < file_pages; i++) {
+    file.insertTuple({{i, "bench", i * 0.5}});
+  }
+  db.getBufferPool().flushFile(name);
+
+  std::printf("%10s %12s %14s %14s %12s %12s\n", "flusher", "ops/s", "read p50 ns", "read p99 ns", "sync writes",
+              "bg writes");
+  for (bool background_flush : {false, true}) {
+    db.configureBufferPool({.num_pages = frames, .background_flush = background_flush});
+    db::BufferPool &bufferPool = db.getBufferPool();
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<size_t> page(0, file_pages - 1);
+    std::uniform_int_distribution<size_t> percent(0, 99);
+    std::vector<double> reads;
+    reads.reserve(ops);
+    bench::Timer timer;
+    for (size_t i = 0; i < ops; i++) {
+      size_t p = page(rng);
+      if (percent(rng) < write_percent) {
+        db::WritePageGuard guard = bufferPool.fetchWrite({file.getId(), p});
+        db::HeapPage hp(*guard, td);
+        hp.deleteTuple(0);
+        hp.insertTuple({{static_cast<int>(i), "bench", i * 0.5}});
+      } else {
+        bench::Timer read;
+        file.getTuple({file, p, 0});
+        reads.push_back(read.seconds() * 1e9);
+      }
+    }
+    double seconds = timer.seconds();
+    std::sort(reads.begin(), reads.end());
+    db::BufferPoolStats stats = bufferPool.getStats();
+    std::printf("%10s %12.0f %14.0f %14.0f %12zu %12zu\n", background_flush ? "on" : "off", ops / seconds,
+                reads[reads.size() / 2], reads[reads.size() * 99 / 100], stats.sync_writes, stats.background_writes);
+  }
+  db.remove(name);
+  std::remove(name);
+}
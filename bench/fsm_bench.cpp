@@ -0,0 +1,70 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HeapPage.hpp>
+#include <random>
+
+/**
+ * Steady-state churn on a HeapFile: every round deletes a random fraction of the tuples and inserts as many new ones.
+ * Reports the size of the file and the insert throughput per round. Without reuse of freed slots the file would grow
+ * by the number of deleted tuples every round, which is printed for comparison.
+ * usage: fsm_bench [tuples = 200000] [rounds = 10] [delete % = 20] [frames = 4096]
+ */
+int main(int argc, char **argv) {
+  const size_t num_tuples = bench::arg(argc, argv, 1, 200000);
+  const size_t rounds = bench::arg(argc, argv, 2, 10);
+  const size_t delete_percent = bench::arg(argc, argv, 3, 20);
+  const size_t frames = bench::arg(argc, argv, 4, 4096);
+
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = frames});
+  const char *name = "fsm_bench.db";
+  std::remove(name);
+  std::remove("fsm_bench.db.fsm");
+  db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  db::DbFile &file = db.get(name);
+  int next_id = 0;
+  for (; next_id < static_cast<int>(num_tuples); next_id++) {
+    file.insertTuple({{next_id, "bench", next_id * 0.5}});
+  }
+  const size_t initial_pages = file.getNumPages();
+  db::Page empty{};
+  const size_t capacity = db::HeapPage(empty, td).end();
+
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<size_t> percent(0, 99);
+  size_t pages_without_reuse = initial_pages;
+  std::printf("%6s %10s %12s %18s %14s\n", "round", "deleted", "file pages", "pages w/o reuse", "inserts/s");
+  for (size_t round = 1; round <= rounds; round++) {
+    size_t deleted = 0;
+    for (size_t page = 0; page < file.getNumPages(); page++) {
+      std::vector<size_t> slots;
+      {
+        db::ReadPageGuard guard = db.getBufferPool().fetchRead({file.getId(), page});
+        const db::HeapPage hp(*guard, td);
+        for (size_t slot = hp.begin(); slot != hp.end(); hp.next(slot)) {
+          if (percent(rng) < delete_percent) {
+            slots.push_back(slot);
+          }
+        }
+      }
+      for (size_t slot : slots) {
+        file.deleteTuple({file, page, slot});
+      }
+      deleted += slots.size();
+    }
+    bench::Timer timer;
+    for (size_t i = 0; i < deleted; i++, next_id++) {
+      file.insertTuple({{next_id, "bench", next_id * 0.5}});
+    }
+    double seconds = timer.seconds();
+    pages_without_reuse += (deleted + capacity - 1) / capacity;
+    std::printf("%6zu %10zu %12zu %18zu %14.0f\n", round, deleted, file.getNumPages(), pages_without_reuse,
+                deleted / seconds);
+  }
+  db.remove(name);
+  std::remove(name);
+  std::remove("fsm_bench.db.fsm");
+}
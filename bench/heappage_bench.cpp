@@ -0,0 +1,122 @@
+#include "bench.hpp"
+
+#include <db/HeapPage.hpp>
+#include <random>
+
+namespace {
+bool occupied(const db::Page &page, size_t slot) { return page[slot / 8] & (1 << (7 - slot % 8)); }
+
+// The slot iteration HeapPage did before it scanned words, one bit at a time, out of line like HeapPage::next
+
+__attribute__((noinline)) size_t bitwiseBegin(const db::Page &page, size_t capacity) {
+  size_t slot = 0;
+  while (slot < capacity && !occupied(page, slot)) {
+    slot++;
+  }
+  return slot;
+}
+
+__attribute__((noinline)) void bitwiseNext(const db::Page &page, size_t capacity, size_t &slot) {
+  while (++slot < capacity && !occupied(page, slot)) {
+  }
+}
+
+size_t bitwiseCount(const db::Page &page, size_t capacity) {
+  size_t count = 0;
+  for (size_t slot = bitwiseBegin(page, capacity); slot < capacity; bitwiseNext(page, capacity, slot)) {
+    count++;
+  }
+  return count;
+}
+
+size_t bitwiseFreeSlot(const db::Page &page, size_t capacity) {
+  size_t slot = 0;
+  while (slot < capacity && occupied(page, slot)) {
+    slot++;
+  }
+  return slot;
+}
+} // namespace
+
+/**
+ * Cost of iterating the occupied slots of a HeapPage at several densities, and of inserting into a page whose only free
+ * slot is at a random position, scanning the header one bit at a time and a word at a time, for several tuple widths.
+ * Both inserts serialize the tuple.
+ * usage: heappage_bench [iterations = 100000]
+ */
+int main(int argc, char **argv) {
+  const size_t iterations = bench::arg(argc, argv, 1, 100000);
+
+  std::printf("%8s %8s %8s %14s %14s\n", "width", "slots", "occupied", "bit ns", "word ns");
+  std::vector<db::type_t> types;
+  std::vector<std::string> names;
+  for (db::type_t type : {db::type_t::INT, db::type_t::DOUBLE, db::type_t::INT, db::type_t::CHAR}) {
+    types.push_back(type);
+    names.push_back(std::to_string(names.size()));
+    db::TupleDesc td(types, names);
+    db::Page page{};
+    const size_t capacity = db::HeapPage(page, td).end();
+    std::mt19937 rng(42);
+    size_t sum = 0;
+
+    // Iterate pages with the slots occupied at random
+    for (size_t percent : {100, 50, 10}) {
+      page.fill(0);
+      for (size_t slot = 0; slot < capacity; slot++) {
+        if (rng() % 100 < percent) {
+          page[slot / 8] |= 1 << (7 - slot % 8);
+        }
+      }
+      bench::Timer timer;
+      for (size_t i = 0; i < iterations; i++) {
+        bench::doNotOptimize(page);
+        sum += bitwiseCount(page, capacity);
+      }
+      double bit_scan = timer.seconds();
+      timer = {};
+      for (size_t i = 0; i < iterations; i++) {
+        bench::doNotOptimize(page);
+        const db::HeapPage hp(page, td);
+        for (size_t slot = hp.begin(); slot != hp.end(); hp.next(slot)) {
+          sum++;
+        }
+      }
+      double word_scan = timer.seconds();
+      std::printf("%8zu %8zu %7zu%% %14.1f %14.1f\n", td.length(), capacity, percent, bit_scan / iterations * 1e9,
+                  word_scan / iterations * 1e9);
+    }
+
+    // Insert into the only free slot of a page
+    page.fill(0);
+    for (size_t slot = 0; slot < capacity; slot++) {
+      page[slot / 8] |= 1 << (7 - slot % 8);
+    }
+    std::vector<size_t> holes(1024);
+    for (size_t &hole : holes) {
+      hole = rng() % capacity;
+    }
+    db::Tuple tuple = db::HeapPage(page, td).getTuple(0);
+    std::vector<uint8_t> scratch(td.length());
+    bench::Timer timer;
+    for (size_t i = 0; i < iterations; i++) {
+      size_t hole = holes[i % holes.size()];
+      page[hole / 8] &= ~(1 << (7 - hole % 8));
+      bench::doNotOptimize(page);
+      size_t slot = bitwiseFreeSlot(page, capacity);
+      page[slot / 8] |= 1 << (7 - slot % 8);
+      td.serialize(scratch.data(), tuple);
+    }
+    double bit_insert = timer.seconds();
+    timer = {};
+    for (size_t i = 0; i < iterations; i++) {
+      size_t hole = holes[i % holes.size()];
+      page[hole / 8] &= ~(1 << (7 - hole % 8));
+      bench::doNotOptimize(page);
+      db::HeapPage(page, td).insertTuple(tuple);
+    }
+    double word_insert = timer.seconds();
+    bench::doNotOptimize(sum);
+    std::printf("%8zu %8zu %8s %14.1f %14.1f\n", td.length(), capacity, "insert", bit_insert / iterations * 1e9,
+                word_insert / iterations * 1e9);
+  }
+}
@@ -0,0 +1,107 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <db/PageTable.hpp>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+/// The page id as it was before files had integer ids
+struct NamedPageId {
+  std::string file;
+  size_t page;
+
+  bool operator==(const NamedPageId &) const = default;
+};
+
+struct NamedPageIdHash {
+  size_t operator()(const NamedPageId &r) const { return std::hash<std::string>()(r.file) ^ std::hash<size_t>()(r.page); }
+};
+
+template <typename F> void report(const char *name, size_t ops, F &&f) {
+  bench::Timer timer;
+  size_t sum = f();
+  double seconds = timer.seconds();
+  std::printf("%-34s %10.2f ns/hit   (checksum %zu)\n", name, seconds * 1e9 / ops, sum);
+}
+} // namespace
+
+/**
+ * Latency of a page table lookup and of a buffer pool hit when every page is resident. The contents of the pages are
+ * not read, so the buffer pool numbers are its bookkeeping only.
+ * usage: hit_latency_bench [resident pages = 4096] [lookups = 10000000]
+ */
+int main(int argc, char **argv) {
+  const size_t pages = bench::arg(argc, argv, 1, 4096);
+  const size_t lookups = bench::arg(argc, argv, 2, 10000000);
+
+  db::Database &db = db::getDatabase();
+  const char *name = "hit_latency_bench.db";
+  std::remove(name);
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  db::file_id_t id = db.get(name).getId();
+
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<size_t> page(0, pages - 1);
+  std::vector<uint32_t> trace(lookups);
+  for (auto &p : trace) {
+    p = page(rng);
+  }
+
+  std::unordered_map<NamedPageId, size_t, NamedPageIdHash> named;
+  std::unordered_map<db::PageId, size_t, std::hash<const db::PageId>> hashed;
+  db::PageTable table(pages);
+  for (size_t p = 0; p < pages; p++) {
+    named[{name, p}] = p;
+    hashed[{id, p}] = p;
+    table.insert({id, p}, p);
+  }
+
+  report("unordered_map, string PageId", lookups, [&] {
+    size_t sum = 0;
+    for (uint32_t p : trace) {
+      sum += named.find({name, p})->second;
+    }
+    return sum;
+  });
+  report("unordered_map, 64-bit PageId", lookups, [&] {
+    size_t sum = 0;
+    for (uint32_t p : trace) {
+      sum += hashed.find({id, p})->second;
+    }
+    return sum;
+  });
+  report("PageTable", lookups, [&] {
+    size_t sum = 0;
+    for (uint32_t p : trace) {
+      sum += table.find({id, p});
+    }
+    return sum;
+  });
+
+  db.configureBufferPool({.num_pages = pages});
+  db::BufferPool &bufferPool = db.getBufferPool();
+  for (size_t p = 0; p < pages; p++) {
+    bufferPool.getPage({id, p});
+  }
+  report("BufferPool::getPage", lookups, [&] {
+    size_t sum = 0;
+    for (uint32_t p : trace) {
+      sum += reinterpret_cast<uintptr_t>(bufferPool.getPage({id, p}).data()) >> 12;
+    }
+    return sum;
+  });
+  report("BufferPool::fetchRead", lookups, [&] {
+    size_t sum = 0;
+    for (uint32_t p : trace) {
+      sum += reinterpret_cast<uintptr_t>(bufferPool.fetchRead({id, p})->data()) >> 12;
+    }
+    return sum;
+  });
+  std::printf("misses: %zu\n", bufferPool.getStats().misses);
+
+  db.remove(name);
+  std::remove(name);
+}
@@ -0,0 +1,81 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <db/IoBackend.hpp>
+#include <db/PageArena.hpp>
+#include <fcntl.h>
+#include <random>
+#include <unistd.h>
+
+namespace {
+const char *backendName(db::io_backend_t backend) { return backend == db::io_backend_t::SYNC ? "sync" : "io_uring"; }
+} // namespace
+
+/**
+ * Random page reads in batches of increasing size straight through each I/O backend, with the latency of the calls
+ * rounded up to a power of two, then a BufferPool flushing
+ * random or sequential dirty pages of a file with each backend, with and without `fdatasync`.
+ * usage: io_bench [file pages = 65536] [reads = 100000] [frames = 16384]
+ */
+int main(int argc, char **argv) {
+  const size_t file_pages = bench::arg(argc, argv, 1, 65536);
+  const size_t num_reads = bench::arg(argc, argv, 2, 100000);
+  const size_t frames = bench::arg(argc, argv, 3, 16384);
+
+  const char *name = "io_bench.db";
+  std::remove(name);
+  int fd = open(name, O_RDWR | O_CREAT, 0644);
+  ftruncate(fd, file_pages * db::DEFAULT_PAGE_SIZE);
+
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<size_t> page(0, file_pages - 1);
+  std::printf("%10s %8s %14s %14s %14s\n", "backend", "batch", "reads/s", "call p50 ns", "call p99 ns");
+  for (db::io_backend_t backend : {db::io_backend_t::SYNC, db::io_backend_t::IO_URING}) {
+    for (unsigned batch : {1, 8, 32, 128}) {
+      std::unique_ptr<db::IoBackend> io = db::makeIoBackend(backend, batch);
+      db::PageArena arena(batch, false);
+      io->registerBuffers(arena.data(), arena.capacity());
+      std::vector<db::IoRequest> requests(batch);
+      bench::Timer timer;
+      for (size_t done = 0; done < num_reads; done += batch) {
+        for (unsigned i = 0; i < batch; i++) {
+          requests[i] = {fd, &arena[i], page(rng) * db::DEFAULT_PAGE_SIZE, false};
+        }
+        io->submit(requests);
+      }
+      double seconds = timer.seconds();
+      db::LatencyHistogram latency = io->getStats().latency;
+      std::printf("%10s %8u %14.0f %14zu %14zu\n", backendName(backend), batch, num_reads / seconds,
+                  db::latencyPercentile(latency, 0.5), db::latencyPercentile(latency, 0.99));
+    }
+  }
+  close(fd);
+
+  db::Database &db = db::getDatabase();
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  db::file_id_t id = db.get(name).getId();
+  std::printf("\n%10s %10s %6s %14s %14s\n", "backend", "dirty", "sync", "flush pages/s", "bytes/call");
+  for (db::io_backend_t backend : {db::io_backend_t::SYNC, db::io_backend_t::IO_URING}) {
+    for (bool sequential : {false, true}) {
+      for (bool sync : {false, true}) {
+        db.configureBufferPool({.num_pages = frames, .io_backend = backend, .sync_on_flush = sync});
+        db::BufferPool &bufferPool = db.getBufferPool();
+        for (size_t i = 0; i < frames; i++) {
+          bufferPool.fetchWrite({id, sequential ? i : page(rng)});
+        }
+        db::BufferPoolStats before = bufferPool.getStats();
+        bench::Timer timer;
+        bufferPool.flushFile(id);
+        double seconds = timer.seconds();
+        db::BufferPoolStats after = bufferPool.getStats();
+        size_t calls = after.write_calls - before.write_calls;
+        std::printf("%10s %10s %6s %14.0f %14.0f\n", backendName(backend), sequential ? "sequential" : "random",
+                    sync ? "yes" : "no", before.dirty_pages / seconds,
+                    double(after.bytes_written - before.bytes_written) / calls);
+      }
+    }
+  }
+  db.remove(name);
+  std::remove(name);
+}
@@ -0,0 +1,56 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HeapLoader.hpp>
+
+/**
+ * Loads rows into an empty HeapFile one insertTuple at a time, with insertTuples, and with a streaming HeapLoader.
+ * Each load ends with the file flushed to disk. Reports the rows loaded per second, and how many pages the load
+ * evicted from a BufferPool much smaller than the file.
+ * usage: load_bench [rows = 1000000] [frames = 1024]
+ */
+int main(int argc, char **argv) {
+  const size_t rows = bench::arg(argc, argv, 1, 1000000);
+  const size_t frames = bench::arg(argc, argv, 2, 1024);
+
+  db::Database &db = db::getDatabase();
+  const char *name = "load_bench.db";
+  db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  std::vector<db::Tuple> tuples;
+  tuples.reserve(rows);
+  for (size_t i = 0; i < rows; i++) {
+    tuples.push_back({{static_cast<int>(i), "bench", i * 0.5}});
+  }
+
+  std::printf("%12s %14s %10s %12s\n", "method", "rows/s", "pages", "evictions");
+  for (const char *method : {"insertTuple", "insertTuples", "HeapLoader"}) {
+    std::remove(name);
+    std::remove("load_bench.db.fsm");
+    db.configureBufferPool({.num_pages = frames});
+    db.add(std::make_unique<db::HeapFile>(name, td));
+    auto &file = dynamic_cast<db::HeapFile &>(db.get(name));
+    bench::Timer timer;
+    if (method == std::string("insertTuple")) {
+      for (const db::Tuple &t : tuples) {
+        file.insertTuple(t);
+      }
+    } else if (method == std::string("insertTuples")) {
+      file.insertTuples(tuples);
+    } else {
+      db::HeapLoader loader(file);
+      for (size_t i = 0; i < rows; i++) {
+        loader.append({{static_cast<int>(i), "bench", i * 0.5}});
+      }
+      loader.finish();
+    }
+    db.getBufferPool().flushFile(file.getId());
+    file.flushFreeSpaceMap();
+    double seconds = timer.seconds();
+    std::printf("%12s %14.0f %10zu %12zu\n", method, rows / seconds, file.getNumPages(),
+                db.getBufferPool().getStats().evictions);
+    db.remove(name);
+  }
+  std::remove(name);
+  std::remove("load_bench.db.fsm");
+}
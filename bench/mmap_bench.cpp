@@ -0,0 +1,76 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HeapPage.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+/**
+ * Fills the file with copies of one full heap page.
+ */
+void makeFile(const char *name, const db::TupleDesc &td, size_t file_pages) {
+  db::Page page{};
+  db::HeapPage hp(page, td);
+  for (int i = 0; hp.insertTuple({{i, "bench", i * 0.5}}); i++) {
+  }
+  int fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  for (size_t i = 0; i < file_pages; i++) {
+    pwrite(fd, page.data(), page.size(), i * page.size());
+  }
+  close(fd);
+}
+} // namespace
+
+/**
+ * Throughput of warm full scans of a HeapFile much larger than the BufferPool, read through the pool or from a
+ * read-only mapping of the file. The file stays in the kernel page cache, so the buffered scan pays for copying every
+ * page into a frame and for the bookkeeping of the pool.
+ * usage: mmap_bench [file MB = 512] [frames = DEFAULT_NUM_PAGES] [scans = 3]
+ */
+int main(int argc, char **argv) {
+  const size_t file_pages = bench::arg(argc, argv, 1, 512) * (1 << 20) / db::DEFAULT_PAGE_SIZE;
+  const size_t frames = bench::arg(argc, argv, 2, db::DEFAULT_NUM_PAGES);
+  const size_t scans = bench::arg(argc, argv, 3, 3);
+
+  db::Database &db = db::getDatabase();
+  const char *name = "mmap_bench.db";
+  db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  makeFile(name, td, file_pages);
+  db.configureBufferPool({.num_pages = frames});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  db::DbFile &file = db.get(name);
+
+  std::printf("%10s %14s %14s %14s\n", "mode", "tuples", "tuple MB/s", "page MB/s");
+  for (bool mapped : {false, true}) {
+    if (mapped) {
+      file.map();
+    }
+    size_t tuples = 0;
+    bench::Timer timer;
+    for (size_t i = 0; i < scans; i++) {
+      for (const auto &t : file) {
+        tuples++;
+      }
+    }
+    double tuple_seconds = timer.seconds();
+
+    // Read one tuple per page, so that the scan is bound by getting the pages rather than by decoding tuples
+    size_t sum = 0;
+    timer = {};
+    for (size_t i = 0; i < scans; i++) {
+      for (size_t page = 0; page < file_pages; page++) {
+        sum += std::get<int>(file.getTuple({file, page, 0}).get_field(0));
+      }
+    }
+    double page_seconds = timer.seconds();
+    bench::doNotOptimize(sum);
+    double bytes = double(scans) * file_pages * db::DEFAULT_PAGE_SIZE;
+    std::printf("%10s %14zu %14.1f %14.1f\n", mapped ? "mmap" : "buffered", tuples / scans,
+                bytes / tuple_seconds / (1 << 20), bytes / page_seconds / (1 << 20));
+  }
+  file.unmap();
+  db.remove(name);
+  std::remove(name);
+}
@@ -0,0 +1,105 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HeapLoader.hpp>
+#include <db/ParallelScan.hpp>
+#include <cmath>
+#include <random>
+
+/**
+ * Warm scans of a HeapFile that fits in a sharded BufferPool, summing one field of every row and of the rows selected
+ * by a filter: the serial scan through DataChunks, then a ParallelScan with 1, 2, 4, ... workers up to `max threads`.
+ * Reports the rows scanned per second, the speedup over the serial scan and the morsels stolen per scan.
+ * usage: parallel_bench [rows = 2000000] [scans = 5] [max threads = hardware threads] [morsel pages = 64]
+ */
+int main(int argc, char **argv) {
+  const size_t rows = bench::arg(argc, argv, 1, 2000000);
+  const size_t scans = bench::arg(argc, argv, 2, 5);
+  const size_t max_threads = bench::arg(argc, argv, 3, std::max(1u, std::thread::hardware_concurrency()));
+  const size_t morsel_pages = bench::arg(argc, argv, 4, 64);
+
+  db::Database &db = db::getDatabase();
+  const char *name = "parallel_bench.db";
+  std::remove(name);
+  std::remove("parallel_bench.db.fsm");
+  db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  db.configureBufferPool({.num_pages = rows / 50 + 64, .num_shards = 64});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  auto &file = dynamic_cast<db::HeapFile &>(db.get(name));
+  std::mt19937 rng(42);
+  {
+    db::HeapLoader loader(file);
+    for (size_t i = 0; i < rows; i++) {
+      int id = static_cast<int>(rng() % 1000000);
+      loader.append({{id, "bench", id * 0.5}});
+    }
+  }
+  std::printf("%zu pages, %u hardware threads\n", file.getNumPages(), std::thread::hardware_concurrency());
+
+  db::Projection projection(td, std::vector<size_t>{2});
+  std::vector<db::Predicate> predicates{{0, db::predicate_op_t::LT, 100000}};
+  db::Filter filter(td, predicates);
+  for (bool filtered : {false, true}) {
+    std::printf("%s\n", filtered ? "sum of price where id < 10%" : "sum of price");
+    db::DataChunk chunk(projection);
+    // Also brings the pages into the pool
+    double serial_sum = 0;
+    for (db::Iterator it = file.begin(); filtered ? file.scan(it, chunk, filter) : file.scan(it, chunk);) {
+      for (double price : chunk.doubles(0)) {
+        serial_sum += price;
+      }
+    }
+    bench::Timer serial_timer;
+    for (size_t i = 0; i < scans; i++) {
+      db::Iterator it = file.begin();
+      while (filtered ? file.scan(it, chunk, filter) : file.scan(it, chunk)) {
+        for (double price : chunk.doubles(0)) {
+          bench::doNotOptimize(price);
+        }
+      }
+    }
+    double serial = scans * rows / serial_timer.seconds();
+    std::printf("%8s %14s %10s %10s\n", "threads", "rows/s", "speedup", "steals");
+    std::printf("%8s %14.0f %10.2f %10s\n", "serial", serial, 1.0, "-");
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+      db::ThreadPool pool(threads);
+      db::ParallelScan scan(file, pool, morsel_pages);
+      // One sum per worker, each on a cache line of its own
+      struct alignas(64) Sum {
+        double value = 0;
+      };
+      std::vector<Sum> sums(threads);
+      auto consume = [&](size_t worker, const db::DataChunk &chunk) {
+        double sum = 0;
+        for (double price : chunk.doubles(0)) {
+          sum += price;
+        }
+        sums[worker].value += sum;
+      };
+      size_t steals = 0;
+      bench::Timer timer;
+      for (size_t i = 0; i < scans; i++) {
+        steals += (filtered ? scan.run(projection, filter, consume) : scan.run(projection, consume)).steals;
+      }
+      double rate = scans * rows / timer.seconds();
+      double total = 0;
+      for (const Sum &sum : sums) {
+        total += sum.value;
+      }
+      // The chunks are summed in another order: compare with some slack
+      if (std::abs(total - scans * serial_sum) > 1e-6 * std::abs(scans * serial_sum)) {
+        std::printf("mismatch\n");
+        return 1;
+      }
+      std::printf("%8zu %14.0f %10.2f %10zu\n", threads, rate, rate / serial, steals / scans);
+      if (threads < max_threads && threads * 2 > max_threads) {
+        threads = max_threads / 2;
+      }
+    }
+  }
+
+  db.remove(name);
+  std::remove(name);
+  std::remove("parallel_bench.db.fsm");
+}
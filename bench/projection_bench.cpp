@@ -0,0 +1,84 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HeapLoader.hpp>
+
+/**
+ * Warm scans of a HeapFile of wide rows (4 INT, 4 DOUBLE and 4 CHAR fields) that fits in the BufferPool, reading a
+ * few of the fields: from Tuples with every field decoded by the Iterator, from Tuples projected by a TupleView, and
+ * from DataChunks holding every field or only the selected ones. Reports the rows scanned per second.
+ * usage: projection_bench [rows = 200000] [scans = 5]
+ */
+int main(int argc, char **argv) {
+  const size_t rows = bench::arg(argc, argv, 1, 200000);
+  const size_t scans = bench::arg(argc, argv, 2, 5);
+
+  std::vector<db::type_t> types;
+  std::vector<std::string> names;
+  for (size_t i = 0; i < 4; i++) {
+    for (db::type_t type : {db::type_t::INT, db::type_t::DOUBLE, db::type_t::CHAR}) {
+      types.push_back(type);
+      names.push_back("f" + std::to_string(names.size()));
+    }
+  }
+  db::TupleDesc td(types, names);
+  std::vector<db::field_t> fields;
+  for (db::type_t type : types) {
+    fields.push_back(type == db::type_t::INT      ? db::field_t(1)
+                     : type == db::type_t::DOUBLE ? db::field_t(0.5)
+                                                  : db::field_t("a value too long for the small string buffer"));
+  }
+
+  db::Database &db = db::getDatabase();
+  const char *name = "projection_bench.db";
+  std::remove(name);
+  std::remove("projection_bench.db.fsm");
+  db.configureBufferPool({.num_pages = rows / 10 + 64});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  auto &file = dynamic_cast<db::HeapFile &>(db.get(name));
+  {
+    db::HeapLoader loader(file);
+    for (size_t i = 0; i < rows; i++) {
+      loader.append(db::Tuple(fields));
+    }
+  }
+
+  std::printf("%8s %16s %16s %16s %16s\n", "fields", "full tuple", "projected tuple", "full chunk",
+              "projected chunk");
+  std::vector<std::vector<size_t>> selections{{0}, {0, 1}, {0, 1, 2}, {0, 3, 6, 9, 1, 4, 7, 10}};
+  db::DataChunk full(td);
+  for (const std::vector<size_t> &columns : selections) {
+    db::Projection projection(td, columns);
+    db::DataChunk chunk(projection);
+    size_t sum = 0;
+    double rate[4];
+    for (int method = 0; method < 4; method++) {
+      bench::Timer timer;
+      for (size_t i = 0; i < scans; i++) {
+        if (method == 0) {
+          // Decode every field, then read the selected ones
+          for (const db::Tuple &t : file) {
+            sum += t.get_field(columns[0]).index();
+          }
+        } else if (method == 1) {
+          for (db::TupleView t : file.views(projection)) {
+            sum += t.materialize().get_field(0).index();
+          }
+        } else {
+          db::Iterator it = file.begin();
+          while (size_t n = file.scan(it, method == 2 ? full : chunk)) {
+            sum += n;
+          }
+        }
+      }
+      rate[method] = scans * rows / timer.seconds();
+    }
+    bench::doNotOptimize(sum);
+    std::printf("%5zu/%zu %16.0f %16.0f %16.0f %16.0f\n", columns.size(), types.size(), rate[0], rate[1], rate[2],
+                rate[3]);
+  }
+  db.remove(name);
+  std::remove(name);
+  std::remove("projection_bench.db.fsm");
+}
@@ -0,0 +1,78 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HeapPage.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+/**
+ * Fills the file with copies of one full heap page, then writes it to disk and drops it from the page cache.
+ */
+void makeFile(const char *name, const db::TupleDesc &td, size_t file_pages) {
+  db::Page page{};
+  db::HeapPage hp(page, td);
+  for (int i = 0; hp.insertTuple({{i, "bench", i * 0.5}}); i++) {
+  }
+  int fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  for (size_t i = 0; i < file_pages; i++) {
+    pwrite(fd, page.data(), page.size(), i * page.size());
+  }
+  close(fd);
+}
+
+void dropCache(const char *name) {
+  int fd = open(name, O_RDONLY);
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+} // namespace
+
+/**
+ * Throughput of a cold full scan of a HeapFile with each read-ahead mode.
+ * usage: readahead_bench [file MB = 2048] [frames = 4096] [window = 64]
+ */
+int main(int argc, char **argv) {
+  const size_t file_pages = bench::arg(argc, argv, 1, 2048) * (1 << 20) / db::DEFAULT_PAGE_SIZE;
+  const size_t frames = bench::arg(argc, argv, 2, 4096);
+  const size_t window = bench::arg(argc, argv, 3, 64);
+
+  db::Database &db = db::getDatabase();
+  const char *name = "readahead_bench.db";
+  db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  makeFile(name, td, file_pages);
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  const db::DbFile &file = db.get(name);
+
+  std::printf("%10s %14s %14s %14s %14s\n", "read-ahead", "tuples", "tuple MB/s", "page MB/s", "pages ahead");
+  for (auto [mode, label] : {std::pair{db::read_ahead_t::NONE, "none"}, std::pair{db::read_ahead_t::FADVISE, "fadvise"},
+                             std::pair{db::read_ahead_t::PREADV, "preadv"}}) {
+    db.configureBufferPool({.num_pages = frames, .read_ahead = mode, .read_ahead_window = window});
+    dropCache(name);
+    size_t tuples = 0;
+    bench::Timer timer;
+    for (const auto &t : file) {
+      tuples++;
+    }
+    double tuple_seconds = timer.seconds();
+
+    // Only touch the pages, so that the scan is bound by I/O rather than by decoding tuples
+    db.configureBufferPool({.num_pages = frames, .read_ahead = mode, .read_ahead_window = window});
+    dropCache(name);
+    db::BufferPool &bufferPool = db.getBufferPool();
+    size_t sum = 0;
+    timer = {};
+    for (size_t i = 0; i < file_pages; i++) {
+      sum += bufferPool.fetchRead({file.getId(), i})->at(0);
+    }
+    double page_seconds = timer.seconds();
+    bench::doNotOptimize(sum);
+    std::printf("%10s %14zu %14.1f %14.1f %14zu\n", label, tuples,
+                file_pages * db::DEFAULT_PAGE_SIZE / tuple_seconds / (1 << 20),
+                file_pages * db::DEFAULT_PAGE_SIZE / page_seconds / (1 << 20), bufferPool.getStats().read_ahead_pages);
+  }
+  db.remove(name);
+  std::remove(name);
+}
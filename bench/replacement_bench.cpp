@@ -0,0 +1,95 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <random>
+#include <vector>
+
+namespace {
+struct Access {
+  db::file_id_t file;
+  size_t page;
+  bool lookup;
+};
+
+/**
+ * Point lookups walk a root-to-leaf path of an index (a root, a few internal pages and many leaves) while sequential
+ * scans of a heap file, touching each page once per tuple, run concurrently with them.
+ */
+std::vector<Access> makeTrace(db::file_id_t index, db::file_id_t heap, size_t frames, size_t lookups, size_t scan_pages,
+                              size_t tuples_per_page) {
+  constexpr size_t fanout = 64;
+  const size_t leaves = frames * 2;
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<size_t> leaf(0, leaves - 1);
+  std::vector<Access> trace;
+  size_t scanned = 0;
+  for (size_t i = 0; i < lookups; i++) {
+    size_t l = leaf(rng);
+    trace.push_back({index, 0, true});
+    trace.push_back({index, 1 + l / fanout, true});
+    trace.push_back({index, 1 + leaves / fanout + 1 + l, true});
+    // one scan page per lookup, with every tuple of the page read in turn
+    for (size_t t = 0; t < tuples_per_page; t++) {
+      trace.push_back({heap, scanned % scan_pages, false});
+    }
+    scanned++;
+  }
+  return trace;
+}
+
+const char *policyName(db::replacement_t policy) {
+  switch (policy) {
+  case db::replacement_t::LRU:
+    return "LRU";
+  case db::replacement_t::CLOCK:
+    return "CLOCK";
+  case db::replacement_t::LRU_K:
+    return "LRU-2";
+  case db::replacement_t::TWO_Q:
+    return "2Q";
+  }
+  return "?";
+}
+} // namespace
+
+/**
+ * Replays a mixed scan and point lookup trace against each replacement policy.
+ * usage: replacement_bench [frames = 1000] [lookups = 200000] [scan pages = 20000]
+ */
+int main(int argc, char **argv) {
+  const size_t frames = bench::arg(argc, argv, 1, 1000);
+  const size_t lookups = bench::arg(argc, argv, 2, 200000);
+  const size_t scan_pages = bench::arg(argc, argv, 3, 20000);
+
+  db::Database &db = db::getDatabase();
+  db::TupleDesc td;
+  std::remove("index");
+  std::remove("heap");
+  db.add(std::make_unique<db::DbFile>("index", td));
+  db.add(std::make_unique<db::DbFile>("heap", td));
+  std::vector<Access> trace =
+      makeTrace(db.get("index").getId(), db.get("heap").getId(), frames, lookups, scan_pages, 53);
+
+  std::printf("%8s %14s %14s %14s %12s\n", "policy", "lookup hit %", "scan hit %", "overall hit %", "ns/access");
+  for (db::replacement_t policy :
+       {db::replacement_t::LRU, db::replacement_t::CLOCK, db::replacement_t::LRU_K, db::replacement_t::TWO_Q}) {
+    db.configureBufferPool({.num_pages = frames, .policy = policy});
+    db::BufferPool &bufferPool = db.getBufferPool();
+    size_t hits[2]{};
+    size_t total[2]{};
+    bench::Timer timer;
+    for (const Access &access : trace) {
+      size_t misses = bufferPool.getStats().misses;
+      bufferPool.getPage({access.file, access.page});
+      hits[access.lookup] += bufferPool.getStats().misses == misses;
+      total[access.lookup]++;
+    }
+    double seconds = timer.seconds();
+    std::printf("%8s %14.2f %14.2f %14.2f %12.1f\n", policyName(policy), 100.0 * hits[1] / total[1],
+                100.0 * hits[0] / total[0], 100.0 * (hits[0] + hits[1]) / trace.size(), seconds * 1e9 / trace.size());
+  }
+  db.remove("index");
+  db.remove("heap");
+  std::remove("index");
+  std::remove("heap");
+}
@@ -0,0 +1,83 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HeapLoader.hpp>
+#include <new>
+
+namespace {
+size_t allocations = 0;
+} // namespace
+
+void *operator new(size_t size) {
+  allocations++;
+  if (void *p = std::malloc(size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+/**
+ * Warm full scans of a HeapFile that fits in the BufferPool, summing one INT column and the length of one CHAR column,
+ * through Tuples built by the Iterator, through TupleViews, and through DataChunks of 2048 rows filled by
+ * DbFile::scan. Reports the rows scanned per second and the heap allocations made per row.
+ * usage: scan_bench [rows = 1000000] [scans = 5]
+ */
+int main(int argc, char **argv) {
+  const size_t rows = bench::arg(argc, argv, 1, 1000000);
+  const size_t scans = bench::arg(argc, argv, 2, 5);
+
+  db::Database &db = db::getDatabase();
+  const char *name = "scan_bench.db";
+  std::remove(name);
+  std::remove("scan_bench.db.fsm");
+  db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  db.configureBufferPool({.num_pages = rows / 50 + 64});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  auto &file = dynamic_cast<db::HeapFile &>(db.get(name));
+  {
+    db::HeapLoader loader(file);
+    for (size_t i = 0; i < rows; i++) {
+      loader.append({{static_cast<int>(i), "a name longer than the small string buffer", i * 0.5}});
+    }
+  }
+
+  std::printf("%8s %14s %14s\n", "access", "rows/s", "allocs/row");
+  db::DataChunk chunk(td);
+  for (const char *access : {"tuple", "view", "chunk"}) {
+    size_t sum = 0;
+    size_t before = allocations;
+    bench::Timer timer;
+    for (size_t i = 0; i < scans; i++) {
+      if (access == std::string("tuple")) {
+        for (const db::Tuple &t : file) {
+          sum += std::get<int>(t.get_field(0)) + std::get<std::string>(t.get_field(1)).size();
+        }
+      } else if (access == std::string("view")) {
+        for (db::TupleView t : file.views()) {
+          sum += t.get_int(0) + t.get_string_view(1).size();
+        }
+      } else {
+        db::Iterator it = file.begin();
+        while (file.scan(it, chunk)) {
+          for (int id : chunk.ints(0)) {
+            sum += id;
+          }
+          for (std::string_view name : chunk.strings(1)) {
+            sum += name.size();
+          }
+        }
+      }
+    }
+    double seconds = timer.seconds();
+    bench::doNotOptimize(sum);
+    std::printf("%8s %14.0f %14.2f\n", access, scans * rows / seconds, double(allocations - before) / (scans * rows));
+  }
+  db.remove(name);
+  std::remove(name);
+  std::remove("scan_bench.db.fsm");
+}
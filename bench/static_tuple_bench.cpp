@@ -0,0 +1,138 @@
+#include "bench.hpp"
+
+#include <db/BTreeFile.hpp>
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/StaticTupleDesc.hpp>
+#include <random>
+
+/**
+ * The hot loops of a fixed (INT, CHAR, DOUBLE) schema, through a TupleDesc and Tuples, then through a StaticTupleDesc
+ * and its rows: serializing and deserializing rows in memory, inserting them into a HeapFile and a BTreeFile, and
+ * summing two fields over the views of a scan. Reports the rows per second of each loop and the speedup.
+ * usage: static_tuple_bench [rows = 1000000] [btree rows = 200000]
+ */
+int main(int argc, char **argv) {
+  const size_t rows = bench::arg(argc, argv, 1, 1000000);
+  const size_t btree_rows = bench::arg(argc, argv, 2, 200000);
+
+  using Row = db::StaticTupleDesc<int, db::Char, double>;
+  db::TupleDesc td = Row::desc({"id", "name", "price"});
+  std::mt19937 rng(42);
+  std::vector<Row::row_type> values;
+  std::vector<db::Tuple> tuples;
+  for (size_t i = 0; i < rows; i++) {
+    int id = static_cast<int>(rng() % 1000000);
+    values.emplace_back(id, "bench", id * 0.5);
+    tuples.push_back(Row::tuple(values.back()));
+  }
+
+  std::printf("%-12s %14s %14s %10s\n", "loop", "dynamic rows/s", "static rows/s", "speedup");
+  auto report = [](const char *loop, size_t n, double dynamic, double fixed) {
+    std::printf("%-12s %14.0f %14.0f %10.2f\n", loop, n / dynamic, n / fixed, dynamic / fixed);
+  };
+
+  std::vector<uint8_t> buffer(rows * td.length());
+  {
+    bench::Timer timer;
+    for (size_t i = 0; i < rows; i++) {
+      td.serialize(buffer.data() + i * td.length(), tuples[i]);
+    }
+    double dynamic = timer.seconds();
+    bench::doNotOptimize(buffer.data());
+    bench::Timer static_timer;
+    for (size_t i = 0; i < rows; i++) {
+      Row::serialize(buffer.data() + i * Row::length(), values[i]);
+    }
+    double fixed = static_timer.seconds();
+    bench::doNotOptimize(buffer.data());
+    report("serialize", rows, dynamic, fixed);
+  }
+  {
+    bench::Timer timer;
+    for (size_t i = 0; i < rows; i++) {
+      db::Tuple t = td.deserialize(buffer.data() + i * td.length());
+      bench::doNotOptimize(t);
+    }
+    double dynamic = timer.seconds();
+    bench::Timer static_timer;
+    for (size_t i = 0; i < rows; i++) {
+      Row::row_type row = Row::deserialize(buffer.data() + i * Row::length());
+      bench::doNotOptimize(row);
+    }
+    report("deserialize", rows, dynamic, static_timer.seconds());
+  }
+
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = rows / 40 + 64});
+  auto open = [&](const char *name, auto make) -> db::DbFile & {
+    std::remove(name);
+    std::remove((std::string(name) + ".fsm").c_str());
+    db.add(make(name));
+    return db.get(name);
+  };
+  auto close = [&](const char *name) {
+    db.remove(name);
+    std::remove(name);
+    std::remove((std::string(name) + ".fsm").c_str());
+  };
+  auto heap = [&](const char *name) { return std::make_unique<db::HeapFile>(name, td); };
+  auto btree = [&](const char *name) { return std::make_unique<db::BTreeFile>(name, td, 0); };
+
+  // The values are inserted as an application holds them: a Tuple is built for each insertTuple
+  {
+    auto &dynamic_file = dynamic_cast<db::HeapFile &>(open("dynamic_heap.db", heap));
+    bench::Timer timer;
+    for (const auto &[id, name, price] : values) {
+      dynamic_file.insertTuple({{id, name, price}});
+    }
+    double dynamic = timer.seconds();
+    auto &static_file = dynamic_cast<db::HeapFile &>(open("static_heap.db", heap));
+    bench::Timer static_timer;
+    for (const Row::row_type &row : values) {
+      static_file.insertSerialized(Row::serialize(row));
+    }
+    report("heap insert", rows, dynamic, static_timer.seconds());
+
+    int64_t dynamic_sum = 0;
+    double dynamic_price = 0;
+    bench::Timer scan_timer;
+    for (db::TupleView view : dynamic_file.views()) {
+      dynamic_sum += view.get_int(0);
+      dynamic_price += view.get_double(2);
+    }
+    double dynamic_scan = scan_timer.seconds();
+    int64_t static_sum = 0;
+    double static_price = 0;
+    bench::Timer static_scan_timer;
+    for (db::TupleView view : static_file.views()) {
+      static_sum += Row::get<0>(view.bytes());
+      static_price += Row::get<2>(view.bytes());
+    }
+    double static_scan = static_scan_timer.seconds();
+    if (dynamic_sum != static_sum || dynamic_price != static_price) {
+      std::printf("mismatch\n");
+      return 1;
+    }
+    report("heap scan", rows, dynamic_scan, static_scan);
+    close("dynamic_heap.db");
+    close("static_heap.db");
+  }
+  {
+    auto &dynamic_file = dynamic_cast<db::BTreeFile &>(open("dynamic_btree.db", btree));
+    bench::Timer timer;
+    for (size_t i = 0; i < btree_rows; i++) {
+      const auto &[id, name, price] = values[i];
+      dynamic_file.insertTuple({{id, name, price}});
+    }
+    double dynamic = timer.seconds();
+    auto &static_file = dynamic_cast<db::BTreeFile &>(open("static_btree.db", btree));
+    bench::Timer static_timer;
+    for (size_t i = 0; i < btree_rows; i++) {
+      static_file.insertSerialized(Row::serialize(values[i]));
+    }
+    report("btree insert", btree_rows, dynamic, static_timer.seconds());
+    close("dynamic_btree.db");
+    close("static_btree.db");
+  }
+}
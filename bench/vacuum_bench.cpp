@@ -0,0 +1,92 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HeapLoader.hpp>
+#include <db/HeapVacuum.hpp>
+#include <random>
+
+namespace {
+/// The milliseconds of a warm scan of a file through DataChunks
+double scanMillis(const db::HeapFile &file, size_t scans, size_t expected) {
+  db::DataChunk chunk(file.getTupleDesc());
+  bench::Timer timer;
+  for (size_t i = 0; i < scans; i++) {
+    size_t rows = 0;
+    db::Iterator it = file.begin();
+    while (size_t n = file.scan(it, chunk)) {
+      rows += n;
+    }
+    if (rows != expected) {
+      std::printf("mismatch\n");
+      std::exit(1);
+    }
+  }
+  return timer.seconds() * 1000 / scans;
+}
+} // namespace
+
+/**
+ * Churns a HeapFile: loads `rows` rows, deletes a random `deleted` percent of them and inserts a tenth of the rows
+ * deleted back into the holes. Compares warm scans of the churned file, of the file after a HeapVacuum, and of a
+ * file freshly loaded with as many rows, and reports the pages and scan times, and how fast the vacuum moved
+ * tuples.
+ * usage: vacuum_bench [rows = 1000000] [deleted = 80] [scans = 5]
+ */
+int main(int argc, char **argv) {
+  const size_t rows = bench::arg(argc, argv, 1, 1000000);
+  const size_t deleted = bench::arg(argc, argv, 2, 80);
+  const size_t scans = bench::arg(argc, argv, 3, 5);
+
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = 2 * (rows / 50 + 64)});
+  db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  const char *files[] = {"vacuum_bench_churned.db", "vacuum_bench_fresh.db"};
+  for (const char *name : files) {
+    std::remove(name);
+    std::remove((std::string(name) + ".fsm").c_str());
+    db.add(std::make_unique<db::HeapFile>(name, td));
+  }
+  auto &churned = dynamic_cast<db::HeapFile &>(db.get(files[0]));
+  auto &fresh = dynamic_cast<db::HeapFile &>(db.get(files[1]));
+  std::mt19937 rng(42);
+  churned.insertTuples(std::vector<db::Tuple>(rows, db::Tuple({1, "row", 0.5})));
+  size_t live = rows;
+  for (db::Iterator it = churned.begin(); it != churned.end(); ++it) {
+    if (rng() % 100 < deleted) {
+      churned.deleteTuple(it);
+      live--;
+    }
+  }
+  for (size_t i = 0; i < (rows - live) / 10; i++) {
+    churned.insertTuple({{2, "new", 1.5}});
+  }
+  live += (rows - live) / 10;
+  fresh.insertTuples(std::vector<db::Tuple>(live, db::Tuple({1, "row", 0.5})));
+  // Bring both files into the BufferPool
+  scanMillis(churned, 1, live);
+  scanMillis(fresh, 1, live);
+
+  std::printf("%zu rows, %zu live\n", rows, live);
+  std::printf("%10s %10s %12s\n", "file", "pages", "scan ms");
+  std::printf("%10s %10zu %12.2f\n", "churned", churned.getNumPages(), scanMillis(churned, scans, live));
+  size_t moved = 0;
+  size_t steps = 0;
+  bench::Timer timer;
+  db::HeapVacuum vacuum(churned, {.moves_per_step = 1024});
+  size_t truncated = vacuum.run([&](std::span<const db::TupleMove> moves) {
+    moved += moves.size();
+    steps++;
+  });
+  double seconds = timer.seconds();
+  std::printf("%10s %10zu %12.2f\n", "vacuumed", churned.getNumPages(), scanMillis(churned, scans, live));
+  std::printf("%10s %10zu %12.2f\n", "fresh", fresh.getNumPages(), scanMillis(fresh, scans, live));
+  std::printf("vacuum: %zu tuples moved in %zu steps, %zu pages truncated, %.1f ms, %.0f tuples/s\n", moved, steps,
+              truncated, seconds * 1000, moved / seconds);
+
+  for (const char *name : files) {
+    db.remove(name);
+    std::remove(name);
+    std::remove((std::string(name) + ".fsm").c_str());
+  }
+}
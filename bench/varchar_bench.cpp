@@ -0,0 +1,91 @@
+#include "bench.hpp"
+
+#include <cmath>
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HeapLoader.hpp>
+#include <random>
+
+/**
+ * Loads the same rows, an INT id and a string, into a HeapFile storing the string in a CHAR field and one storing it
+ * in a VARCHAR field, for several distributions of string lengths. Reports the pages of each file, the strings CHAR
+ * truncates, and the rows per second of warm scans through the Iterator and through DataChunks.
+ * usage: varchar_bench [rows = 200000] [scans = 5]
+ */
+int main(int argc, char **argv) {
+  const size_t rows = bench::arg(argc, argv, 1, 200000);
+  const size_t scans = bench::arg(argc, argv, 2, 5);
+
+  struct Distribution {
+    const char *name;
+    double median;
+    double sigma;
+  };
+  // Log-normal lengths: most strings are short, a few are much longer
+  std::vector<Distribution> distributions{
+      {"names", 10, 0.3}, {"emails", 22, 0.3}, {"addresses", 40, 0.4}, {"comments", 80, 0.8}};
+
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = rows / 8 + 64});
+  std::printf("%10s %8s %10s %10s %10s %14s %14s %14s %14s\n", "strings", "mean len", "truncated", "CHAR pages",
+              "VAR pages", "CHAR tuple/s", "VAR tuple/s", "CHAR chunk/s", "VAR chunk/s");
+  for (const Distribution &d : distributions) {
+    std::mt19937 rng(42);
+    std::lognormal_distribution<double> length(std::log(d.median), d.sigma);
+    std::vector<std::string> strings;
+    size_t total = 0;
+    size_t truncated = 0;
+    for (size_t i = 0; i < rows; i++) {
+      size_t n = std::min<size_t>(std::lround(length(rng)), 1000);
+      strings.emplace_back(n, static_cast<char>('a' + i % 26));
+      total += n;
+      // strncpy keeps at most CHAR_SIZE characters
+      truncated += n > db::CHAR_SIZE;
+    }
+
+    size_t pages[2];
+    double tuple_rate[2];
+    double chunk_rate[2];
+    for (int variable = 0; variable < 2; variable++) {
+      db::TupleDesc td({db::type_t::INT, variable ? db::type_t::VARCHAR : db::type_t::CHAR}, {"id", "value"});
+      const char *name = "varchar_bench.db";
+      std::remove(name);
+      std::remove("varchar_bench.db.fsm");
+      db.add(std::make_unique<db::HeapFile>(name, td));
+      auto &file = dynamic_cast<db::HeapFile &>(db.get(name));
+      {
+        db::HeapLoader loader(file);
+        for (size_t i = 0; i < rows; i++) {
+          loader.append({{static_cast<int>(i), strings[i]}});
+        }
+      }
+      pages[variable] = file.getNumPages();
+
+      size_t sum = 0;
+      bench::Timer timer;
+      for (size_t s = 0; s < scans; s++) {
+        for (const db::Tuple &t : file) {
+          sum += std::get<std::string>(t.get_field(1)).size();
+        }
+      }
+      tuple_rate[variable] = scans * rows / timer.seconds();
+      db::DataChunk chunk(td);
+      timer = bench::Timer();
+      for (size_t s = 0; s < scans; s++) {
+        db::Iterator it = file.begin();
+        while (file.scan(it, chunk)) {
+          for (std::string_view value : chunk.strings(1)) {
+            sum += value.size();
+          }
+        }
+      }
+      chunk_rate[variable] = scans * rows / timer.seconds();
+      bench::doNotOptimize(sum);
+      db.remove(name);
+      std::remove(name);
+      std::remove("varchar_bench.db.fsm");
+    }
+    std::printf("%10s %8.1f %10zu %10zu %10zu %14.0f %14.0f %14.0f %14.0f\n", d.name, double(total) / rows, truncated,
+                pages[0], pages[1], tuple_rate[0], tuple_rate[1], chunk_rate[0], chunk_rate[1]);
+  }
+}
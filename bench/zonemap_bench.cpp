@@ -0,0 +1,95 @@
+#include "bench.hpp"
+
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HeapLoader.hpp>
+#include <random>
+
+/**
+ * Filtered scans of the same rows (a roughly clustered INT timestamp, a random INT and a DOUBLE) stored in a HeapFile
+ * without and with a zone map: windows of timestamps of several widths, and a predicate on the random field that the
+ * zone map cannot use. The BufferPool holds `pool` pages, fewer than the file when it is smaller than `rows / 100`,
+ * so that the pages the zone map does not skip are read from the file. Reports the rows scanned per second, and the
+ * pages skipped and bytes avoided per query.
+ * usage: zonemap_bench [rows = 1000000] [scans = 5] [pool = rows / 50 + 64]
+ */
+int main(int argc, char **argv) {
+  const size_t rows = bench::arg(argc, argv, 1, 1000000);
+  const size_t scans = bench::arg(argc, argv, 2, 5);
+  const size_t pool = bench::arg(argc, argv, 3, rows / 50 + 64);
+
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = pool});
+  db::TupleDesc td({db::type_t::INT, db::type_t::INT, db::type_t::DOUBLE}, {"ts", "value", "price"});
+  const char *files[] = {"zonemap_bench_plain.db", "zonemap_bench_zones.db"};
+  for (int zoned = 0; zoned < 2; zoned++) {
+    std::remove(files[zoned]);
+    std::remove((std::string(files[zoned]) + ".fsm").c_str());
+    std::remove((std::string(files[zoned]) + ".zm").c_str());
+    db.add(std::make_unique<db::HeapFile>(files[zoned], td, db::page_layout_t::ROW, zoned));
+  }
+  auto &plain = dynamic_cast<db::HeapFile &>(db.get(files[0]));
+  auto &zones = dynamic_cast<db::HeapFile &>(db.get(files[1]));
+  std::mt19937 rng(42);
+  {
+    db::HeapLoader plain_loader(plain);
+    db::HeapLoader zones_loader(zones);
+    for (size_t i = 0; i < rows; i++) {
+      // Rows arrive a little out of order
+      int ts = static_cast<int>(i + rng() % 1000);
+      int value = static_cast<int>(rng() % 1000000);
+      db::Tuple t({ts, value, value * 0.5});
+      plain_loader.append(t);
+      zones_loader.append(t);
+    }
+  }
+  std::printf("%zu pages, %zu pages in the pool\n", zones.getNumPages(), pool);
+
+  struct Query {
+    const char *name;
+    std::vector<db::Predicate> predicates;
+  };
+  int n = static_cast<int>(rows);
+  std::vector<Query> queries{
+      {"ts 0.1%", {{0, db::predicate_op_t::BETWEEN, n / 2, n / 2 + n / 1000}}},
+      {"ts 1%", {{0, db::predicate_op_t::BETWEEN, n / 2, n / 2 + n / 100}}},
+      {"ts 10%", {{0, db::predicate_op_t::BETWEEN, n / 2, n / 2 + n / 10}}},
+      {"ts >= 99%", {{0, db::predicate_op_t::GE, n - n / 100}}},
+      {"value 1%", {{1, db::predicate_op_t::LT, 10000}}},
+  };
+  std::printf("%10s %14s %14s %14s %14s\n", "query", "plain rows/s", "zones rows/s", "pages skipped",
+              "bytes avoided");
+  db::DataChunk chunk(td);
+  for (const Query &query : queries) {
+    db::Filter filter(td, query.predicates);
+    double rate[2];
+    size_t found[2] = {};
+    db::ZoneMapStats before = zones.getZoneMap()->getStats();
+    for (int zoned = 0; zoned < 2; zoned++) {
+      db::HeapFile &file = zoned ? zones : plain;
+      bench::Timer timer;
+      for (size_t i = 0; i < scans; i++) {
+        db::Iterator it = file.begin();
+        while (size_t n = file.scan(it, chunk, filter)) {
+          found[zoned] += n;
+        }
+      }
+      rate[zoned] = scans * rows / timer.seconds();
+    }
+    if (found[0] != found[1]) {
+      std::printf("mismatch\n");
+      return 1;
+    }
+    db::ZoneMapStats after = zones.getZoneMap()->getStats();
+    std::printf("%10s %14.0f %14.0f %14zu %14zu\n", query.name, rate[0], rate[1],
+                (after.pages_skipped - before.pages_skipped) / scans,
+                (after.bytes_skipped - before.bytes_skipped) / scans);
+  }
+
+  for (const char *name : files) {
+    db.remove(name);
+    std::remove(name);
+    std::remove((std::string(name) + ".fsm").c_str());
+    std::remove((std::string(name) + ".zm").c_str());
+  }
+}
@@ -1,3 +1,5 @@
+#include <array>
+#include <algorithm>
 #include <cstring>
 #include <db/BTreeFile.hpp>
 #include <db/Database.hpp>
@@ -8,212 +10,183 @@
 using namespace db;
 
 BTreeFile::BTreeFile(const std::string &name, const TupleDesc &td, size_t key_index)
-    : DbFile(name, td), key_index(key_index) {}
-
-void BTreeFile::insertTuple(const Tuple &t) {
-  // TODO pa2: implement
-
-  if (!td.compatible(t)) {
-    throw std::invalid_argument("Tuple is not compatible with Tuple Desc");
+    : DbFile(name, td), key_index(key_index) {
+  if (td.variable_length()) {
+    throw std::invalid_argument("BTreeFile does not support VARCHAR fields");
   }
+}
 
-  BufferPool &buffer_pool = getDatabase().getBufferPool();
-
-  //get first page that is the root
-  PageId pid{name, 0};
-  Page &rootPage = buffer_pool.getPage(pid);
-
-  //if root is empty, insert leaf page
-  if (rootPage.empty()) {
-    LeafPage leaf(rootPage, td, key_index);
-
-    if (leaf.insertTuple(t)) {
-      buffer_pool.markDirty(pid);
-    }
-  } else {
-    //get the root indexpage
-    IndexPage root(rootPage);
-
-    // Check if the root page can accommodate the new tuple.
-    if (insertTupleRecursive(root, t)) {
-      PageId newPid{name, numPages++};
-      Page &newPage = buffer_pool.getPage(newPid);
-      IndexPage newRoot(newPage);
-
-      int splitKey = root.split(newRoot);
+template <typename F> void BTreeFile::insert(int key, F &&insert) {
+  // The root stays pinned for the whole insertion
+  WritePageGuard root_guard = fetchWrite(root_id);
+  IndexPage root(*root_guard);
 
-      // Update new root with the original root and the new split page.
-      newRoot.insert(splitKey, pid.page);
-      buffer_pool.markDirty(newPid);
-    }
+  // An empty tree has a root without children: create the first leaf
+  if (root.header->size == 0 && root.children[0] == root_id) {
+    root.header->index_children = false;
+    root.children[0] = numPages++;
+  }
 
-    buffer_pool.markDirty(pid);
+  if (!insertRecursive(root, key, insert)) {
+    return;
   }
+
+  // The root is full: move its contents to two new pages and make it their parent
+  WritePageGuard left_guard = fetchWrite(numPages++);
+  WritePageGuard right_guard = fetchWrite(numPages++);
+  *left_guard = *root_guard;
+  IndexPage left(*left_guard);
+  IndexPage right(*right_guard);
+  int split_key = left.split(right);
+
+  root_guard->fill(0);
+  root.header->index_children = true;
+  root.children[0] = left_guard.getPageId().page;
+  root.insert(split_key, right_guard.getPageId().page);
 }
 
-bool BTreeFile::insertTupleRecursive(IndexPage &node, const Tuple &t) {
-  BufferPool &buffer_pool = getDatabase().getBufferPool();
+template <typename F> bool BTreeFile::insertRecursive(IndexPage &node, int key, F &&insert) {
+  // children[i] holds the keys in [keys[i - 1], keys[i])
+  size_t child_index = std::upper_bound(node.keys, node.keys + node.header->size, key) - node.keys;
+  WritePageGuard child_guard = fetchWrite(node.children[child_index]);
 
   if (node.header->index_children) {
-    // if the next page is an indexpage
-    size_t child_index = 0;
-
-    while (child_index < node.header->size && t.get_field(key_index).index() >= node.keys[child_index]) {
-      child_index++;
-    }
-
-    PageId newPid{name, node.children[child_index]};
-    Page &newPage = buffer_pool.getPage(newPid);
-    IndexPage newIndexPage(newPage);
-
-    // recursively call function
-    if (insertTupleRecursive(newIndexPage, t)) {
-      // If the insertion into the child node resulted in a split
-      if (node.insert(node.keys[child_index], newPid.page)) {
-        // index page is full, need to split it
-        buffer_pool.markDirty(newPid);
-        return true;
-      }
-      // index page is not full
+    IndexPage child(*child_guard);
+    if (!insertRecursive(child, key, insert)) {
       return false;
     }
-  } else {
-    // child is a leaf node
-    size_t child_index = 0;
-
-    while (child_index < node.header->size && t.get_field(key_index).index() >= node.keys[child_index]) {
-      child_index++;
-    }
-
-    PageId pid{name, node.children[child_index]};
-    Page &page = buffer_pool.getPage(pid);
-    LeafPage leaf(page, td, key_index);
+    // The child is full, split it and insert the middle key in this node
+    WritePageGuard new_guard = fetchWrite(numPages++);
+    IndexPage new_child(*new_guard);
+    int split_key = child.split(new_child);
+    return node.insert(split_key, new_guard.getPageId().page);
+  }
 
-    if (leaf.insertTuple(t)) {
-      // if leaf is full we need to split it
-      PageId newLeafPid{name, numPages++};
-      Page &newPage = buffer_pool.getPage(newLeafPid);
-      LeafPage newLeafPage(newPage, td, key_index);
+  LeafPage leaf(*child_guard, td, key_index);
+  if (!insert(leaf)) {
+    return false;
+  }
+  // The leaf is full, split it and link the new leaf after it
+  WritePageGuard new_guard = fetchWrite(numPages++);
+  LeafPage new_leaf(*new_guard, td, key_index);
+  int split_key = leaf.split(new_leaf);
+  leaf.header->next_leaf = new_guard.getPageId().page;
+  return node.insert(split_key, new_guard.getPageId().page);
+}
 
-      int splitKey = leaf.split(newLeafPage);
-      node.insert(splitKey, newLeafPid.page);
+void BTreeFile::insertTuple(const Tuple &t) {
+  if (!td.compatible(t)) {
+    throw std::invalid_argument("Tuple is not compatible with Tuple Desc");
+  }
+  insert(std::get<int>(t.get_field(key_index)), [&](LeafPage &leaf) { return leaf.insertTuple(t); });
+}
 
-      buffer_pool.markDirty(newLeafPid);
-      buffer_pool.markDirty(*reinterpret_cast<PageId *>(&node));
-      return true;
-    }
-    //leafpage is not full
-    return false;
+void BTreeFile::insertSerialized(std::span<const uint8_t> row) {
+  if (row.size() != td.length()) {
+    throw std::invalid_argument("Serialized tuple is not compatible with Tuple Desc");
   }
+  int key;
+  std::memcpy(&key, row.data() + td.offset_of(key_index), sizeof(int));
+  insert(key, [&](LeafPage &leaf) { return leaf.insertSerialized(row); });
 }
 
+bool BTreeFile::insertTupleRecursive(IndexPage &node, const Tuple &t) {
+  return insertRecursive(node, std::get<int>(t.get_field(key_index)),
+                         [&](LeafPage &leaf) { return leaf.insertTuple(t); });
+}
 
 void BTreeFile::deleteTuple(const Iterator &it) {
   // Do not implement
 }
 
 Tuple BTreeFile::getTuple(const Iterator &it) const {
-  // TODO pa2: implement
-
-  BufferPool &buffer_pool = getDatabase().getBufferPool();
-  PageId pid{name, it.page};
-
-  Page &page = buffer_pool.getPage(pid);
-
-  LeafPage leafPage(page, td, key_index);
+  ReadPageGuard guard = fetchRead(it.page);
+  const LeafPage leaf(*guard, td, key_index);
+  return leaf.getTuple(it.slot);
+}
 
-  return leafPage.getTuple(it.slot);
+TupleView BTreeFile::getTupleView(const Iterator &it, ReadPageGuard &guard) const {
+  fetchRead(it.page, guard);
+  const LeafPage leaf(*guard, td, key_index);
+  return leaf.getTupleView(it.slot);
 }
 
 void BTreeFile::next(Iterator &it) const {
-  // TODO pa2: implement
-
-  BufferPool &buffer_pool = getDatabase().getBufferPool();
-
-  PageId pid{name, it.page};
-  Page &page = buffer_pool.getPage(pid);
-
-  LeafPage leafPage(page, td, key_index);
-
-  size_t next_slot = it.slot+1;
+  ReadPageGuard guard;
+  next(it, guard);
+}
 
-  if(next_slot >= leafPage.header->size) {
-    //leaf is full, go to next leaf
+void BTreeFile::next(Iterator &it, ReadPageGuard &guard) const {
+  fetchRead(it.page, guard);
+  const LeafPage leaf(*guard, td, key_index);
 
-    it.page = leafPage.header->next_leaf;
-    it.slot = 0;
+  if (++it.slot < leaf.header->size) {
+    return;
   }
-  else {
 
-    it.slot = next_slot;
+  // Move to the next leaf, the last leaf links to the root
+  it.page = leaf.header->next_leaf;
+  it.slot = 0;
+  while (it.page != root_id) {
+    guard = fetchRead(it.page);
+    const LeafPage next_leaf(*guard, td, key_index);
+    if (next_leaf.header->size > 0) {
+      return;
+    }
+    it.page = next_leaf.header->next_leaf;
   }
-
-
+  guard.release();
 }
 
-Iterator BTreeFile::begin() const {
-  // TODO pa2: implement
-
-  BufferPool &buffer_pool = getDatabase().getBufferPool();
-  PageId pid{name, root_id};
-  Page &rootPage = buffer_pool.getPage(pid);
-
-  //iterate from root to leftmost child
-  IndexPage root(rootPage);
-
-  size_t page = root_id;
-
-  while(root.header->index_children) {
-    //traverse left most child till you encounter leaf
-
-    auto leftchild = root.children[0];
-
-    PageId leftChildPid{name, leftchild};
-
-    Page &leftChildPage = buffer_pool.getPage(leftChildPid);
-
-    //update root
-    root = IndexPage(leftChildPage);
-    page = leftChildPid.page;
+size_t BTreeFile::scan(Iterator &it, DataChunk &chunk) const {
+  chunk.clear();
+  std::array<const uint8_t *, 256> rows;
+  ReadPageGuard guard;
+  while (it.page != root_id) {
+    fetchRead(it.page, guard);
+    const LeafPage leaf(*guard, td, key_index);
+    if (it.slot >= leaf.header->size) {
+      it.page = leaf.header->next_leaf;
+      it.slot = 0;
+      continue;
+    }
+    if (chunk.full()) {
+      break;
+    }
+    // The tuples of a leaf are contiguous
+    size_t n = std::min<size_t>({leaf.header->size - it.slot, chunk.getCapacity() - chunk.size(), rows.size()});
+    for (size_t i = 0; i < n; i++) {
+      rows[i] = leaf.data + (it.slot + i) * td.length();
+    }
+    chunk.append({rows.data(), n});
+    it.slot += n;
   }
-
-  //return the iterator to the first tuple of the leftmost leaf (head).
-  return Iterator(*this, page, 0);
-
+  return chunk.size();
 }
 
-Iterator BTreeFile::end() const {
-  // TODO pa2: implement
-
-  BufferPool &buffer_pool = getDatabase().getBufferPool();
-  PageId pid{name, root_id};
-  Page &rootPage = buffer_pool.getPage(pid);
-
-  //iterate to rightmost child
-  IndexPage root(rootPage);
-  size_t page = root_id;
-
-  while(root.header->index_children) {
-
-    //travesre rightmost child till you reach leaf
-
-    auto rightchild = root.children[root.header->size];
-    PageId rightChildPid{name, rightchild};
-    Page &rightChildPage = buffer_pool.getPage(rightChildPid);
-
-    //update root to rightmost child
-    root = IndexPage(rightChildPage);
-    page = rightChildPid.page;
+Iterator BTreeFile::begin() const {
+  ReadPageGuard guard = fetchRead(root_id);
+  IndexPage node(*guard);
 
+  // An empty tree has no leaves
+  if (node.header->size == 0 && node.children[0] == root_id) {
+    return end();
   }
 
-  auto rightchild = root.children[root.header->size];
-  PageId rightChildPid{name, rightchild};
-  Page &rightChildPage = buffer_pool.getPage(rightChildPid);
-
-  LeafPage leaf(rightChildPage, td, key_index);
-
-  return Iterator(*this, page, leaf.header->size);
+  // Follow the leftmost children down to the head leaf
+  while (node.header->index_children) {
+    guard = fetchRead(node.children[0]);
+    node = IndexPage(*guard);
+  }
+  size_t page = node.children[0];
 
+  guard = fetchRead(page);
+  const LeafPage leaf(*guard, td, key_index);
+  Iterator it(*this, page, 0);
+  if (leaf.header->size == 0) {
+    next(it);
+  }
+  return it;
+}
 
-}
\ No newline at end of file
+Iterator BTreeFile::end() const { return {*this, root_id, 0}; }
@@ -1,93 +1,628 @@
 #include <db/BufferPool.hpp>
+#include <algorithm>
 #include <db/Database.hpp>
 #include <numeric>
+#include <stdexcept>
 
 using namespace db;
 
-BufferPool::BufferPool() : available(DEFAULT_NUM_PAGES) { std::iota(available.rbegin(), available.rend(), 0); }
+namespace {
+BufferPoolOptions clampReadAhead(BufferPoolOptions options) {
+  if (options.num_shards != 0) {
+    options.read_ahead_window = std::min(options.read_ahead_window, options.num_pages / options.num_shards / 4);
+  }
+  return options;
+}
+} // namespace
+
+BufferPool::BufferPool(const BufferPoolOptions &options)
+    : options(clampReadAhead(options)), pages(options.num_pages, options.huge_pages),
+      io(makeIoBackend(options.io_backend, options.io_queue_depth)), pos_to_pid(options.num_pages),
+      dirty(std::make_unique<std::atomic<bool>[]>(options.num_pages)), pins(options.num_pages),
+      latches(std::make_unique<std::shared_mutex[]>(options.num_pages)),
+      high_watermark(options.flush_high_watermark * options.num_pages),
+      low_watermark(options.flush_low_watermark * options.num_pages) {
+  if (options.num_shards == 0 || options.num_shards > options.num_pages) {
+    throw std::invalid_argument("Every shard needs at least one page");
+  }
+  if (!(0 <= options.flush_low_watermark && options.flush_low_watermark <= options.flush_high_watermark &&
+        options.flush_high_watermark <= 1)) {
+    throw std::invalid_argument("Flush watermarks must satisfy 0 <= low <= high <= 1");
+  }
+  shards = std::make_unique<Shard[]>(options.num_shards);
+  for (size_t i = 0; i < options.num_shards; i++) {
+    Shard &shard = shards[i];
+    shard.begin = options.num_pages * i / options.num_shards;
+    shard.end = options.num_pages * (i + 1) / options.num_shards;
+    shard.available.resize(shard.end - shard.begin);
+    std::iota(shard.available.rbegin(), shard.available.rend(), shard.begin);
+    shard.pid_to_pos = PageTable(shard.end - shard.begin);
+    shard.policy = makeReplacementPolicy(options.policy, shard.end - shard.begin);
+  }
+  io->registerBuffers(pages.data(), pages.capacity());
+  if (options.background_flush) {
+    flusher = std::thread(&BufferPool::flushLoop, this);
+  }
+  if (options.read_ahead == read_ahead_t::PREADV) {
+    read_ahead_thread = std::thread(&BufferPool::readAheadLoop, this);
+  }
+}
 
 BufferPool::~BufferPool() {
-  for (const size_t &pos : dirty) {
-    const Page &page = pages[pos];
-    const PageId &pid = pos_to_pid[pos];
-    getDatabase().get(pid.file).writePage(page, pid.page);
+  if (read_ahead_thread.joinable()) {
+    {
+      std::lock_guard lock(read_ahead_mutex);
+      stop_read_ahead = true;
+    }
+    read_ahead_cv.notify_one();
+    read_ahead_thread.join();
+  }
+  if (flusher.joinable()) {
+    {
+      std::lock_guard lock(flusher_mutex);
+      stop_flusher = true;
+    }
+    flusher_cv.notify_one();
+    flusher.join();
+  }
+  std::vector<file_id_t> files;
+  for (size_t pos = 0; pos < pages.size(); pos++) {
+    if (dirty[pos]) {
+      files.push_back(pos_to_pid[pos].file);
+    }
+  }
+  std::sort(files.begin(), files.end());
+  files.erase(std::unique(files.begin(), files.end()), files.end());
+  for (file_id_t file : files) {
+    try {
+      flushFile(file);
+    } catch (const std::exception &) {
+      // A destructor cannot report the error: the pages of the file are lost
+    }
   }
 }
 
+BufferPool::Shard &BufferPool::shardOf(const PageId &pid) const {
+  return shards[std::hash<const PageId>()(pid) % options.num_shards];
+}
+
+BufferPool::Shard &BufferPool::shardOfFrame(size_t pos) const {
+  auto it = std::upper_bound(shards.get(), shards.get() + options.num_shards, pos,
+                             [](size_t pos, const Shard &shard) { return pos < shard.end; });
+  return *it;
+}
+
+void BufferPool::setDirty(size_t pos) {
+  if (dirty[pos].exchange(true)) {
+    return;
+  }
+  // Wake the flusher when the pool crosses the high watermark
+  if (++num_dirty == high_watermark + 1 && flusher.joinable()) {
+    { std::lock_guard lock(flusher_mutex); }
+    flusher_cv.notify_one();
+  }
+}
+
+bool BufferPool::clearDirty(size_t pos) {
+  if (!dirty[pos].exchange(false)) {
+    return false;
+  }
+  num_dirty--;
+  return true;
+}
+
 Page &BufferPool::getPage(const PageId &pid) {
-  // If already in buffer pool, make it the most recent page and return it
-  if (contains(pid)) {
-    size_t pos = pid_to_pos.at(pid);
-    lru_list.splice(lru_list.begin(), lru_list, pos_to_lru[pos]);
-    pos_to_lru[pos] = lru_list.begin();
-    return pages[pos];
+  Shard &shard = shardOf(pid);
+  size_t pos;
+  {
+    std::lock_guard lock(shard.mutex);
+    pos = fetch(shard, pid);
+  }
+  if (options.read_ahead != read_ahead_t::NONE) {
+    readAhead(pid);
+  }
+  return pages[pos];
+}
+
+ReadPageGuard BufferPool::fetchRead(const PageId &pid) {
+  Shard &shard = shardOf(pid);
+  size_t pos;
+  {
+    std::lock_guard lock(shard.mutex);
+    pos = fetch(shard, pid);
+    if (pins[pos]++ == 0) {
+      shard.policy->setEvictable(pos - shard.begin, false);
+    }
+  }
+  if (options.read_ahead != read_ahead_t::NONE) {
+    readAhead(pid);
+  }
+  // The pin keeps the frame in place while waiting for the latch
+  latches[pos].lock_shared();
+  return {this, pos, pid, &pages[pos]};
+}
+
+WritePageGuard BufferPool::fetchWrite(const PageId &pid) {
+  Shard &shard = shardOf(pid);
+  size_t pos;
+  {
+    std::lock_guard lock(shard.mutex);
+    pos = fetch(shard, pid);
+    if (pins[pos]++ == 0) {
+      shard.policy->setEvictable(pos - shard.begin, false);
+    }
+  }
+  latches[pos].lock();
+  return {this, pos, pid, &pages[pos]};
+}
+
+void BufferPool::release(size_t pos, bool exclusive) {
+  // Unlatch before taking the shard lock: a thread holding the shard lock never waits for a latch
+  if (exclusive) {
+    setDirty(pos);
+    latches[pos].unlock();
+  } else {
+    latches[pos].unlock_shared();
+  }
+  unpin(pos);
+}
+
+void BufferPool::unpin(size_t pos) {
+  Shard &shard = shardOfFrame(pos);
+  std::lock_guard lock(shard.mutex);
+  if (--pins[pos] == 0) {
+    shard.policy->setEvictable(pos - shard.begin, true);
+  }
+}
+
+bool BufferPool::isPinned(const PageId &pid) const {
+  Shard &shard = shardOf(pid);
+  std::lock_guard lock(shard.mutex);
+  return pins[frameOf(shard, pid)] > 0;
+}
+
+size_t BufferPool::fetch(Shard &shard, const PageId &pid) {
+  // If already in buffer pool, record the access and return it
+  if (size_t pos = shard.pid_to_pos.find(pid); pos != PageTable::npos) {
+    shard.policy->access(pos - shard.begin);
+    shard.stats.hits++;
+    return pos;
+  }
+  shard.stats.misses++;
+  size_t pos = allocate(shard, pid);
+  try {
+    IoRequest read = request(pos, false);
+    io->submit({&read, 1});
+  } catch (...) {
+    // Do not leave a frame that claims to hold the page
+    shard.pid_to_pos.erase(pid);
+    pos_to_pid[pos] = {};
+    shard.policy->erase(pos - shard.begin);
+    shard.available.push_back(pos);
+    throw;
   }
+  return pos;
+}
+
+size_t BufferPool::allocate(Shard &shard, const PageId &pid) {
+  size_t pos = claim(shard);
+  track(shard, pid, pos);
+  return pos;
+}
 
-  // If there are no available pages, evict the least recently used page. If the page is dirty, flush it to disk
-  if (available.empty()) {
-    size_t pos = lru_list.back();
-    const PageId &old_pid = pos_to_pid.at(pos);
-    if (isDirty(old_pid)) {
-      flushPage(old_pid);
+size_t BufferPool::claim(Shard &shard) {
+  // If there are no available pages, evict the unpinned page chosen by the policy. Flush it to disk if it is dirty
+  if (shard.available.empty()) {
+    size_t pos = shard.begin + shard.policy->victim();
+    // An unpinned page is not latched by anyone
+    if (clearDirty(pos)) {
+      try {
+        writeBack(pos);
+      } catch (...) {
+        // The page stays in its frame, still dirty
+        setDirty(pos);
+        throw;
+      }
+      shard.stats.sync_writes++;
     }
-    discardPage(old_pid);
+    shard.pid_to_pos.erase(pos_to_pid[pos]);
+    pos_to_pid[pos] = {};
+    shard.policy->erase(pos - shard.begin);
+    shard.available.push_back(pos);
+    shard.stats.evictions++;
   }
 
-  // Read the page from disk to one of the available slots, make it the most recent page
-  size_t pos = available.back();
-  available.pop_back();
+  size_t pos = shard.available.back();
+  shard.available.pop_back();
+  return pos;
+}
 
-  Page &page = pages[pos];
-  getDatabase().get(pid.file).readPage(page, pid.page);
-  pid_to_pos[pid] = pos;
+void BufferPool::track(Shard &shard, const PageId &pid, size_t pos) {
+  shard.pid_to_pos.insert(pid, pos);
   pos_to_pid[pos] = pid;
+  shard.policy->insert(pos - shard.begin, pid);
+}
+
+size_t BufferPool::frameOf(const Shard &shard, const PageId &pid) const {
+  size_t pos = shard.pid_to_pos.find(pid);
+  if (pos == PageTable::npos) {
+    throw std::out_of_range("Page is not in the buffer pool");
+  }
+  return pos;
+}
+
+IoRequest BufferPool::request(size_t pos, bool write) const {
+  const PageId &pid = pos_to_pid[pos];
+  const DbFile &file = getDatabase().get(pid.file);
+  return write ? file.writeRequest(pages[pos], pid.page) : file.readRequest(const_cast<Page &>(pages[pos]), pid.page);
+}
 
-  lru_list.push_front(pos);
-  pos_to_lru[pos] = lru_list.begin();
+void BufferPool::writeBack(size_t pos) {
+  IoRequest write = request(pos, true);
+  io->submit({&write, 1});
+}
+
+size_t BufferPool::writeBatch(std::span<const size_t> candidates) {
+  // Pin and latch the dirty pages that no writer holds
+  std::vector<size_t> latched;
+  for (size_t pos : candidates) {
+    Shard &shard = shardOfFrame(pos);
+    std::lock_guard lock(shard.mutex);
+    if (!dirty[pos] || pos_to_pid[pos].file == 0 || !latches[pos].try_lock_shared()) {
+      continue;
+    }
+    if (pins[pos]++ == 0) {
+      shard.policy->setEvictable(pos - shard.begin, false);
+    }
+    latched.push_back(pos);
+  }
 
-  return page;
+  std::vector<size_t> written;
+  for (size_t pos : latched) {
+    if (clearDirty(pos)) {
+      written.push_back(pos);
+    }
+  }
+  // Write in disk order so that contiguous dirty pages become sequential, mergeable writes
+  std::sort(written.begin(), written.end(),
+            [this](size_t a, size_t b) { return pos_to_pid[a].key() < pos_to_pid[b].key(); });
+  std::vector<IoRequest> requests;
+  requests.reserve(written.size());
+  for (size_t pos : written) {
+    requests.push_back(request(pos, true));
+  }
+  try {
+    io->submit(requests);
+  } catch (...) {
+    for (size_t pos : written) {
+      setDirty(pos);
+    }
+    for (size_t pos : latched) {
+      release(pos, false);
+    }
+    throw;
+  }
+  for (size_t pos : latched) {
+    release(pos, false);
+  }
+  return written.size();
 }
 
 void BufferPool::markDirty(const PageId &pid) {
-  size_t pos = pid_to_pos.at(pid);
-  dirty.insert(pos);
+  Shard &shard = shardOf(pid);
+  std::lock_guard lock(shard.mutex);
+  setDirty(frameOf(shard, pid));
 }
 
 bool BufferPool::isDirty(const PageId &pid) const {
-  size_t pos = pid_to_pos.at(pid);
-  return dirty.contains(pos);
+  Shard &shard = shardOf(pid);
+  std::lock_guard lock(shard.mutex);
+  return dirty[frameOf(shard, pid)];
 }
 
-bool BufferPool::contains(const PageId &pid) const { return pid_to_pos.contains(pid); }
+bool BufferPool::contains(const PageId &pid) const {
+  Shard &shard = shardOf(pid);
+  std::lock_guard lock(shard.mutex);
+  return shard.pid_to_pos.contains(pid);
+}
 
 void BufferPool::discardPage(const PageId &pid) {
-  size_t pos = pid_to_pos.at(pid);
-  pid_to_pos.erase(pid);
+  Shard &shard = shardOf(pid);
+  std::lock_guard lock(shard.mutex);
+  size_t pos = frameOf(shard, pid);
+  if (pins[pos] > 0) {
+    throw std::logic_error("Page is pinned");
+  }
+  shard.pid_to_pos.erase(pid);
   pos_to_pid[pos] = {};
+  shard.policy->erase(pos - shard.begin);
+  clearDirty(pos);
+  shard.available.push_back(pos);
+}
 
-  lru_list.erase(pos_to_lru[pos]);
-  pos_to_lru.erase(pos);
-  dirty.erase(pos);
-  available.push_back(pos);
+void BufferPool::discardPages(file_id_t file, size_t first) {
+  if (read_ahead_thread.joinable()) {
+    std::unique_lock lock(read_ahead_mutex);
+    std::erase_if(read_ahead_queue, [file](const auto &request) { return request.first.file == file; });
+    read_ahead_done.wait(lock, [this, file] { return loading != file; });
+    if (file < streams.size()) {
+      streams[file] = {};
+    }
+  }
+  for (size_t i = 0; i < options.num_shards; i++) {
+    Shard &shard = shards[i];
+    while (true) {
+      size_t busy = PageTable::npos;
+      {
+        std::lock_guard lock(shard.mutex);
+        for (size_t pos = shard.begin; pos < shard.end; pos++) {
+          const PageId &pid = pos_to_pid[pos];
+          if (pid.file != file || pid.page < first) {
+            continue;
+          }
+          if (pins[pos] > 0) {
+            busy = pos;
+            continue;
+          }
+          shard.pid_to_pos.erase(pid);
+          pos_to_pid[pos] = {};
+          shard.policy->erase(pos - shard.begin);
+          clearDirty(pos);
+          shard.available.push_back(pos);
+        }
+      }
+      if (busy == PageTable::npos) {
+        break;
+      }
+      // A pin comes with a latch: wait for its holder to be done with the page, then sweep the shard again
+      latches[busy].lock();
+      latches[busy].unlock();
+      std::this_thread::yield();
+    }
+  }
 }
 
 void BufferPool::flushPage(const PageId &pid) {
-  size_t pos = pid_to_pos.at(pid);
-  if (dirty.erase(pos) == 0)
-    return;
-  const Page &page = pages[pos];
-  getDatabase().get(pid.file).writePage(page, pid.page);
+  Shard &shard = shardOf(pid);
+  size_t pos;
+  {
+    std::lock_guard lock(shard.mutex);
+    pos = frameOf(shard, pid);
+    if (!dirty[pos]) {
+      return;
+    }
+    if (pins[pos]++ == 0) {
+      shard.policy->setEvictable(pos - shard.begin, false);
+    }
+  }
+  // Writers hold the latch exclusively, so the page is not modified while it is written
+  latches[pos].lock_shared();
+  if (clearDirty(pos)) {
+    try {
+      writeBack(pos);
+    } catch (...) {
+      setDirty(pos);
+      release(pos, false);
+      throw;
+    }
+  }
+  release(pos, false);
+}
+
+void BufferPool::flushLoop() {
+  size_t cursor = 0;
+  // Whether the pool crossed the high watermark and has not been brought down to the low watermark yet
+  bool sweeping = false;
+  std::unique_lock lock(flusher_mutex);
+  while (true) {
+    flusher_cv.wait(lock, [&] { return stop_flusher || num_dirty > (sweeping ? low_watermark : high_watermark); });
+    if (stop_flusher) {
+      return;
+    }
+    lock.unlock();
+    // Sweep the frames from where the previous pass stopped, at most once around the pool, and write the dirty pages
+    // in batches. Pages held by a writer are skipped: they would be dirty again when the writer is done.
+    bool progress = false;
+    std::vector<size_t> batch;
+    for (size_t n = 0; n < pages.size() && num_dirty > low_watermark; n++) {
+      if (dirty[cursor]) {
+        batch.push_back(cursor);
+      }
+      cursor = (cursor + 1) % pages.size();
+      if (batch.size() == options.io_queue_depth || n + 1 == pages.size()) {
+        try {
+          size_t written = writeBatch(batch);
+          background_writes += written;
+          progress |= written > 0;
+        } catch (const std::runtime_error &) {
+          // The pages stay dirty: a foreground eviction or flush reports the error
+        }
+        batch.clear();
+      }
+    }
+    if (!batch.empty()) {
+      try {
+        size_t written = writeBatch(batch);
+        background_writes += written;
+        progress |= written > 0;
+      } catch (const std::runtime_error &) {
+      }
+    }
+    lock.lock();
+    // A pass that skipped pages being written keeps sweeping until the low watermark is reached
+    sweeping = num_dirty > low_watermark;
+    if (!progress) {
+      // Every dirty page is being written: back off instead of spinning
+      flusher_cv.wait_for(lock, std::chrono::milliseconds(1), [this] { return stop_flusher; });
+    }
+  }
+}
+
+void BufferPool::readAhead(const PageId &pid) {
+  size_t first;
+  size_t count;
+  {
+    std::lock_guard lock(read_ahead_mutex);
+    if (pid.file >= streams.size()) {
+      streams.resize(pid.file + 1);
+    }
+    Stream &stream = streams[pid.file];
+    if (pid.page == stream.last) {
+      return;
+    }
+    if (pid.page == stream.last + 1) {
+      stream.run++;
+    } else {
+      stream.run = 0;
+      stream.until = 0;
+    }
+    stream.last = pid.page;
+    // Wait for a few sequential pages, then request the next window when the scan is half way through the current one
+    if (stream.run < 2 || stream.until > pid.page + options.read_ahead_window / 2) {
+      return;
+    }
+    first = std::max<size_t>(stream.until, pid.page + 1);
+    size_t until = std::min(pid.page + 1 + options.read_ahead_window, getDatabase().get(pid.file).getNumPages());
+    if (until <= first) {
+      return;
+    }
+    count = until - first;
+    stream.until = until;
+    if (options.read_ahead == read_ahead_t::PREADV) {
+      read_ahead_queue.emplace_back(PageId{pid.file, first}, count);
+    }
+  }
+  if (options.read_ahead == read_ahead_t::PREADV) {
+    read_ahead_cv.notify_one();
+  } else {
+    getDatabase().get(pid.file).prefetch(first, count);
+  }
+}
+
+void BufferPool::readAheadLoop() {
+  std::unique_lock lock(read_ahead_mutex);
+  while (true) {
+    read_ahead_cv.wait(lock, [this] { return stop_read_ahead || !read_ahead_queue.empty(); });
+    if (stop_read_ahead) {
+      return;
+    }
+    auto [first, count] = read_ahead_queue.front();
+    read_ahead_queue.pop_front();
+    loading = first.file;
+    lock.unlock();
+    load(first, count);
+    lock.lock();
+    loading = 0;
+    read_ahead_done.notify_all();
+  }
+}
+
+void BufferPool::load(const PageId &first, size_t count) {
+  // Take frames for the pages that are not in the pool, without making them visible yet
+  std::vector<std::pair<PageId, size_t>> claimed;
+  for (size_t i = 0; i < count; i++) {
+    PageId pid{first.file, first.page + i};
+    Shard &shard = shardOf(pid);
+    std::lock_guard lock(shard.mutex);
+    if (shard.pid_to_pos.contains(pid)) {
+      continue;
+    }
+    try {
+      claimed.emplace_back(pid, claim(shard));
+    } catch (const std::runtime_error &) {
+      // Every frame is pinned: reading ahead is only a hint
+      break;
+    }
+  }
+
+  // Read the whole window with one batch
+  std::vector<IoRequest> requests;
+  const DbFile &file = getDatabase().get(first.file);
+  for (auto [pid, pos] : claimed) {
+    requests.push_back(file.readRequest(pages[pos], pid.page));
+  }
+  bool read = true;
+  try {
+    io->submit(requests);
+  } catch (const std::runtime_error &) {
+    // The next request of these pages reads them again and reports the error
+    read = false;
+  }
+
+  // Publish the pages, unless a foreground miss loaded them in the meantime
+  for (auto [pid, pos] : claimed) {
+    Shard &shard = shardOf(pid);
+    std::lock_guard lock(shard.mutex);
+    if (!read || shard.pid_to_pos.contains(pid)) {
+      shard.available.push_back(pos);
+      continue;
+    }
+    track(shard, pid, pos);
+    read_ahead_pages++;
+  }
 }
 
-void BufferPool::flushFile(const std::string &file) {
+void BufferPool::flushFile(file_id_t file) {
+  if (read_ahead_thread.joinable()) {
+    std::unique_lock lock(read_ahead_mutex);
+    std::erase_if(read_ahead_queue, [file](const auto &request) { return request.first.file == file; });
+    read_ahead_done.wait(lock, [this, file] { return loading != file; });
+  }
   std::vector<size_t> to_flush;
-  for (const size_t &pos : dirty) {
-    const PageId &pid = pos_to_pid[pos];
-    if (pid.file == file) {
-      to_flush.emplace_back(pid.page);
+  for (size_t i = 0; i < options.num_shards; i++) {
+    std::lock_guard lock(shards[i].mutex);
+    for (size_t pos = shards[i].begin; pos < shards[i].end; pos++) {
+      if (pos_to_pid[pos].file == file && dirty[pos]) {
+        to_flush.push_back(pos);
+      }
+    }
+  }
+  size_t written = writeBatch(to_flush);
+
+  // Wait for the writers that held some of the pages
+  for (size_t i = 0; i < options.num_shards; i++) {
+    std::vector<PageId> busy;
+    {
+      std::lock_guard lock(shards[i].mutex);
+      for (size_t pos = shards[i].begin; pos < shards[i].end; pos++) {
+        if (pos_to_pid[pos].file == file && dirty[pos]) {
+          busy.push_back(pos_to_pid[pos]);
+        }
+      }
+    }
+    for (const PageId &pid : busy) {
+      flushPage(pid);
     }
+    written += busy.size();
   }
-  for (const auto &page : to_flush) {
-    flushPage({file, page});
+  if (options.sync_on_flush && written > 0) {
+    getDatabase().get(file).sync();
+  }
+}
+
+void BufferPool::flushFile(const std::string &file) { flushFile(getDatabase().get(file).getId()); }
+
+size_t BufferPool::size() const { return pages.size(); }
+
+const BufferPoolOptions &BufferPool::getOptions() const { return options; }
+
+BufferPoolStats BufferPool::getStats() const {
+  BufferPoolStats stats;
+  for (size_t i = 0; i < options.num_shards; i++) {
+    std::lock_guard lock(shards[i].mutex);
+    stats.hits += shards[i].stats.hits;
+    stats.misses += shards[i].stats.misses;
+    stats.evictions += shards[i].stats.evictions;
+    stats.sync_writes += shards[i].stats.sync_writes;
   }
+  stats.background_writes = background_writes;
+  stats.dirty_pages = num_dirty;
+  stats.read_ahead_pages = read_ahead_pages;
+  IoStats io_stats = io->getStats();
+  stats.read_calls = io_stats.read_calls;
+  stats.bytes_read = io_stats.bytes_read;
+  stats.write_calls = io_stats.write_calls;
+  stats.bytes_written = io_stats.bytes_written;
+  stats.io_latency = io_stats.latency;
+  return stats;
 }
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <cstring>
+#include <db/DataChunk.hpp>
+#include <ranges>
+#include <stdexcept>
+
+using namespace db;
+
+DataChunk::DataChunk(const Projection &projection, size_t capacity) : DataChunk(projection.getTupleDesc(), capacity) {
+  offsets = projection.getOffsets();
+}
+
+DataChunk::DataChunk(const TupleDesc &td, size_t capacity) : td(td), capacity(capacity) {
+  if (capacity == 0) {
+    throw std::invalid_argument("DataChunk capacity must be positive");
+  }
+  size_t char_columns = 0;
+  for (size_t i = 0; i < td.size(); i++) {
+    offsets.push_back(td.offset_of(i));
+    switch (td.type_of(i)) {
+    case type_t::INT:
+      columns.emplace_back(std::vector<int>(capacity));
+      break;
+    case type_t::DOUBLE:
+      columns.emplace_back(std::vector<double>(capacity));
+      break;
+    case type_t::CHAR:
+      columns.emplace_back(std::vector<std::string_view>(capacity));
+      char_columns++;
+      break;
+    case type_t::VARCHAR:
+      columns.emplace_back(std::vector<std::string_view>(capacity));
+      break;
+    }
+  }
+  chars.resize(char_columns * capacity * CHAR_SIZE);
+}
+
+void DataChunk::append(std::span<const uint8_t *const> rows) {
+  if (rows.size() > capacity - count) {
+    throw std::length_error("Rows do not fit in the DataChunk");
+  }
+  if (td.variable_length()) {
+    reserveVarchars(rows);
+  }
+  char *buffer = chars.data();
+  for (size_t i = 0; i < columns.size(); i++) {
+    size_t offset = offsets[i];
+    if (auto *values = std::get_if<std::vector<int>>(&columns[i])) {
+      int *out = values->data() + count;
+      for (size_t r = 0; r < rows.size(); r++) {
+        std::memcpy(&out[r], rows[r] + offset, INT_SIZE);
+      }
+    } else if (auto *values = std::get_if<std::vector<double>>(&columns[i])) {
+      double *out = values->data() + count;
+      for (size_t r = 0; r < rows.size(); r++) {
+        std::memcpy(&out[r], rows[r] + offset, DOUBLE_SIZE);
+      }
+    } else if (td.type_of(i) == type_t::VARCHAR) {
+      std::string_view *out = std::get<std::vector<std::string_view>>(columns[i]).data() + count;
+      for (size_t r = 0; r < rows.size(); r++) {
+        uint16_t at, size;
+        std::memcpy(&at, rows[r] + offset, sizeof(uint16_t));
+        std::memcpy(&size, rows[r] + offset + sizeof(uint16_t), sizeof(uint16_t));
+        char *dst = varchars.data() + used;
+        std::memcpy(dst, rows[r] + at, size);
+        out[r] = {dst, size};
+        used += size;
+      }
+    } else {
+      std::string_view *out = std::get<std::vector<std::string_view>>(columns[i]).data() + count;
+      char *dst = buffer + count * CHAR_SIZE;
+      for (size_t r = 0; r < rows.size(); r++, dst += CHAR_SIZE) {
+        std::memcpy(dst, rows[r] + offset, CHAR_SIZE);
+        out[r] = {dst, strnlen(dst, CHAR_SIZE)};
+      }
+      buffer += capacity * CHAR_SIZE;
+    }
+  }
+  count += rows.size();
+}
+
+void DataChunk::append(const uint8_t *minipages, size_t page_slots, std::span<const size_t> slots) {
+  if (slots.size() > capacity - count) {
+    throw std::length_error("Rows do not fit in the DataChunk");
+  }
+  if (slots.empty()) {
+    return;
+  }
+  bool consecutive = slots.back() - slots.front() + 1 == slots.size();
+  char *buffer = chars.data();
+  for (size_t i = 0; i < columns.size(); i++) {
+    size_t size = size_of(td.type_of(i));
+    const uint8_t *column = minipages + offsets[i] * page_slots;
+    uint8_t *out;
+    if (auto *values = std::get_if<std::vector<int>>(&columns[i])) {
+      out = reinterpret_cast<uint8_t *>(values->data() + count);
+    } else if (auto *values = std::get_if<std::vector<double>>(&columns[i])) {
+      out = reinterpret_cast<uint8_t *>(values->data() + count);
+    } else if (td.type_of(i) == type_t::CHAR) {
+      out = reinterpret_cast<uint8_t *>(buffer + count * CHAR_SIZE);
+      buffer += capacity * CHAR_SIZE;
+    } else {
+      throw std::logic_error("VARCHAR columns are not stored in PAX pages");
+    }
+    if (consecutive) {
+      std::memcpy(out, column + slots.front() * size, slots.size() * size);
+    } else {
+      for (size_t r = 0; r < slots.size(); r++) {
+        std::memcpy(out + r * size, column + slots[r] * size, size);
+      }
+    }
+    if (td.type_of(i) == type_t::CHAR) {
+      std::string_view *views = std::get<std::vector<std::string_view>>(columns[i]).data() + count;
+      const char *value = reinterpret_cast<const char *>(out);
+      for (size_t r = 0; r < slots.size(); r++, value += CHAR_SIZE) {
+        views[r] = {value, strnlen(value, CHAR_SIZE)};
+      }
+    }
+  }
+  count += slots.size();
+}
+
+void DataChunk::reserveVarchars(std::span<const uint8_t *const> rows) {
+  size_t needed = used;
+  for (size_t i = 0; i < columns.size(); i++) {
+    if (td.type_of(i) == type_t::VARCHAR) {
+      for (const uint8_t *row : rows) {
+        uint16_t size;
+        std::memcpy(&size, row + offsets[i] + sizeof(uint16_t), sizeof(uint16_t));
+        needed += size;
+      }
+    }
+  }
+  if (needed <= varchars.size()) {
+    return;
+  }
+  const char *old = varchars.data();
+  varchars.resize(std::max(needed, 2 * varchars.size()));
+  // Move the views of the rows already in the chunk to the new buffer
+  for (size_t i = 0; i < columns.size(); i++) {
+    if (td.type_of(i) == type_t::VARCHAR) {
+      for (std::string_view &value : std::get<std::vector<std::string_view>>(columns[i]) | std::views::take(count)) {
+        value = {varchars.data() + (value.data() - old), value.size()};
+      }
+    }
+  }
+}
+
+std::span<const int> DataChunk::ints(size_t column) const {
+  return {std::get<std::vector<int>>(columns.at(column)).data(), count};
+}
+
+std::span<const double> DataChunk::doubles(size_t column) const {
+  return {std::get<std::vector<double>>(columns.at(column)).data(), count};
+}
+
+std::span<const std::string_view> DataChunk::strings(size_t column) const {
+  return {std::get<std::vector<std::string_view>>(columns.at(column)).data(), count};
+}
+
+Tuple DataChunk::getTuple(size_t row) const {
+  if (row >= count) {
+    throw std::out_of_range("Row out of range");
+  }
+  std::vector<field_t> fields;
+  fields.reserve(columns.size());
+  for (const column_t &column : columns) {
+    if (auto *values = std::get_if<std::vector<int>>(&column)) {
+      fields.emplace_back((*values)[row]);
+    } else if (auto *values = std::get_if<std::vector<double>>(&column)) {
+      fields.emplace_back((*values)[row]);
+    } else {
+      fields.emplace_back(std::string(std::get<std::vector<std::string_view>>(column)[row]));
+    }
+  }
+  return {fields};
+}
@@ -1,8 +1,38 @@
+#include <cstdlib>
 #include <db/Database.hpp>
+#include <stdexcept>
+#include <string>
 
 using namespace db;
 
-BufferPool &Database::getBufferPool() { return bufferPool; }
+namespace {
+BufferPoolOptions defaultBufferPoolOptions() {
+  BufferPoolOptions options;
+  if (const char *num_pages = std::getenv("DB_NUM_PAGES")) {
+    options.num_pages = std::stoul(num_pages);
+  }
+  return options;
+}
+} // namespace
+
+Database::Database() : ids(1, nullptr), bufferPool(std::make_unique<BufferPool>(defaultBufferPoolOptions())) {}
+
+BufferPool &Database::getBufferPool() { return *bufferPool; }
+
+void Database::configureBufferPool(const BufferPoolOptions &options) {
+  if (options.num_pages == 0) {
+    throw std::invalid_argument("Empty buffer pool");
+  }
+  // Flush the old pool first, then swap in the new one only once it is built: a failed construction keeps the old pool
+  for (auto &[name, file] : files) {
+    bufferPool->flushFile(file->getId());
+  }
+  auto pool = std::make_unique<BufferPool>(options);
+  bufferPool = std::move(pool);
+  for (auto &[name, file] : files) {
+    file->setDirectIo(options.direct_io);
+  }
+}
 
 Database &db::getDatabase() {
   static Database instance;
@@ -14,16 +44,31 @@ void Database::add(std::unique_ptr<DbFile> file) {
   if (files.contains(name)) {
     throw std::logic_error("File already exists");
   }
+  file->setDirectIo(bufferPool->getOptions().direct_io);
+  file->id = ids.size();
+  ids.push_back(file.get());
   files[name] = std::move(file);
 }
 
 std::unique_ptr<DbFile> Database::remove(const std::string &name) {
-  auto nh = files.extract(name);
-  if (nh.empty()) {
+  if (!files.contains(name)) {
     throw std::logic_error("File does not exist");
   }
-  Database::getBufferPool().flushFile(nh.key());
+  // Write back the dirty pages while the file can still be looked up
+  auto &file = files.at(name);
+  Database::getBufferPool().flushFile(file->id);
+  ids[file->id] = nullptr;
+  auto nh = files.extract(name);
   return std::move(nh.mapped());
 }
 
 DbFile &Database::get(const std::string &name) const { return *files.at(name); }
+
+DbFile &Database::get(file_id_t id) const {
+  if (id >= ids.size() || ids[id] == nullptr) {
+    throw std::out_of_range("Unknown file id");
+  }
+  return *ids[id];
+}
+
+PageId::PageId(const std::string &file, size_t page) : PageId(getDatabase().get(file).getId(), page) {}
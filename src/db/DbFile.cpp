@@ -1,6 +1,9 @@
+#include <algorithm>
+#include <db/Database.hpp>
 #include <db/DbFile.hpp>
 #include <stdexcept>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -24,35 +27,237 @@ DbFile::DbFile(const std::string &name, const TupleDesc &td) : name(name), td(td
 }
 
 DbFile::~DbFile() {
+  unmap();
   close(fd);
 }
 
 const std::string &DbFile::getName() const { return name; }
 
+void DbFile::map(bool sequential) {
+  unmap();
+  if (id != 0) {
+    // The mapping sees what is on disk
+    getDatabase().getBufferPool().flushFile(id);
+  }
+  struct stat st{};
+  if (fstat(fd, &st) == -1) {
+    throw std::runtime_error("fstat");
+  }
+  size_t pages = st.st_size / DEFAULT_PAGE_SIZE;
+  if (pages == 0) {
+    // An empty file has nothing to map: its only page reads as zeros
+    mapping = nullptr;
+  } else {
+    void *addr = mmap(nullptr, pages * DEFAULT_PAGE_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+      throw std::runtime_error("mmap");
+    }
+    madvise(addr, pages * DEFAULT_PAGE_SIZE, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+    madvise(addr, pages * DEFAULT_PAGE_SIZE, MADV_WILLNEED);
+    mapping = static_cast<const Page *>(addr);
+  }
+  mapped_pages = pages;
+  mapped = true;
+}
+
+void DbFile::unmap() {
+  if (mapping != nullptr) {
+    munmap(const_cast<Page *>(mapping), mapped_pages * DEFAULT_PAGE_SIZE);
+  }
+  mapping = nullptr;
+  mapped_pages = 0;
+  mapped = false;
+}
+
+bool DbFile::isMapped() const { return mapped; }
+
+ReadPageGuard DbFile::fetchRead(size_t page) const {
+  if (!mapped) {
+    return getDatabase().getBufferPool().fetchRead({id, page});
+  }
+  static const Page empty{};
+  const Page *p = page < mapped_pages ? &mapping[page] : &empty;
+  // The guard only gives const access to the page
+  return {nullptr, 0, {id, page}, const_cast<Page *>(p)};
+}
+
+void DbFile::fetchRead(size_t page, ReadPageGuard &guard) const {
+  if (!guard || guard.getPageId() != PageId{id, page}) {
+    guard = fetchRead(page);
+  }
+}
+
+WritePageGuard DbFile::fetchWrite(size_t page) {
+  if (mapped) {
+    throw std::logic_error("File is mapped read-only");
+  }
+  return getDatabase().getBufferPool().fetchWrite({id, page});
+}
+
+void DbFile::truncate(size_t pages) {
+  if (mapped) {
+    throw std::logic_error("File is mapped read-only");
+  }
+  size_t keep = std::min<size_t>(numPages, std::max<size_t>(pages, 1));
+  // Drop the frames first: the flusher must not write a dropped page past the new end of the file
+  if (id != 0) {
+    getDatabase().getBufferPool().discardPages(id, keep);
+  }
+  numPages = keep;
+  if (ftruncate(fd, numPages * DEFAULT_PAGE_SIZE) == -1) {
+    throw std::runtime_error("ftruncate");
+  }
+}
+
+namespace {
+bool isAligned(const Page &page) { return reinterpret_cast<uintptr_t>(page.data()) % DEFAULT_PAGE_SIZE == 0; }
+} // namespace
+
+bool DbFile::setDirectIo(bool enable) {
+  int flags = fcntl(fd, F_GETFL);
+  if (flags == -1) {
+    throw std::runtime_error("fcntl");
+  }
+  flags = enable ? flags | O_DIRECT : flags & ~O_DIRECT;
+  // Filesystems without direct I/O, such as tmpfs, refuse the flag: keep using the page cache
+  direct = fcntl(fd, F_SETFL, flags) == 0 ? enable : false;
+  return direct;
+}
+
+bool DbFile::isDirectIo() const { return direct; }
+
 void DbFile::readPage(Page &page, const size_t id) const {
-  reads.push_back(id);
-  pread(fd, page.data(), DEFAULT_PAGE_SIZE, id * DEFAULT_PAGE_SIZE);
+  if (direct && !isAligned(page)) {
+    // Direct I/O needs an aligned buffer
+    alignas(DEFAULT_PAGE_SIZE) Page bounce;
+    readPage(bounce, id);
+    page = bounce;
+    return;
+  }
+  IoRequest request = readRequest(page, id);
+  io.submit({&request, 1});
+}
+
+IoRequest DbFile::readRequest(Page &page, size_t id) const {
+  pages_read.fetch_add(1, std::memory_order_relaxed);
+  if (tracing.load(std::memory_order_relaxed)) {
+    std::lock_guard lock(trace_mutex);
+    if (read_trace) {
+      read_trace->record(id);
+    }
+  }
+  return {fd, &page, id * DEFAULT_PAGE_SIZE, false};
+}
+
+void DbFile::prefetch(size_t first, size_t count) const {
+  posix_fadvise(fd, first * DEFAULT_PAGE_SIZE, count * DEFAULT_PAGE_SIZE, POSIX_FADV_WILLNEED);
 }
 
 void DbFile::writePage(const Page &page, const size_t id) const {
-  writes.push_back(id);
-  pwrite(fd, page.data(), DEFAULT_PAGE_SIZE, id * DEFAULT_PAGE_SIZE);
+  if (direct && !isAligned(page)) {
+    alignas(DEFAULT_PAGE_SIZE) Page bounce = page;
+    writePage(bounce, id);
+    return;
+  }
+  IoRequest request = writeRequest(page, id);
+  io.submit({&request, 1});
+}
+
+IoRequest DbFile::writeRequest(const Page &page, size_t id) const {
+  pages_written.fetch_add(1, std::memory_order_relaxed);
+  if (tracing.load(std::memory_order_relaxed)) {
+    std::lock_guard lock(trace_mutex);
+    if (write_trace) {
+      write_trace->record(id);
+    }
+  }
+  // The backend only reads the page of a write request
+  return {fd, const_cast<Page *>(&page), id * DEFAULT_PAGE_SIZE, true};
+}
+
+void DbFile::sync() const {
+  if (fdatasync(fd) == -1) {
+    throw std::runtime_error("fdatasync");
+  }
+}
+
+void DbFile::setTrace(size_t capacity) {
+  std::lock_guard lock(trace_mutex);
+  read_trace = capacity == 0 ? nullptr : std::make_unique<IoTrace>(capacity);
+  write_trace = capacity == 0 ? nullptr : std::make_unique<IoTrace>(capacity);
+  tracing = capacity != 0;
+}
+
+std::vector<size_t> DbFile::getReads() const {
+  std::lock_guard lock(trace_mutex);
+  return read_trace ? read_trace->get() : std::vector<size_t>{};
 }
 
-const std::vector<size_t> &DbFile::getReads() const { return reads; }
+std::vector<size_t> DbFile::getWrites() const {
+  std::lock_guard lock(trace_mutex);
+  return write_trace ? write_trace->get() : std::vector<size_t>{};
+}
+
+DbFileStats DbFile::getStats() const {
+  size_t reads = pages_read;
+  size_t writes = pages_written;
+  return {reads, reads * DEFAULT_PAGE_SIZE, writes, writes * DEFAULT_PAGE_SIZE, io.getStats().latency};
+}
+
+void DbFile::insertTuple(const Tuple &) { throw std::runtime_error("Not implemented"); }
+
+void DbFile::deleteTuple(const Iterator &) { throw std::runtime_error("Not implemented"); }
+
+Tuple DbFile::getTuple(const Iterator &) const { throw std::runtime_error("Not implemented"); }
+
+void DbFile::next(Iterator &) const { throw std::runtime_error("Not implemented"); }
+
+TupleView DbFile::getTupleView(const Iterator &, ReadPageGuard &) const { throw std::runtime_error("Not implemented"); }
 
-const std::vector<size_t> &DbFile::getWrites() const { return writes; }
+void DbFile::next(Iterator &it, ReadPageGuard &guard) const {
+  guard.release();
+  next(it);
+}
+
+TupleViews DbFile::views() const { return TupleViews(*this); }
 
-void DbFile::insertTuple(const Tuple &t) { throw std::runtime_error("Not implemented"); }
+TupleViews DbFile::views(const Projection &projection) const { return TupleViews(*this, &projection); }
 
-void DbFile::deleteTuple(const Iterator &it) { throw std::runtime_error("Not implemented"); }
+Tuple DbFile::getTuple(const Iterator &it, const Projection &projection) const {
+  ReadPageGuard guard;
+  return projection.view(getTupleView(it, guard)).materialize();
+}
 
-Tuple DbFile::getTuple(const Iterator &it) const { throw std::runtime_error("Not implemented"); }
+size_t DbFile::scan(Iterator &it, DataChunk &chunk) const {
+  chunk.clear();
+  ReadPageGuard guard;
+  Iterator last = end();
+  while (it != last && !chunk.full()) {
+    const uint8_t *row = getTupleView(it, guard).bytes();
+    chunk.append({&row, 1});
+    next(it, guard);
+  }
+  return chunk.size();
+}
 
-void DbFile::next(Iterator &it) const { throw std::runtime_error("Not implemented"); }
+size_t DbFile::scan(Iterator &it, DataChunk &chunk, const Filter &filter) const {
+  chunk.clear();
+  ReadPageGuard guard;
+  Iterator last = end();
+  while (it != last && !chunk.full()) {
+    const uint8_t *row = getTupleView(it, guard).bytes();
+    if (filter.matches(row)) {
+      chunk.append({&row, 1});
+    }
+    next(it, guard);
+  }
+  return chunk.size();
+}
 
 Iterator DbFile::begin() const { throw std::runtime_error("Not implemented"); }
 
 Iterator DbFile::end() const { throw std::runtime_error("Not implemented"); }
 
+file_id_t DbFile::getId() const { return id; }
+
 size_t DbFile::getNumPages() const { return numPages; }
@@ -0,0 +1,336 @@
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <db/Filter.hpp>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+using namespace db;
+
+namespace {
+/// The bits of each byte in reverse order, to turn a lane mask into slot order
+constexpr std::array<uint8_t, 256> REVERSED = [] {
+  std::array<uint8_t, 256> reversed{};
+  for (size_t b = 0; b < 256; b++) {
+    for (size_t bit = 0; bit < 8; bit++) {
+      if (b & (1 << bit)) {
+        reversed[b] |= 1 << (7 - bit);
+      }
+    }
+  }
+  return reversed;
+}();
+
+template <typename T> T valueOf(const field_t &field) {
+  if (!std::holds_alternative<T>(field)) {
+    throw std::invalid_argument("Predicate value does not match the type of its column");
+  }
+  return std::get<T>(field);
+}
+
+/**
+ * @brief Find the fields in `[lo, hi]` among `count` fields `stride` bytes apart, the first in the most significant
+ * bit.
+ */
+template <typename T> uint64_t rangeScalar(const uint8_t *field, size_t stride, size_t count, T lo, T hi) {
+  uint64_t mask = 0;
+  for (size_t k = 0; k < count; k++, field += stride) {
+    T x;
+    std::memcpy(&x, field, sizeof(T));
+    mask |= uint64_t{x >= lo && x <= hi} << (63 - k);
+  }
+  return mask;
+}
+
+#if defined(__x86_64__)
+bool cpuHasAvx2() { return __builtin_cpu_supports("avx2"); }
+
+__attribute__((target("avx2"))) uint64_t intRangeAvx2(const uint8_t *field, size_t stride, size_t count, int lo,
+                                                      int hi) {
+  const __m256i index =
+      _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(stride)));
+  const __m256i vlo = _mm256_set1_epi32(lo);
+  const __m256i vhi = _mm256_set1_epi32(hi);
+  uint64_t mask = 0;
+  size_t k = 0;
+  for (; k + 8 <= count; k += 8) {
+    // The fields of a PAX minipage are contiguous: a plain load replaces the gather
+    const uint8_t *at = field + k * stride;
+    __m256i x = stride == INT_SIZE ? _mm256_loadu_si256(reinterpret_cast<const __m256i *>(at))
+                                   : _mm256_i32gather_epi32(reinterpret_cast<const int *>(at), index, 1);
+    __m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(vlo, x), _mm256_cmpgt_epi32(x, vhi));
+    unsigned in = ~_mm256_movemask_ps(_mm256_castsi256_ps(out)) & 0xff;
+    mask |= uint64_t{REVERSED[in]} << (56 - k);
+  }
+  // The slots of a page may end inside a group of 8: gathering them would read past the page
+  return k == count ? mask : mask | rangeScalar(field + k * stride, stride, count - k, lo, hi) >> k;
+}
+
+__attribute__((target("avx2"))) uint64_t doubleRangeAvx2(const uint8_t *field, size_t stride, size_t count,
+                                                         double lo, double hi) {
+  const __m128i index = _mm_mullo_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(static_cast<int>(stride)));
+  const __m256d vlo = _mm256_set1_pd(lo);
+  const __m256d vhi = _mm256_set1_pd(hi);
+  // Gathers every lane into zeros rather than into the undefined register of _mm256_i32gather_pd
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+  uint64_t mask = 0;
+  size_t k = 0;
+  for (; k + 8 <= count; k += 8) {
+    unsigned in = 0;
+    for (size_t half = 0; half < 2; half++) {
+      const uint8_t *at = field + (k + 4 * half) * stride;
+      const double *doubles = reinterpret_cast<const double *>(at);
+      __m256d x =
+          stride == DOUBLE_SIZE ? _mm256_loadu_pd(doubles) : _mm256_mask_i32gather_pd(zero, doubles, index, all, 1);
+      __m256d inside = _mm256_and_pd(_mm256_cmp_pd(x, vlo, _CMP_GE_OQ), _mm256_cmp_pd(x, vhi, _CMP_LE_OQ));
+      in |= _mm256_movemask_pd(inside) << (4 * half);
+    }
+    mask |= uint64_t{REVERSED[in]} << (56 - k);
+  }
+  return k == count ? mask : mask | rangeScalar(field + k * stride, stride, count - k, lo, hi) >> k;
+}
+#else
+bool cpuHasAvx2() { return false; }
+#endif
+} // namespace
+
+Filter::Filter(const TupleDesc &td, std::span<const Predicate> predicates, bool simd) : simd(simd && cpuHasAvx2()) {
+  for (const Predicate &p : predicates) {
+    if (p.column >= td.size()) {
+      throw std::invalid_argument("Predicate column out of range");
+    }
+    Term term{.column = p.column, .offset = td.offset_of(p.column), .type = td.type_of(p.column)};
+    switch (term.type) {
+    case type_t::INT: {
+      int v = valueOf<int>(p.value);
+      constexpr int min = std::numeric_limits<int>::min();
+      constexpr int max = std::numeric_limits<int>::max();
+      term.int_lo = min;
+      term.int_hi = max;
+      switch (p.op) {
+      case predicate_op_t::EQ:
+      case predicate_op_t::NE:
+        term.int_lo = term.int_hi = v;
+        term.negate = p.op == predicate_op_t::NE;
+        break;
+      case predicate_op_t::LT:
+        if (v == min) {
+          // Nothing is less than the minimum: an empty range
+          term.int_lo = max;
+          term.int_hi = min;
+        } else {
+          term.int_hi = v - 1;
+        }
+        break;
+      case predicate_op_t::LE:
+        term.int_hi = v;
+        break;
+      case predicate_op_t::GT:
+        if (v == max) {
+          term.int_lo = max;
+          term.int_hi = min;
+        } else {
+          term.int_lo = v + 1;
+        }
+        break;
+      case predicate_op_t::GE:
+        term.int_lo = v;
+        break;
+      case predicate_op_t::BETWEEN:
+        term.int_lo = v;
+        term.int_hi = valueOf<int>(p.upper);
+        break;
+      case predicate_op_t::PREFIX:
+        throw std::invalid_argument("PREFIX only applies to CHAR columns");
+      }
+      numeric.push_back(term);
+      break;
+    }
+    case type_t::DOUBLE: {
+      double v = valueOf<double>(p.value);
+      constexpr double inf = std::numeric_limits<double>::infinity();
+      term.double_lo = -inf;
+      term.double_hi = inf;
+      switch (p.op) {
+      case predicate_op_t::EQ:
+      case predicate_op_t::NE:
+        term.double_lo = term.double_hi = v;
+        term.negate = p.op == predicate_op_t::NE;
+        break;
+      case predicate_op_t::LT:
+        term.double_hi = std::nextafter(v, -inf);
+        break;
+      case predicate_op_t::LE:
+        term.double_hi = v;
+        break;
+      case predicate_op_t::GT:
+        term.double_lo = std::nextafter(v, inf);
+        break;
+      case predicate_op_t::GE:
+        term.double_lo = v;
+        break;
+      case predicate_op_t::BETWEEN:
+        term.double_lo = v;
+        term.double_hi = valueOf<double>(p.upper);
+        break;
+      case predicate_op_t::PREFIX:
+        throw std::invalid_argument("PREFIX only applies to CHAR columns");
+      }
+      numeric.push_back(term);
+      break;
+    }
+    case type_t::CHAR: {
+      std::string v = valueOf<std::string>(p.value);
+      switch (p.op) {
+      case predicate_op_t::EQ:
+      case predicate_op_t::NE:
+        // The field as TupleDesc::serialize stores the value
+        term.chars.assign(CHAR_SIZE, '\0');
+        strncpy(term.chars.data(), v.c_str(), CHAR_SIZE);
+        term.negate = p.op == predicate_op_t::NE;
+        break;
+      case predicate_op_t::PREFIX:
+        term.chars.assign(v.c_str(), strnlen(v.c_str(), CHAR_SIZE));
+        break;
+      default:
+        throw std::invalid_argument("CHAR columns only support EQ, NE and PREFIX");
+      }
+      strings.push_back(term);
+      break;
+    }
+    case type_t::VARCHAR: {
+      term.chars = valueOf<std::string>(p.value);
+      switch (p.op) {
+      case predicate_op_t::EQ:
+      case predicate_op_t::NE:
+        term.negate = p.op == predicate_op_t::NE;
+        break;
+      case predicate_op_t::PREFIX:
+        term.prefix = true;
+        break;
+      default:
+        throw std::invalid_argument("VARCHAR columns only support EQ, NE and PREFIX");
+      }
+      strings.push_back(term);
+      break;
+    }
+    }
+  }
+}
+
+bool Filter::usesSimd() const { return simd; }
+
+bool Filter::matches(const Term &term, const uint8_t *field) {
+  bool inside = false;
+  switch (term.type) {
+  case type_t::INT:
+    inside = rangeScalar(field, 0, 1, term.int_lo, term.int_hi) != 0;
+    break;
+  case type_t::DOUBLE:
+    inside = rangeScalar(field, 0, 1, term.double_lo, term.double_hi) != 0;
+    break;
+  case type_t::CHAR:
+    inside = std::memcmp(field, term.chars.data(), term.chars.size()) == 0;
+    break;
+  case type_t::VARCHAR: {
+    // The characters are located from the start of the row
+    const uint8_t *row = field - term.offset;
+    uint16_t at, size;
+    std::memcpy(&at, field, sizeof(uint16_t));
+    std::memcpy(&size, field + sizeof(uint16_t), sizeof(uint16_t));
+    inside = (term.prefix ? size >= term.chars.size() : size == term.chars.size()) &&
+             std::memcmp(row + at, term.chars.data(), term.chars.size()) == 0;
+    break;
+  }
+  }
+  return inside != term.negate;
+}
+
+template <typename Fields> uint64_t Filter::select(Fields fields, size_t count, uint64_t candidates) const {
+  uint64_t mask = candidates;
+  for (const Term &term : numeric) {
+    if (mask == 0) {
+      return 0;
+    }
+    auto [field, stride] = fields(term);
+    uint64_t inside;
+    if (term.type == type_t::INT) {
+#if defined(__x86_64__)
+      inside = simd ? intRangeAvx2(field, stride, count, term.int_lo, term.int_hi)
+                    : rangeScalar(field, stride, count, term.int_lo, term.int_hi);
+#else
+      inside = rangeScalar(field, stride, count, term.int_lo, term.int_hi);
+#endif
+    } else {
+#if defined(__x86_64__)
+      inside = simd ? doubleRangeAvx2(field, stride, count, term.double_lo, term.double_hi)
+                    : rangeScalar(field, stride, count, term.double_lo, term.double_hi);
+#else
+      inside = rangeScalar(field, stride, count, term.double_lo, term.double_hi);
+#endif
+    }
+    mask &= term.negate ? ~inside : inside;
+  }
+  for (const Term &term : strings) {
+    auto [field, stride] = fields(term);
+    for (uint64_t left = mask; left != 0;) {
+      size_t k = std::countl_zero(left);
+      uint64_t bit = uint64_t{1} << (63 - k);
+      left &= ~bit;
+      if (!matches(term, field + k * stride)) {
+        mask &= ~bit;
+      }
+    }
+  }
+  return mask;
+}
+
+uint64_t Filter::select(const uint8_t *rows, size_t stride, size_t count, uint64_t candidates) const {
+  return select([&](const Term &term) { return std::pair(rows + term.offset, stride); }, count, candidates);
+}
+
+uint64_t Filter::selectColumns(const uint8_t *minipages, size_t slots, size_t first, size_t count,
+                               uint64_t candidates) const {
+  return select(
+      [&](const Term &term) {
+        size_t size = size_of(term.type);
+        return std::pair(minipages + term.offset * slots + first * size, size);
+      },
+      count, candidates);
+}
+
+bool Filter::matches(const uint8_t *row) const {
+  for (const Term &term : numeric) {
+    if (!matches(term, row + term.offset)) {
+      return false;
+    }
+  }
+  for (const Term &term : strings) {
+    if (!matches(term, row + term.offset)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Filter::mayMatch(size_t column, double min, double max) const {
+  for (const Term &term : numeric) {
+    if (term.column != column) {
+      continue;
+    }
+    // Every int is exactly a double
+    double lo = term.type == type_t::INT ? term.int_lo : term.double_lo;
+    double hi = term.type == type_t::INT ? term.int_hi : term.double_hi;
+    bool excluded = term.negate ? lo <= min && max <= hi : hi < min || max < lo;
+    if (excluded) {
+      return false;
+    }
+  }
+  return true;
+}
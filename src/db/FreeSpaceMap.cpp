@@ -0,0 +1,152 @@
+#include <bit>
+#include <cstring>
+#include <db/FreeSpaceMap.hpp>
+#include <filesystem>
+
+using namespace db;
+
+namespace {
+/// The low bit of every 2-bit entry of a word
+constexpr uint64_t LOW_BITS = 0x5555555555555555ULL;
+
+/// Sets the low bit of every entry of the word that is not FULL
+uint64_t withRoom(uint64_t word) { return (word | word >> 1) & LOW_BITS; }
+
+constexpr uint32_t MAGIC = 0x46534d31;
+
+/// The first bytes of the header page of the map file, followed by the pages of words
+struct Header {
+  uint32_t magic;
+  /// The format of the pages of the heap file, 0 if unknown
+  uint32_t format;
+};
+} // namespace
+
+FreeSpaceMap::FreeSpaceMap(const std::string &name, size_t pages) : file(name, TupleDesc()) {
+  size_t map_pages = std::filesystem::file_size(name) / DEFAULT_PAGE_SIZE;
+  Page page;
+  if (map_pages != 0) {
+    file.readPage(page, 0);
+    Header header;
+    std::memcpy(&header, page.data(), sizeof(Header));
+    if (header.magic == MAGIC) {
+      format = header.format;
+      header_dirty = false;
+    } else {
+      // Not a map file of this format: its entries are not trusted
+      map_pages = 1;
+    }
+  }
+  std::string bytes(map_pages == 0 ? 0 : (map_pages - 1) * DEFAULT_PAGE_SIZE, '\0');
+  for (size_t i = 1; i < map_pages; i++) {
+    file.readPage(page, i);
+    std::memcpy(bytes.data() + (i - 1) * DEFAULT_PAGE_SIZE, page.data(), DEFAULT_PAGE_SIZE);
+  }
+  size_t covered = std::min(bytes.size() / sizeof(uint64_t) * PAGES_PER_WORD, pages);
+  resize(pages);
+  std::memcpy(words.data(), bytes.data(), (covered + PAGES_PER_WORD - 1) / PAGES_PER_WORD * sizeof(uint64_t));
+  for (size_t i = covered; i < words.size() * PAGES_PER_WORD; i++) {
+    store(i, i < pages ? EMPTY : FULL);
+  }
+  for (size_t i = 0; i < words.size(); i++) {
+    if (withRoom(words[i]) != 0) {
+      summary[i / 64] |= uint64_t{1} << (i % 64);
+    }
+  }
+}
+
+FreeSpaceMap::~FreeSpaceMap() {
+  try {
+    flush();
+  } catch (const std::runtime_error &) {
+    // The map is a hint: a stale map only costs a few failed inserts
+  }
+}
+
+void FreeSpaceMap::resize(size_t pages) {
+  size_t num_words = (pages + PAGES_PER_WORD - 1) / PAGES_PER_WORD;
+  if (num_words <= words.size()) {
+    return;
+  }
+  words.resize(num_words);
+  summary.resize((num_words + 63) / 64);
+  dirty.resize((num_words + WORDS_PER_PAGE - 1) / WORDS_PER_PAGE, true);
+}
+
+void FreeSpaceMap::store(size_t page, uint8_t category) {
+  size_t word = page / PAGES_PER_WORD;
+  size_t shift = page % PAGES_PER_WORD * 2;
+  words[word] = (words[word] & ~(uint64_t{3} << shift)) | uint64_t{category} << shift;
+  uint64_t bit = uint64_t{1} << (word % 64);
+  summary[word / 64] = withRoom(words[word]) != 0 ? summary[word / 64] | bit : summary[word / 64] & ~bit;
+  dirty[word / WORDS_PER_PAGE] = true;
+}
+
+uint8_t FreeSpaceMap::category(size_t free, size_t capacity) {
+  if (free == 0) {
+    return FULL;
+  }
+  if (free == capacity) {
+    return EMPTY;
+  }
+  return 2 * free >= capacity ? HALF : LOW;
+}
+
+size_t FreeSpaceMap::find() const {
+  std::lock_guard lock(mutex);
+  for (size_t i = 0; i < summary.size(); i++) {
+    if (summary[i] != 0) {
+      size_t word = i * 64 + std::countr_zero(summary[i]);
+      return word * PAGES_PER_WORD + std::countr_zero(withRoom(words[word])) / 2;
+    }
+  }
+  return npos;
+}
+
+uint8_t FreeSpaceMap::get(size_t page) const {
+  std::lock_guard lock(mutex);
+  if (page / PAGES_PER_WORD >= words.size()) {
+    return FULL;
+  }
+  return words[page / PAGES_PER_WORD] >> (page % PAGES_PER_WORD * 2) & 3;
+}
+
+uint32_t FreeSpaceMap::getFormat() const {
+  std::lock_guard lock(mutex);
+  return format;
+}
+
+void FreeSpaceMap::setFormat(uint32_t format) {
+  std::lock_guard lock(mutex);
+  header_dirty |= this->format != format;
+  this->format = format;
+}
+
+void FreeSpaceMap::set(size_t page, uint8_t category) {
+  std::lock_guard lock(mutex);
+  resize(page + 1);
+  store(page, category);
+}
+
+void FreeSpaceMap::flush() {
+  std::lock_guard lock(mutex);
+  Page page;
+  if (header_dirty) {
+    page.fill(0);
+    Header header{.magic = MAGIC, .format = format};
+    std::memcpy(page.data(), &header, sizeof(Header));
+    file.writePage(page, 0);
+    header_dirty = false;
+  }
+  for (size_t i = 0; i < dirty.size(); i++) {
+    if (!dirty[i]) {
+      continue;
+    }
+    page.fill(0);
+    size_t first = i * WORDS_PER_PAGE;
+    size_t count = std::min(WORDS_PER_PAGE, words.size() - first);
+    std::memcpy(page.data(), words.data() + first, count * sizeof(uint64_t));
+    file.writePage(page, i + 1);
+    dirty[i] = false;
+  }
+}
@@ -1,82 +1,299 @@
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <cstring>
 #include <db/Database.hpp>
 #include <db/HeapFile.hpp>
+#include <db/HeapLoader.hpp>
 #include <db/HeapPage.hpp>
+#include <filesystem>
 #include <stdexcept>
 
 using namespace db;
 
-HeapFile::HeapFile(const std::string &name, const TupleDesc &td) : DbFile(name, td) {}
+HeapFile::HeapFile(const std::string &name, const TupleDesc &td, page_layout_t layout, bool zone_map)
+    : DbFile(name, td), fsm(name + ".fsm", numPages), layout(layout) {
+  if (layout == page_layout_t::PAX && td.variable_length()) {
+    throw std::invalid_argument("PAX pages do not support VARCHAR fields");
+  }
+  // The layout is recorded in the header of the free space map when the file is created, and checked when it is
+  // reopened: pages read with another layout would be decoded as garbage
+  uint32_t format = static_cast<uint32_t>(layout) + 1;
+  uint32_t recorded = fsm.getFormat();
+  if (recorded != format) {
+    if (recorded != 0 && std::filesystem::file_size(name) != 0) {
+      throw std::invalid_argument("HeapFile reopened with another page layout than it was created with");
+    }
+    fsm.setFormat(format);
+    fsm.flush();
+  }
+  if (zone_map) {
+    // The page of a new file is not written yet, and its zone starts empty with the first insert
+    zones = std::make_unique<ZoneMap>(name + ".zm", td, std::filesystem::file_size(name) / DEFAULT_PAGE_SIZE);
+  } else {
+    std::remove((name + ".zm").c_str());
+  }
+}
 
-void HeapFile::insertTuple(const Tuple &t) {
+uint8_t HeapFile::category(const HeapPage &hp) { return FreeSpaceMap::category(hp.freeSlots(), hp.end()); }
+
+uint8_t HeapFile::category(const PaxPage &pp) { return FreeSpaceMap::category(pp.freeSlots(), pp.end()); }
+
+uint8_t HeapFile::category(const SlottedPage &sp) const {
+  size_t free = sp.freeSpace();
+  return FreeSpaceMap::category(free < td.length() ? 0 : free, SlottedPage::CAPACITY);
+}
+
+void HeapFile::check(const Tuple &t) const {
   if (!td.compatible(t)) {
     throw std::runtime_error("Tuple not compatible with TupleDesc");
   }
-  BufferPool &bufferPool = getDatabase().getBufferPool();
-  PageId pid{name, 0};
-  pid.page = numPages - 1;
-  Page &p = bufferPool.getPage(pid);
-  HeapPage hp(p, td);
-  if (!hp.insertTuple(t)) {
-    numPages++;
-    pid.page++;
-    Page &np = bufferPool.getPage(pid);
-    HeapPage nhp(np, td);
-    nhp.insertTuple(t);
+  if (td.variable_length() && td.length(t) > SlottedPage::CAPACITY) {
+    throw std::runtime_error("Tuple too long for a page");
   }
-  bufferPool.markDirty(pid);
+}
+
+template <typename F> void HeapFile::insert(F &&insert) {
+  while (true) {
+    size_t last = numPages - 1;
+    size_t page = fsm.find();
+    if (page >= last) {
+      page = last;
+    }
+    {
+      WritePageGuard guard = fetchWrite(page);
+      bool inserted = withPage(*guard, [&](auto &hp) {
+        bool inserted = insert(hp, page);
+        // Recorded under the latch, so that the entry follows the order of the changes to the page. A page without
+        // room for this tuple is not offered again for the next attempt
+        fsm.set(page, inserted ? category(hp) : FreeSpaceMap::FULL);
+        return inserted;
+      });
+      if (inserted) {
+        return;
+      }
+    }
+    if (page != last) {
+      // The map was stale: the entry is now fixed, try another page
+      continue;
+    }
+    // The last page is full: append a page, unless a concurrent insert already did
+    size_t expected = last + 1;
+    numPages.compare_exchange_strong(expected, last + 2);
+  }
+}
+
+void HeapFile::insertTuple(const Tuple &t) {
+  check(t);
+  insert([&](auto &hp, size_t page) {
+    if (!hp.insertTuple(t)) {
+      return false;
+    }
+    if (zones) {
+      zones->add(page, t);
+    }
+    return true;
+  });
+}
+
+void HeapFile::insertSerialized(std::span<const uint8_t> row) {
+  if (td.variable_length() ? row.size() < td.length() || row.size() > SlottedPage::CAPACITY
+                           : row.size() != td.length()) {
+    throw std::invalid_argument("Serialized tuple not compatible with TupleDesc");
+  }
+  // The characters of each VARCHAR field must lie in the row, after its fixed-size fields
+  for (size_t i = 0; td.variable_length() && i < td.size(); i++) {
+    if (td.type_of(i) != type_t::VARCHAR) {
+      continue;
+    }
+    uint16_t at, size;
+    std::memcpy(&at, row.data() + td.offset_of(i), sizeof(uint16_t));
+    std::memcpy(&size, row.data() + td.offset_of(i) + sizeof(uint16_t), sizeof(uint16_t));
+    if (at < td.length() || at + size > row.size()) {
+      throw std::invalid_argument("Serialized VARCHAR field out of the row");
+    }
+  }
+  insert([&](auto &hp, size_t page) {
+    if (!hp.insertSerialized(row)) {
+      return false;
+    }
+    if (zones) {
+      zones->add(page, row.data());
+    }
+    return true;
+  });
+}
+
+void HeapFile::insertTuples(std::span<const Tuple> tuples) {
+  HeapLoader loader(*this);
+  for (const Tuple &t : tuples) {
+    loader.append(t);
+  }
+  loader.finish();
 }
 
 void HeapFile::deleteTuple(const Iterator &it) {
-  BufferPool &bufferPool = getDatabase().getBufferPool();
-  PageId pid{name, it.page};
-  Page &p = bufferPool.getPage(pid);
-  HeapPage hp(p, td);
-  bufferPool.markDirty(pid);
-  hp.deleteTuple(it.slot);
+  WritePageGuard guard = fetchWrite(it.page);
+  withPage(*guard, [&](auto &hp) {
+    hp.deleteTuple(it.slot);
+    fsm.set(it.page, category(hp));
+    if (zones) {
+      zones->remove(it.page, hp.size());
+    }
+  });
+}
+
+void HeapFile::flushFreeSpaceMap() { fsm.flush(); }
+
+const FreeSpaceMap &HeapFile::getFreeSpaceMap() const { return fsm; }
+
+void HeapFile::flushZoneMap() {
+  if (zones) {
+    zones->flush();
+  }
 }
 
+const ZoneMap *HeapFile::getZoneMap() const { return zones.get(); }
+
 Tuple HeapFile::getTuple(const Iterator &it) const {
-  BufferPool &bufferPool = getDatabase().getBufferPool();
-  PageId pid{name, it.page};
-  Page &p = bufferPool.getPage(pid);
-  HeapPage hp(p, td);
-  return hp.getTuple(it.slot);
+  ReadPageGuard guard = fetchRead(it.page);
+  return withPage(*guard, [&](const auto &hp) { return hp.getTuple(it.slot); });
+}
+
+TupleView HeapFile::getTupleView(const Iterator &it, ReadPageGuard &guard) const {
+  fetchRead(it.page, guard);
+  return withPage(*guard, [&](const auto &hp) { return hp.getTupleView(it.slot); });
 }
 
 void HeapFile::next(Iterator &it) const {
-  BufferPool &bufferPool = getDatabase().getBufferPool();
+  ReadPageGuard guard;
+  next(it, guard);
+}
+
+void HeapFile::next(Iterator &it, ReadPageGuard &guard) const {
   if (it.page < numPages) {
-    PageId pid{name, it.page};
-    Page &p = bufferPool.getPage(pid);
-    const HeapPage hp(p, td);
-    hp.next(it.slot);
-    if (it.slot != hp.end()) {
+    fetchRead(it.page, guard);
+    bool found = withPage(*guard, [&](const auto &hp) {
+      hp.next(it.slot);
+      return it.slot != hp.end();
+    });
+    if (found) {
       return;
     }
     it.page++;
   }
   while (it.page < numPages) {
-    PageId pid{name, it.page};
-    Page &p = bufferPool.getPage(pid);
-    const HeapPage hp(p, td);
-    it.slot = hp.begin();
-    if (it.slot != hp.end()) {
+    fetchRead(it.page, guard);
+    bool found = withPage(*guard, [&](const auto &hp) {
+      it.slot = hp.begin();
+      return it.slot != hp.end();
+    });
+    if (found) {
       return;
     }
     it.page++;
   }
   it.slot = 0;
+  guard.release();
+}
+
+size_t HeapFile::scan(Iterator &it, DataChunk &chunk) const { return scan(it, chunk, NO_END); }
+
+size_t HeapFile::scan(Iterator &it, DataChunk &chunk, size_t end) const {
+  chunk.clear();
+  std::array<size_t, 256> slots;
+  ReadPageGuard guard;
+  while (it.page < std::min<size_t>(end, numPages)) {
+    fetchRead(it.page, guard);
+    // Whether the scan stops inside this page
+    bool stop = withPage(*guard, [&](const auto &hp) {
+      if (it.slot < hp.end() && hp.empty(it.slot)) {
+        // Entering a page at slot 0
+        hp.next(it.slot);
+      }
+      if (chunk.full() && it.slot != hp.end()) {
+        return true;
+      }
+      // The slots are decoded before the guard moves to another page
+      size_t n = 0;
+      while (it.slot != hp.end() && chunk.size() + n < chunk.getCapacity()) {
+        slots[n++] = it.slot;
+        hp.next(it.slot);
+        if (n == slots.size()) {
+          hp.decode(slots, chunk);
+          n = 0;
+        }
+      }
+      hp.decode({slots.data(), n}, chunk);
+      return it.slot != hp.end();
+    });
+    if (stop) {
+      break;
+    }
+    it.page++;
+    it.slot = 0;
+  }
+  return chunk.size();
+}
+
+size_t HeapFile::scan(Iterator &it, DataChunk &chunk, const Filter &filter) const {
+  return scan(it, chunk, filter, NO_END);
+}
+
+size_t HeapFile::scan(Iterator &it, DataChunk &chunk, const Filter &filter, size_t end) const {
+  chunk.clear();
+  std::array<size_t, 256> slots;
+  ReadPageGuard guard;
+  while (it.page < std::min<size_t>(end, numPages)) {
+    if (it.slot == 0 && zones && !zones->mayMatch(it.page, filter)) {
+      it.page++;
+      continue;
+    }
+    fetchRead(it.page, guard);
+    bool stop = withPage(*guard, [&](const auto &hp) {
+      size_t n = 0;
+      while (it.slot < hp.end() && chunk.size() + n < chunk.getCapacity()) {
+        size_t first = it.slot / 64 * 64;
+        // Skip the slots of the group before the position
+        uint64_t matches = hp.select(it.slot / 64, filter) & ~uint64_t{0} >> it.slot % 64;
+        it.slot = first + 64;
+        while (matches != 0) {
+          size_t slot = first + std::countl_zero(matches);
+          if (chunk.size() + n == chunk.getCapacity()) {
+            // The chunk is full: resume at this match
+            it.slot = slot;
+            break;
+          }
+          slots[n++] = slot;
+          if (n == slots.size()) {
+            hp.decode(slots, chunk);
+            n = 0;
+          }
+          matches &= ~(uint64_t{1} << (63 - (slot - first)));
+        }
+      }
+      hp.decode({slots.data(), n}, chunk);
+      return it.slot < hp.end();
+    });
+    if (stop) {
+      break;
+    }
+    it.page++;
+    it.slot = 0;
+  }
+  return chunk.size();
 }
 
 Iterator HeapFile::begin() const {
-  BufferPool &bufferPool = getDatabase().getBufferPool();
   size_t page = 0;
   while (page < numPages) {
-    PageId pid{name, page};
-    Page &p = bufferPool.getPage(pid);
-    const HeapPage hp(p, td);
-    size_t slot = hp.begin();
-    if (slot != hp.end())
+    ReadPageGuard guard = fetchRead(page);
+    size_t slot;
+    bool found = withPage(*guard, [&](const auto &hp) {
+      slot = hp.begin();
+      return slot != hp.end();
+    });
+    if (found)
       return {*this, page, slot};
     page++;
   }
@@ -0,0 +1,99 @@
+#include <db/HeapLoader.hpp>
+#include <db/IoBackend.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+HeapLoader::HeapLoader(HeapFile &file, size_t batch_pages) : file(file), batch(batch_pages, false) {
+  if (file.isMapped()) {
+    throw std::logic_error("Cannot load a mapped file");
+  }
+}
+
+HeapLoader::~HeapLoader() {
+  try {
+    finish();
+  } catch (const std::exception &) {
+    // A destructor cannot report the error, and may run while another exception unwinds: the tuples not written are
+    // lost, as documented. finish() reports it
+  }
+}
+
+void HeapLoader::append(const Tuple &t) {
+  const TupleDesc &td = file.getTupleDesc();
+  file.check(t);
+  if (top_up) {
+    size_t last = file.numPages - 1;
+    {
+      WritePageGuard guard = file.fetchWrite(last);
+      bool inserted = file.withPage(*guard, [&](auto &hp) {
+        bool inserted = hp.insertTuple(t);
+        file.fsm.set(last, file.category(hp));
+        if (inserted && file.zones) {
+          file.zones->add(last, t);
+        }
+        return inserted;
+      });
+      if (inserted) {
+        return;
+      }
+    }
+    // The last page is full: the following pages are written by the loader
+    top_up = false;
+    first = last + 1;
+  }
+  auto insert = [&t]<typename P>(P &p) {
+    if constexpr (std::is_same_v<P, std::monostate>) {
+      return false;
+    } else {
+      return p.insertTuple(t);
+    }
+  };
+  if (std::visit(insert, page)) {
+    if (file.zones) {
+      file.zones->add(first + count - 1, t);
+    }
+    return;
+  }
+  if (count == batch.size()) {
+    write();
+  }
+  Page &fresh = batch[count++];
+  fresh.fill(0);
+  if (td.variable_length()) {
+    page.emplace<SlottedPage>(fresh, td);
+  } else if (file.layout == page_layout_t::PAX) {
+    page.emplace<PaxPage>(fresh, td);
+  } else {
+    page.emplace<HeapPage>(fresh, td);
+  }
+  std::visit(insert, page);
+  if (file.zones) {
+    file.zones->add(first + count - 1, t);
+  }
+}
+
+void HeapLoader::finish() {
+  if (count != 0) {
+    write();
+  }
+  top_up = true;
+}
+
+void HeapLoader::write() {
+  // Contiguous pages: the backend writes the batch with a single call
+  std::vector<IoRequest> requests;
+  requests.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    requests.push_back(file.writeRequest(batch[i], first + i));
+  }
+  SyncIoBackend().submit(requests);
+
+  for (size_t i = 0; i < count; i++) {
+    file.fsm.set(first + i, file.withPage(batch[i], [this](const auto &hp) { return file.category(hp); }));
+  }
+  file.numPages = first + count;
+  first += count;
+  count = 0;
+  page.emplace<std::monostate>();
+}
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
 #include <db/Database.hpp>
 #include <db/HeapPage.hpp>
 #include <stdexcept>
@@ -10,31 +14,98 @@ HeapPage::HeapPage(Page &page, const TupleDesc &td) : td(td) {
   data = header + DEFAULT_PAGE_SIZE - td.length() * capacity;
 }
 
-size_t HeapPage::begin() const {
-  for (size_t i = 0; i < capacity; i++) {
-    if (!empty(i)) {
-      return i;
+HeapPage::HeapPage(const Page &page, const TupleDesc &td) : HeapPage(const_cast<Page &>(page), td) {}
+
+uint64_t HeapPage::word(size_t i) const {
+  uint64_t w = 0;
+  size_t first = i * 8;
+  size_t bytes = (capacity + 7) / 8;
+  if (first + 8 <= bytes) {
+    std::memcpy(&w, header + first, 8);
+    if constexpr (std::endian::native == std::endian::little) {
+      w = __builtin_bswap64(w);
+    }
+  } else {
+    // The header ends inside this word
+    for (size_t b = first; b < bytes; b++) {
+      w |= uint64_t{header[b]} << (56 - 8 * (b - first));
     }
   }
-  return capacity;
+  size_t end = (i + 1) * 64;
+  if (end > capacity) {
+    // The padding bits of the last header byte may be set
+    w &= ~uint64_t{0} << (end - capacity);
+  }
+  return w;
 }
 
-size_t HeapPage::end() const { return capacity; }
+size_t HeapPage::numWords() const { return (capacity + 63) / 64; }
 
-bool HeapPage::insertTuple(const Tuple &t) {
-  size_t slot = 0;
-  while (slot < capacity && (header[slot / 8] & (1 << (7 - slot % 8)))) {
-    slot++;
+uint64_t HeapPage::select(size_t i, const Filter &filter) const {
+  size_t first = i * 64;
+  return filter.select(data + first * td.length(), td.length(), std::min<size_t>(64, capacity - first), word(i));
+}
+
+size_t HeapPage::begin() const { return scan(0); }
+
+size_t HeapPage::size() const {
+  if (occupied == size_t(-1)) {
+    occupied = 0;
+    for (size_t i = 0; i < numWords(); i++) {
+      occupied += std::popcount(word(i));
+    }
+  }
+  return occupied;
+}
+
+size_t HeapPage::freeSlots() const { return capacity - size(); }
+
+size_t HeapPage::claim() {
+  if (occupied == capacity) {
+    return capacity;
+  }
+  size_t slot = capacity;
+  for (size_t i = 0; i < numWords(); i++) {
+    uint64_t free = ~word(i);
+    size_t end = (i + 1) * 64;
+    if (end > capacity) {
+      free &= ~uint64_t{0} << (end - capacity);
+    }
+    if (free != 0) {
+      slot = i * 64 + std::countl_zero(free);
+      break;
+    }
   }
   if (slot == capacity) {
-    return false;
+    occupied = capacity;
+    return capacity;
   }
   header[slot / 8] |= 1 << (7 - slot % 8);
+  if (occupied != size_t(-1)) {
+    occupied++;
+  }
+  return slot;
+}
+
+bool HeapPage::insertTuple(const Tuple &t) {
+  size_t slot = claim();
+  if (slot == capacity) {
+    return false;
+  }
   uint8_t *slotData = data + slot * td.length();
   td.serialize(slotData, t);
   return true;
 }
 
+bool HeapPage::insertSerialized(std::span<const uint8_t> row) {
+  size_t slot = claim();
+  if (slot == capacity) {
+    return false;
+  }
+  std::memcpy(data + slot * td.length(), row.data(), td.length());
+  return true;
+}
+
 void HeapPage::deleteTuple(size_t slot) {
   if (slot >= capacity) {
     throw std::runtime_error("Out of index");
@@ -43,6 +114,9 @@ void HeapPage::deleteTuple(size_t slot) {
     throw std::runtime_error("Slot not occupied");
   }
   header[slot / 8] &= ~(1 << (7 - slot % 8));
+  if (occupied != size_t(-1)) {
+    occupied--;
+  }
 }
 
 Tuple HeapPage::getTuple(size_t slot) const {
@@ -53,9 +127,30 @@ Tuple HeapPage::getTuple(size_t slot) const {
   return td.deserialize(slotData);
 }
 
-void HeapPage::next(size_t &slot) const {
-  while (++slot < capacity && empty(slot))
-    ;
+TupleView HeapPage::getTupleView(size_t slot) const {
+  if (empty(slot)) {
+    throw std::runtime_error("Slot not occupied");
+  }
+  return {td, data + slot * td.length()};
+}
+
+size_t HeapPage::scan(size_t from) const {
+  for (size_t next = from; next < capacity; next = (next / 64 + 1) * 64) {
+    // The slots from next to the end of its word, in the most significant bits
+    if (uint64_t w = word(next / 64) << (next % 64)) {
+      return next + std::countl_zero(w);
+    }
+  }
+  return capacity;
 }
 
-bool HeapPage::empty(size_t slot) const { return !(header[slot / 8] & (1 << (7 - slot % 8))); }
+void HeapPage::decode(std::span<const size_t> slots, DataChunk &chunk) const {
+  std::array<const uint8_t *, 256> rows;
+  for (size_t first = 0; first < slots.size(); first += rows.size()) {
+    size_t n = std::min(rows.size(), slots.size() - first);
+    for (size_t i = 0; i < n; i++) {
+      rows[i] = data + slots[first + i] * td.length();
+    }
+    chunk.append({rows.data(), n});
+  }
+}
@@ -0,0 +1,110 @@
+#include <db/HeapVacuum.hpp>
+#include <stdexcept>
+#include <thread>
+
+using namespace db;
+
+HeapVacuum::HeapVacuum(HeapFile &file, const VacuumOptions &options)
+    : file(file), options(options), source(file.numPages - 1) {
+  if (options.moves_per_step == 0) {
+    throw std::invalid_argument("A vacuum must move at least one tuple per step");
+  }
+  if (file.isMapped()) {
+    throw std::logic_error("Cannot compact a mapped file");
+  }
+  moves.reserve(options.moves_per_step);
+}
+
+bool HeapVacuum::empty(size_t page) const {
+  ReadPageGuard guard = file.fetchRead(page);
+  return file.withPage(*guard, [](const auto &hp) { return hp.begin() == hp.end(); });
+}
+
+std::span<const TupleMove> HeapVacuum::step() {
+  moves.clear();
+  while (!finished && moves.size() < options.moves_per_step) {
+    size_t dest = file.fsm.find();
+    if (dest == FreeSpaceMap::npos) {
+      // Every page is full
+      finished = true;
+      break;
+    }
+    while (source > dest && empty(source)) {
+      source--;
+    }
+    if (dest >= source) {
+      finished = true;
+      break;
+    }
+    // In page order, like scans, so that the latches cannot deadlock
+    WritePageGuard to = file.fetchWrite(dest);
+    WritePageGuard from = file.fetchWrite(source);
+    file.withPage(*to, [&](auto &dp) {
+      file.withPage(*from, [&](auto &sp) {
+        bool full = false;
+        while (moves.size() < options.moves_per_step) {
+          size_t slot = sp.begin();
+          if (slot == sp.end()) {
+            break;
+          }
+          Tuple t = sp.getTuple(slot);
+          // Every page layout inserts into its first empty slot
+          size_t to_slot = 0;
+          while (to_slot < dp.end() && !dp.empty(to_slot)) {
+            to_slot++;
+          }
+          if (!dp.insertTuple(t)) {
+            full = true;
+            break;
+          }
+          sp.deleteTuple(slot);
+          if (file.zones) {
+            file.zones->add(dest, t);
+          }
+          moves.push_back({source, slot, dest, to_slot});
+        }
+        // A destination without room for the next tuple is not offered again, as in HeapFile::insertTuple
+        file.fsm.set(dest, full ? FreeSpaceMap::FULL : file.category(dp));
+        file.fsm.set(source, file.category(sp));
+        if (file.zones) {
+          file.zones->remove(source, sp.size());
+        }
+      });
+    });
+  }
+  return moves;
+}
+
+size_t HeapVacuum::truncate() {
+  size_t pages = file.numPages;
+  size_t end = pages;
+  while (end > 1 && empty(end - 1)) {
+    end--;
+  }
+  for (size_t page = end; page < pages; page++) {
+    // The pages are empty again if the file grows back
+    file.fsm.set(page, FreeSpaceMap::FULL);
+    if (file.zones) {
+      file.zones->remove(page, 0);
+    }
+  }
+  file.truncate(end);
+  source = std::min(source, end - 1);
+  return pages - end;
+}
+
+size_t HeapVacuum::run(const std::function<void(std::span<const TupleMove>)> &on_moves) {
+  while (true) {
+    std::span<const TupleMove> step_moves = step();
+    if (step_moves.empty()) {
+      break;
+    }
+    if (on_moves) {
+      on_moves(step_moves);
+    }
+    if (options.pause.count() > 0) {
+      std::this_thread::sleep_for(options.pause);
+    }
+  }
+  return truncate();
+}
@@ -8,8 +8,6 @@ using namespace db;
 
 IndexPage::IndexPage(Page &page) {
 	header = reinterpret_cast<IndexPageHeader *>(page.data());
-	header->size = 0;
-	header->index_children = false;
 		
 	capacity = (DEFAULT_PAGE_SIZE - sizeof(IndexPageHeader))
 		/ (sizeof(int) + sizeof(size_t)) - 1; // -1 since |children|=|keys|+1
@@ -18,6 +16,8 @@ IndexPage::IndexPage(Page &page) {
 	children = reinterpret_cast<size_t *>(keys + capacity);
 }
 
+IndexPage::IndexPage(const Page &page) : IndexPage(const_cast<Page &>(page)) {}
+
 size_t IndexPage::findInsertPosition(int key) const {
 	size_t l = 0, r = header->size, mid;
 	int mid_key;
@@ -41,17 +41,14 @@ bool IndexPage::insert(int key, size_t child) {
 
 	size_t pos = findInsertPosition(key), i;
 
-	if (pos == header->size) goto insert; // append
-		
-	// make space for new entry
+	// make space for new entry, the child goes to the right of its key
 	for (i=header->size; i>pos; --i) {
 		keys[i] = keys[i-1];
-		children[i] = children[i-1];
+		children[i+1] = children[i];
 	}
 
- insert:
 	keys[pos] = key;
-	children[pos] = child;
+	children[pos+1] = child;
     
 	header->size++;
 
@@ -62,10 +59,14 @@ int IndexPage::split(IndexPage &new_page) {
 	size_t midpt = header->size / 2, i;
 	int split_key = keys[midpt];
 
-	for (i=midpt+1; i < header->size; ++i) // midpt key goes to parent
-		new_page.insert(keys[i], children[i]);
+	new_page.children[0] = children[midpt+1];
+	for (i=midpt+1; i < header->size; ++i) { // midpt key goes to parent
+		new_page.keys[i-midpt-1] = keys[i];
+		new_page.children[i-midpt] = children[i+1];
+	}
 
 	new_page.header->size = header->size - (midpt+1);
+	new_page.header->index_children = header->index_children;
 	header->size = midpt;
 
 	return split_key;
@@ -0,0 +1,316 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <db/IoBackend.hpp>
+#include <functional>
+#include <linux/io_uring.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace db;
+
+namespace {
+/// io_uring refuses registered buffers larger than 1 GB, so larger arenas are registered in slices
+constexpr size_t MAX_REGISTERED_BUFFER = size_t{1} << 30;
+
+void finishRead(const IoRequest &request, ssize_t bytes) {
+  // Pages past the end of the file read as empty
+  std::fill(request.page->begin() + std::max<ssize_t>(bytes, 0), request.page->end(), 0);
+}
+
+unsigned loadAcquire(unsigned *p) { return std::atomic_ref(*p).load(std::memory_order_acquire); }
+
+void storeRelease(unsigned *p, unsigned value) { std::atomic_ref(*p).store(value, std::memory_order_release); }
+
+using Clock = std::chrono::steady_clock;
+
+size_t nanosecondsSince(Clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+} // namespace
+
+size_t db::latencyPercentile(const LatencyHistogram &histogram, double fraction) {
+  size_t total = 0;
+  for (size_t n : histogram) {
+    total += n;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  size_t rank = std::max<size_t>(std::ceil(fraction * total), 1);
+  size_t seen = 0;
+  for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+    seen += histogram[i];
+    if (seen >= rank) {
+      return size_t{2} << i;
+    }
+  }
+  return size_t{2} << (LATENCY_BUCKETS - 1);
+}
+
+void IoBackend::count(bool write, size_t bytes, size_t nanoseconds) {
+  (write ? write_calls : read_calls).fetch_add(1, std::memory_order_relaxed);
+  (write ? bytes_written : bytes_read).fetch_add(bytes, std::memory_order_relaxed);
+  size_t bucket = std::min<size_t>(std::max<int>(std::bit_width(nanoseconds) - 1, 0), LATENCY_BUCKETS - 1);
+  latency[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+IoStats IoBackend::getStats() const {
+  IoStats stats{read_calls, bytes_read, write_calls, bytes_written};
+  for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+    stats.latency[i] = latency[i].load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+void SyncIoBackend::submit(std::span<const IoRequest> requests) {
+  constexpr size_t max_iov = 256;
+  iovec iov[max_iov];
+  for (size_t i = 0; i < requests.size();) {
+    // Requests for consecutive pages of a file in the same direction are done with one preadv or pwritev
+    const IoRequest &request = requests[i];
+    size_t n = 0;
+    do {
+      iov[n] = {requests[i + n].page->data(), DEFAULT_PAGE_SIZE};
+      n++;
+    } while (i + n < requests.size() && n < max_iov && requests[i + n].write == request.write &&
+             requests[i + n].fd == request.fd && requests[i + n].offset == request.offset + n * DEFAULT_PAGE_SIZE);
+    Clock::time_point start = Clock::now();
+    if (request.write) {
+      ssize_t bytes = n == 1 ? pwrite(request.fd, iov[0].iov_base, DEFAULT_PAGE_SIZE, request.offset)
+                             : pwritev(request.fd, iov, n, request.offset);
+      count(true, n * DEFAULT_PAGE_SIZE, nanosecondsSince(start));
+      if (bytes != static_cast<ssize_t>(n * DEFAULT_PAGE_SIZE)) {
+        throw std::runtime_error("pwrite");
+      }
+      i += n;
+      continue;
+    }
+    ssize_t bytes = n == 1 ? pread(request.fd, iov[0].iov_base, DEFAULT_PAGE_SIZE, request.offset)
+                           : preadv(request.fd, iov, n, request.offset);
+    count(false, n * DEFAULT_PAGE_SIZE, nanosecondsSince(start));
+    if (bytes == -1) {
+      throw std::runtime_error("pread");
+    }
+    for (size_t j = 0; j < n; j++) {
+      ssize_t valid = std::min<ssize_t>(bytes, DEFAULT_PAGE_SIZE);
+      finishRead(requests[i + j], valid);
+      bytes -= valid;
+    }
+    i += n;
+  }
+}
+
+IoUringBackend::IoUringBackend(unsigned queue_depth, size_t num_rings) {
+  for (size_t i = 0; i < num_rings; i++) {
+    auto ring = std::make_unique<Ring>();
+    io_uring_params params{};
+    ring->fd = syscall(__NR_io_uring_setup, queue_depth, &params);
+    if (ring->fd < 0) {
+      throw std::runtime_error("io_uring_setup");
+    }
+    // If a step fails, the Ring destructor releases what this ring set up, and rings releases the previous rings
+    Ring &r = *ring;
+    r.entries = params.sq_entries;
+
+    r.sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    r.cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      r.sq_map_size = r.cq_map_size = std::max(r.sq_map_size, r.cq_map_size);
+    }
+    r.sq_map =
+        mmap(nullptr, r.sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r.fd, IORING_OFF_SQ_RING);
+    if (r.sq_map == MAP_FAILED) {
+      r.sq_map = nullptr;
+      throw std::runtime_error("mmap");
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      r.cq_map = r.sq_map;
+    } else {
+      r.cq_map =
+          mmap(nullptr, r.cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r.fd, IORING_OFF_CQ_RING);
+      if (r.cq_map == MAP_FAILED) {
+        r.cq_map = nullptr;
+        throw std::runtime_error("mmap");
+      }
+    }
+    r.sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = mmap(nullptr, r.sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r.fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      throw std::runtime_error("mmap");
+    }
+    r.sqes = static_cast<io_uring_sqe *>(sqes);
+
+    auto *sq = static_cast<char *>(r.sq_map);
+    auto *cq = static_cast<char *>(r.cq_map);
+    r.sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    r.sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    r.sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    r.sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    r.cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    r.cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    r.cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    r.cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    rings.push_back(std::move(ring));
+  }
+}
+
+IoUringBackend::Ring::~Ring() {
+  if (sqes != nullptr) {
+    munmap(sqes, sqes_size);
+  }
+  if (cq_map != nullptr && cq_map != sq_map) {
+    munmap(cq_map, cq_map_size);
+  }
+  if (sq_map != nullptr) {
+    munmap(sq_map, sq_map_size);
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+}
+
+void IoUringBackend::registerBuffers(void *base, size_t bytes) {
+  std::vector<iovec> iovs;
+  for (size_t offset = 0; offset < bytes; offset += MAX_REGISTERED_BUFFER) {
+    iovs.push_back({static_cast<char *>(base) + offset, std::min(bytes - offset, MAX_REGISTERED_BUFFER)});
+  }
+  buffers = static_cast<char *>(base);
+  buffers_size = bytes;
+  for (auto &ring : rings) {
+    std::lock_guard lock(ring->mutex);
+    if (ring->registered) {
+      syscall(__NR_io_uring_register, ring->fd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+    }
+    // Registering pins the memory: without enough RLIMIT_MEMLOCK the ring keeps using unregistered buffers
+    ring->registered =
+        syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, iovs.data(), iovs.size()) == 0;
+  }
+}
+
+void IoUringBackend::submit(std::span<const IoRequest> requests) {
+  if (requests.empty()) {
+    return;
+  }
+  // Take a free ring if there is one, starting from one that depends on the thread so that threads spread out
+  size_t first = std::hash<std::thread::id>()(std::this_thread::get_id()) % rings.size();
+  for (size_t i = 0; i < rings.size(); i++) {
+    Ring &ring = *rings[(first + i) % rings.size()];
+    std::unique_lock lock(ring.mutex, std::try_to_lock);
+    if (lock.owns_lock()) {
+      run(ring, requests);
+      return;
+    }
+  }
+  Ring &ring = *rings[first];
+  std::lock_guard lock(ring.mutex);
+  run(ring, requests);
+}
+
+void IoUringBackend::run(Ring &ring, std::span<const IoRequest> requests) {
+  size_t submitted = 0;
+  size_t completed = 0;
+  const char *error = nullptr;
+  std::vector<Clock::time_point> started(requests.size());
+  // Reap the completions that are already there, and return whether there were any
+  auto reap = [&] {
+    bool reaped = false;
+    while (true) {
+      unsigned cq_head = *ring.cq_head;
+      unsigned cq_tail = loadAcquire(ring.cq_tail);
+      if (cq_head == cq_tail) {
+        return reaped;
+      }
+      for (; cq_head != cq_tail; cq_head++) {
+        const io_uring_cqe &cqe = ring.cqes[cq_head & *ring.cq_mask];
+        const IoRequest &request = requests[cqe.user_data];
+        count(request.write, DEFAULT_PAGE_SIZE, nanosecondsSince(started[cqe.user_data]));
+        if (cqe.res < 0) {
+          error = request.write ? "io_uring write" : "io_uring read";
+        } else if (request.write) {
+          if (cqe.res != DEFAULT_PAGE_SIZE) {
+            error = "io_uring short write";
+          }
+        } else {
+          finishRead(request, cqe.res);
+        }
+        completed++;
+      }
+      storeRelease(ring.cq_head, cq_head);
+      reaped = true;
+    }
+  };
+  while (completed < requests.size()) {
+    // Queue as many requests as the ring has room for
+    unsigned tail = *ring.sq_tail;
+    unsigned head = loadAcquire(ring.sq_head);
+    unsigned to_submit = 0;
+    while (submitted < requests.size() && tail - head < ring.entries && submitted - completed < ring.entries) {
+      const IoRequest &request = requests[submitted];
+      unsigned index = tail & *ring.sq_mask;
+      io_uring_sqe &sqe = ring.sqes[index];
+      std::memset(&sqe, 0, sizeof(sqe));
+      auto *data = reinterpret_cast<char *>(request.page->data());
+      bool fixed = ring.registered && data >= buffers && data < buffers + buffers_size;
+      if (fixed) {
+        sqe.opcode = request.write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+        sqe.buf_index = (data - buffers) / MAX_REGISTERED_BUFFER;
+      } else {
+        sqe.opcode = request.write ? IORING_OP_WRITE : IORING_OP_READ;
+      }
+      sqe.fd = request.fd;
+      sqe.addr = reinterpret_cast<uint64_t>(data);
+      sqe.len = DEFAULT_PAGE_SIZE;
+      sqe.off = request.offset;
+      sqe.user_data = submitted;
+      started[submitted] = Clock::now();
+      ring.sq_array[index] = index;
+      tail++;
+      submitted++;
+      to_submit++;
+    }
+    storeRelease(ring.sq_tail, tail);
+
+    bool reaped = reap();
+    if (completed == requests.size() || (reaped && to_submit == 0)) {
+      continue;
+    }
+    unsigned wait = reaped ? 0 : 1;
+    if (syscall(__NR_io_uring_enter, ring.fd, to_submit, wait, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+        errno != EINTR) {
+      // Take back the entries the kernel has not consumed, and wait for the ones in flight: their completions must
+      // not be matched against the next batch, and their pages must not be read or written after this returns
+      unsigned consumed = loadAcquire(ring.sq_head);
+      submitted -= *ring.sq_tail - consumed;
+      storeRelease(ring.sq_tail, consumed);
+      while (completed < submitted) {
+        if (!reap() && syscall(__NR_io_uring_enter, ring.fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0) {
+          std::this_thread::yield();
+        }
+      }
+      throw std::runtime_error("io_uring_enter");
+    }
+  }
+  if (error != nullptr) {
+    throw std::runtime_error(error);
+  }
+}
+
+std::unique_ptr<IoBackend> db::makeIoBackend(io_backend_t backend, unsigned queue_depth) {
+  if (backend == io_backend_t::IO_URING) {
+    try {
+      return std::make_unique<IoUringBackend>(queue_depth);
+    } catch (const std::runtime_error &) {
+      // io_uring is disabled or not supported: fall back to blocking calls
+    }
+  }
+  return std::make_unique<SyncIoBackend>();
+}
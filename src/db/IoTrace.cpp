@@ -0,0 +1,21 @@
+#include <db/IoTrace.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+IoTrace::IoTrace(size_t capacity) : ring(capacity) {
+  if (capacity == 0) {
+    throw std::invalid_argument("Empty trace");
+  }
+}
+
+void IoTrace::record(size_t page) { ring[count++ % ring.size()] = page; }
+
+std::vector<size_t> IoTrace::get() const {
+  if (count <= ring.size()) {
+    return {ring.begin(), ring.begin() + count};
+  }
+  std::vector<size_t> entries(ring.begin() + count % ring.size(), ring.end());
+  entries.insert(entries.end(), ring.begin(), ring.begin() + count % ring.size());
+  return entries;
+}
@@ -11,3 +11,21 @@ Iterator &Iterator::operator++() {
   file.next(*this);
   return *this;
 }
+
+ViewIterator::ViewIterator(const Iterator &it, const Projection *projection) : it(it), projection(projection) {}
+
+TupleView ViewIterator::operator*() {
+  TupleView view = it.file.getTupleView(it, guard);
+  return projection ? projection->view(view) : view;
+}
+
+ViewIterator &ViewIterator::operator++() {
+  it.file.next(it, guard);
+  return *this;
+}
+
+void ViewIterator::release() { guard.release(); }
+
+ViewIterator TupleViews::begin() const { return ViewIterator(file.begin(), projection); }
+
+ViewIterator TupleViews::end() const { return ViewIterator(file.end(), projection); }
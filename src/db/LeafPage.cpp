@@ -10,42 +10,38 @@ using namespace db;
 LeafPage::LeafPage(Page &page, const TupleDesc &td, size_t key_index)
 	: td(td), key_index(key_index) {
 	header = reinterpret_cast<LeafPageHeader *>(page.data());
-	header->size = 0;
-	header->next_leaf = 0;
 
 	data = page.data() + sizeof(LeafPageHeader); // after header
 	capacity = (DEFAULT_PAGE_SIZE - sizeof(LeafPageHeader)) / td.length();
 }
 
+LeafPage::LeafPage(const Page &page, const TupleDesc &td, size_t key_index)
+	: LeafPage(const_cast<Page &>(page), td, key_index) {}
+
 bool LeafPage::insertTuple(const Tuple &t) {
-	int k1, k2;
-	size_t pos, i;
-	uint8_t *slot_data;
+	td.serialize(place(std::get<int>(t.get_field(key_index))), t);
+	return (header->size == capacity);
+}
 
-	k1 = std::get<int>(t.get_field(key_index));
-	pos = findInsertPosition(k1);
-		
-	slot_data = data + pos * td.length();
+bool LeafPage::insertSerialized(std::span<const uint8_t> row) {
+	int key;
+	std::memcpy(&key, row.data() + td.offset_of(key_index), sizeof(int));
+	std::memcpy(place(key), row.data(), td.length());
+	return (header->size == capacity);
+}
 
-	if (pos == header->size)
-		goto serialize;
-		
-	k2 = std::get<int>(getTuple(pos).get_field(key_index));
-		
-	if (k1 == k2) { // overwrite tuple
-		td.serialize(slot_data, t);
-		goto done;
-	}
+// helper: Find the slot of a key, making room for it unless the key already exists
+uint8_t *LeafPage::place(int key) {
+	size_t pos = findInsertPosition(key);
+	uint8_t *slot_data = data + pos * td.length();
 
-	std::memcpy(slot_data + td.length(), slot_data, // shift tuples
-							td.length() * (header->size - pos));
+	if (pos < header->size && keyAt(pos) == key) // overwrite tuple
+		return slot_data;
 
- serialize:
-	td.serialize(slot_data, t);
+	std::memmove(slot_data + td.length(), slot_data, // shift tuples
+							td.length() * (header->size - pos));
 	header->size++;
-
- done:
-	return (header->size == capacity);
+	return slot_data;
 }
 
 size_t LeafPage::findInsertPosition(int key) const {
@@ -54,7 +50,7 @@ size_t LeafPage::findInsertPosition(int key) const {
 
 	while (l < r) {
 		mid = l + (r-l)/2;
-		mid_key = std::get<int>(getTuple(mid).get_field(key_index));
+		mid_key = keyAt(mid);
 
 		if (key > mid_key)
 			l = mid + 1;  // search in right half
@@ -64,6 +60,13 @@ size_t LeafPage::findInsertPosition(int key) const {
 
 	return l;
 }
+// helper: Read the key of a slot without deserializing the tuple
+int LeafPage::keyAt(size_t slot) const {
+	int key;
+	std::memcpy(&key, data + slot * td.length() + td.offset_of(key_index), sizeof(int));
+	return key;
+}
+
 // helper: Copy a tuple from one slot to another
 void LeafPage::copyTuple(size_t from, size_t to) {
 	uint8_t
@@ -74,18 +77,18 @@ void LeafPage::copyTuple(size_t from, size_t to) {
 }
 
 int LeafPage::split(LeafPage &new_page) {
-	size_t midpt = header->size / 2, i;
+	size_t midpt = header->size / 2;
 
-	for (i=midpt; i < header->size; ++i)
-		new_page.insertTuple(getTuple(i));
+	std::memcpy(new_page.data, data + midpt * td.length(), // move upper half
+							td.length() * (header->size - midpt));
 
 	new_page.header->size = header->size - midpt;
 	header->size = midpt;
 		
-	new_page.header->next_leaf = header->next_leaf; // logic not right here
+	new_page.header->next_leaf = header->next_leaf; // the caller links this page to the new one
 
 	// return 1st key of new page
-	return std::get<int>(new_page.getTuple(0).get_field(key_index));
+	return new_page.keyAt(0);
 }
 
 Tuple LeafPage::getTuple(size_t slot) const {
@@ -97,3 +100,10 @@ Tuple LeafPage::getTuple(size_t slot) const {
 	uint8_t *slot_data = data + slot * td.length();
 	return td.deserialize(slot_data);
 }
+
+TupleView LeafPage::getTupleView(size_t slot) const {
+	if (slot >= header->size) {
+		throw std::runtime_error("Slot out of bounds");
+	}
+	return {td, data + slot * td.length()};
+}
@@ -0,0 +1,46 @@
+#include <db/PageArena.hpp>
+#include <memory>
+#include <stdexcept>
+#include <sys/mman.h>
+
+using namespace db;
+
+namespace {
+constexpr size_t HUGE_PAGE_SIZE = 2 << 20;
+}
+
+PageArena::PageArena(size_t num_pages, bool huge_pages) : num_pages(num_pages) {
+  if (num_pages == 0) {
+    throw std::invalid_argument("Empty arena");
+  }
+  bytes = num_pages * DEFAULT_PAGE_SIZE;
+  size_t alignment = DEFAULT_PAGE_SIZE;
+  if (huge_pages) {
+    alignment = HUGE_PAGE_SIZE;
+    bytes = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+  }
+  // Over-allocate so that the arena can be aligned to a huge page boundary, then trim both ends
+  size_t mapped = bytes + alignment - DEFAULT_PAGE_SIZE;
+  void *addr = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error("mmap");
+  }
+  auto *begin = static_cast<uint8_t *>(addr);
+  auto *aligned = reinterpret_cast<uint8_t *>((reinterpret_cast<uintptr_t>(begin) + alignment - 1) & ~(alignment - 1));
+  if (aligned != begin) {
+    munmap(begin, aligned - begin);
+  }
+  if (size_t tail = begin + mapped - (aligned + bytes); tail > 0) {
+    munmap(aligned + bytes, tail);
+  }
+#ifdef MADV_HUGEPAGE
+  if (huge_pages) {
+    // Only a hint: the kernel may not have transparent huge pages enabled
+    madvise(aligned, bytes, MADV_HUGEPAGE);
+  }
+#endif
+  pages = reinterpret_cast<Page *>(aligned);
+  std::uninitialized_default_construct_n(pages, num_pages);
+}
+
+PageArena::~PageArena() { munmap(pages, bytes); }
@@ -0,0 +1,52 @@
+#include <db/BufferPool.hpp>
+#include <db/PageGuard.hpp>
+#include <utility>
+
+using namespace db;
+
+PageGuard::PageGuard(BufferPool *pool, size_t pos, const PageId &pid, Page *page)
+    : pool(pool), pos(pos), pid(pid), page(page) {}
+
+PageGuard::PageGuard(PageGuard &&other) noexcept
+    : pool(std::exchange(other.pool, nullptr)), pos(other.pos), pid(std::move(other.pid)),
+      page(std::exchange(other.page, nullptr)) {}
+
+PageGuard &PageGuard::operator=(PageGuard &&other) noexcept {
+  pool = std::exchange(other.pool, nullptr);
+  pos = other.pos;
+  pid = std::move(other.pid);
+  page = std::exchange(other.page, nullptr);
+  return *this;
+}
+
+void PageGuard::release(bool exclusive) {
+  if (pool != nullptr) {
+    pool->release(pos, exclusive);
+  }
+  pool = nullptr;
+  page = nullptr;
+}
+
+ReadPageGuard &ReadPageGuard::operator=(ReadPageGuard &&other) noexcept {
+  if (this != &other) {
+    release();
+    PageGuard::operator=(std::move(other));
+  }
+  return *this;
+}
+
+ReadPageGuard::~ReadPageGuard() { release(); }
+
+void ReadPageGuard::release() { PageGuard::release(false); }
+
+WritePageGuard &WritePageGuard::operator=(WritePageGuard &&other) noexcept {
+  if (this != &other) {
+    release();
+    PageGuard::operator=(std::move(other));
+  }
+  return *this;
+}
+
+WritePageGuard::~WritePageGuard() { release(); }
+
+void WritePageGuard::release() { PageGuard::release(true); }
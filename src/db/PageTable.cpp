@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <bit>
+#include <db/PageTable.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+PageTable::PageTable(size_t capacity) : capacity(capacity) {
+  size_t num_slots = std::bit_ceil(std::max<size_t>(2 * capacity, 2));
+  slots.resize(num_slots, {{}, npos});
+  shift = 64 - std::countr_zero(num_slots);
+}
+
+size_t PageTable::home(const PageId &pid) const {
+  // Fibonacci hashing: the high bits of the product depend on every bit of the key
+  return (pid.key() * 0x9e3779b97f4a7c15ULL) >> shift;
+}
+
+size_t PageTable::find(const PageId &pid) const {
+  const size_t mask = slots.size() - 1;
+  for (size_t i = home(pid);; i = (i + 1) & mask) {
+    if (slots[i].pid == pid) {
+      return slots[i].value;
+    }
+    if (slots[i].pid.file == 0) {
+      return npos;
+    }
+  }
+}
+
+bool PageTable::contains(const PageId &pid) const { return find(pid) != npos; }
+
+void PageTable::insert(const PageId &pid, size_t value) {
+  const size_t mask = slots.size() - 1;
+  size_t i = home(pid);
+  for (; slots[i].pid.file != 0; i = (i + 1) & mask) {
+    if (slots[i].pid == pid) {
+      slots[i].value = value;
+      return;
+    }
+  }
+  if (count == capacity) {
+    throw std::length_error("PageTable is full");
+  }
+  slots[i] = {pid, value};
+  count++;
+}
+
+bool PageTable::erase(const PageId &pid) {
+  const size_t mask = slots.size() - 1;
+  size_t i = home(pid);
+  while (slots[i].pid != pid) {
+    if (slots[i].pid.file == 0) {
+      return false;
+    }
+    i = (i + 1) & mask;
+  }
+  // Move back every following entry whose home is not in (i, j], so that no probe sequence crosses an empty slot
+  for (size_t j = (i + 1) & mask; slots[j].pid.file != 0; j = (j + 1) & mask) {
+    size_t h = home(slots[j].pid);
+    if (((j - h) & mask) >= ((j - i) & mask)) {
+      slots[i] = slots[j];
+      i = j;
+    }
+  }
+  slots[i] = {{}, npos};
+  count--;
+  return true;
+}
+
+size_t PageTable::size() const { return count; }
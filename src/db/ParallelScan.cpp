@@ -0,0 +1,86 @@
+#include <db/ParallelScan.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+ParallelScan::ParallelScan(const HeapFile &file, ThreadPool &pool, size_t morsel_pages)
+    : file(file), pool(pool), morsel_pages(morsel_pages), ranges(std::make_unique<Range[]>(pool.size())) {
+  if (morsel_pages == 0) {
+    throw std::invalid_argument("A morsel must have at least one page");
+  }
+}
+
+bool ParallelScan::take(size_t worker, size_t &first, size_t &end) {
+  {
+    Range &own = ranges[worker];
+    std::lock_guard lock(own.mutex);
+    if (own.next < own.end) {
+      first = own.next;
+      end = std::min(first + morsel_pages, own.end);
+      own.next = end;
+      morsels++;
+      return true;
+    }
+  }
+  for (size_t i = 1; i < pool.size(); i++) {
+    Range &victim = ranges[(worker + i) % pool.size()];
+    std::lock_guard lock(victim.mutex);
+    if (victim.next < victim.end) {
+      // From the back, away from the pages the owner is reading
+      end = victim.end;
+      first = end - std::min(morsel_pages, end - victim.next);
+      victim.end = first;
+      morsels++;
+      steals++;
+      return true;
+    }
+  }
+  return false;
+}
+
+ParallelScanStats ParallelScan::run(const std::function<void(size_t worker, size_t first, size_t end)> &scan) {
+  size_t pages = file.getNumPages();
+  size_t workers = pool.size();
+  for (size_t i = 0; i < workers; i++) {
+    ranges[i].next = pages * i / workers;
+    ranges[i].end = pages * (i + 1) / workers;
+  }
+  morsels = 0;
+  steals = 0;
+  pool.run([&](size_t worker) {
+    size_t first;
+    size_t end;
+    while (take(worker, first, end)) {
+      scan(worker, first, end);
+    }
+  });
+  return {morsels, steals};
+}
+
+ParallelScanStats ParallelScan::run(const Projection &projection,
+                                    const std::function<void(size_t worker, const DataChunk &chunk)> &consume) {
+  std::vector<std::unique_ptr<DataChunk>> chunks(pool.size());
+  return run([&](size_t worker, size_t first, size_t end) {
+    if (!chunks[worker]) {
+      chunks[worker] = std::make_unique<DataChunk>(projection);
+    }
+    Iterator it{file, first, 0};
+    while (file.scan(it, *chunks[worker], end)) {
+      consume(worker, *chunks[worker]);
+    }
+  });
+}
+
+ParallelScanStats ParallelScan::run(const Projection &projection, const Filter &filter,
+                                    const std::function<void(size_t worker, const DataChunk &chunk)> &consume) {
+  std::vector<std::unique_ptr<DataChunk>> chunks(pool.size());
+  return run([&](size_t worker, size_t first, size_t end) {
+    if (!chunks[worker]) {
+      chunks[worker] = std::make_unique<DataChunk>(projection);
+    }
+    Iterator it{file, first, 0};
+    while (file.scan(it, *chunks[worker], filter, end)) {
+      consume(worker, *chunks[worker]);
+    }
+  });
+}
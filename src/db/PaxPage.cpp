@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <cstring>
+#include <db/PaxPage.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+PaxPage::PaxPage(Page &page, const TupleDesc &td) : HeapPage(page, td) {
+  if (td.variable_length()) {
+    throw std::invalid_argument("PAX pages do not support VARCHAR fields");
+  }
+}
+
+PaxPage::PaxPage(const Page &page, const TupleDesc &td) : PaxPage(const_cast<Page &>(page), td) {}
+
+bool PaxPage::insertTuple(const Tuple &t) {
+  size_t slot = claim();
+  if (slot == capacity) {
+    return false;
+  }
+  td.serialize(data, capacity, slot, t);
+  return true;
+}
+
+bool PaxPage::insertSerialized(std::span<const uint8_t> row) {
+  size_t slot = claim();
+  if (slot == capacity) {
+    return false;
+  }
+  for (size_t i = 0; i < td.size(); i++) {
+    size_t size = size_of(td.type_of(i));
+    std::memcpy(data + td.offset_of(i) * capacity + slot * size, row.data() + td.offset_of(i), size);
+  }
+  return true;
+}
+
+Tuple PaxPage::getTuple(size_t slot) const {
+  if (empty(slot)) {
+    throw std::runtime_error("Slot not occupied");
+  }
+  return td.deserialize(data, capacity, slot);
+}
+
+TupleView PaxPage::getTupleView(size_t slot) const {
+  if (empty(slot)) {
+    throw std::runtime_error("Slot not occupied");
+  }
+  return {td, data, nullptr, capacity, slot};
+}
+
+uint64_t PaxPage::select(size_t i, const Filter &filter) const {
+  size_t first = i * 64;
+  return filter.selectColumns(data, capacity, first, std::min<size_t>(64, capacity - first), word(i));
+}
+
+void PaxPage::decode(std::span<const size_t> slots, DataChunk &chunk) const { chunk.append(data, capacity, slots); }
@@ -0,0 +1,26 @@
+#include <db/Projection.hpp>
+
+using namespace db;
+
+namespace {
+std::vector<size_t> indexesOf(const TupleDesc &td, const std::vector<std::string> &names) {
+  std::vector<size_t> columns;
+  columns.reserve(names.size());
+  for (const std::string &name : names) {
+    columns.push_back(td.index_of(name));
+  }
+  return columns;
+}
+} // namespace
+
+Projection::Projection(const TupleDesc &source, std::vector<size_t> columns)
+    : td(source.project(columns)), columns(std::move(columns)) {
+  for (size_t column : this->columns) {
+    offsets.push_back(source.offset_of(column));
+  }
+}
+
+Projection::Projection(const TupleDesc &source, const std::vector<std::string> &names)
+    : Projection(source, indexesOf(source, names)) {}
+
+Tuple Projection::project(const uint8_t *row) const { return view(row).materialize(); }
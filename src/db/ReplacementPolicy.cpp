@@ -0,0 +1,299 @@
+#include <algorithm>
+#include <db/ReplacementPolicy.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+LruPolicy::LruPolicy(size_t num_frames) : prev(num_frames, npos), next(num_frames, npos), pinned(num_frames) {}
+
+void LruPolicy::unlink(size_t frame) {
+  (prev[frame] == npos ? head : next[prev[frame]]) = next[frame];
+  (next[frame] == npos ? tail : prev[next[frame]]) = prev[frame];
+  prev[frame] = next[frame] = npos;
+}
+
+void LruPolicy::pushFront(size_t frame) {
+  next[frame] = head;
+  (head == npos ? tail : prev[head]) = frame;
+  head = frame;
+}
+
+void LruPolicy::insert(size_t frame, const PageId &) {
+  pinned[frame] = false;
+  pushFront(frame);
+}
+
+void LruPolicy::access(size_t frame) {
+  if (head != frame) {
+    unlink(frame);
+    pushFront(frame);
+  }
+}
+
+void LruPolicy::erase(size_t frame) { unlink(frame); }
+
+void LruPolicy::setEvictable(size_t frame, bool evictable) { pinned[frame] = !evictable; }
+
+size_t LruPolicy::victim() {
+  for (size_t frame = tail; frame != npos; frame = prev[frame]) {
+    if (!pinned[frame]) {
+      return frame;
+    }
+  }
+  throw std::runtime_error("No frame to evict");
+}
+
+ClockPolicy::ClockPolicy(size_t num_frames) : tracked(num_frames), referenced(num_frames), pinned(num_frames) {}
+
+void ClockPolicy::insert(size_t frame, const PageId &) {
+  tracked[frame] = true;
+  referenced[frame] = true;
+  pinned[frame] = false;
+  size++;
+}
+
+void ClockPolicy::access(size_t frame) { referenced[frame] = true; }
+
+void ClockPolicy::erase(size_t frame) {
+  if (!pinned[frame]) {
+    size--;
+  }
+  tracked[frame] = false;
+  referenced[frame] = false;
+  pinned[frame] = false;
+}
+
+void ClockPolicy::setEvictable(size_t frame, bool evictable) {
+  if (pinned[frame] == evictable) {
+    pinned[frame] = !evictable;
+    evictable ? size++ : size--;
+  }
+}
+
+size_t ClockPolicy::victim() {
+  if (size == 0) {
+    throw std::runtime_error("No frame to evict");
+  }
+  // Two sweeps are enough: the first one clears every reference bit
+  for (;; hand = (hand + 1) % tracked.size()) {
+    if (!tracked[hand] || pinned[hand]) {
+      continue;
+    }
+    if (!referenced[hand]) {
+      return hand;
+    }
+    referenced[hand] = false;
+  }
+}
+
+LruKPolicy::LruKPolicy(size_t num_frames, size_t k)
+    : k(k), history(num_frames * k), accesses(num_frames), heap_pos(num_frames, npos) {
+  if (k == 0) {
+    throw std::invalid_argument("k must be positive");
+  }
+  heap.reserve(num_frames);
+}
+
+bool LruKPolicy::before(size_t a, size_t b) const {
+  // Frames with fewer than k accesses have an infinite backward distance and go first
+  bool a_full = accesses[a] >= k;
+  bool b_full = accesses[b] >= k;
+  if (a_full != b_full) {
+    return !a_full;
+  }
+  size_t i = a_full ? k - 1 : 0;
+  return history[a * k + i] < history[b * k + i];
+}
+
+void LruKPolicy::swap(size_t i, size_t j) {
+  std::swap(heap[i], heap[j]);
+  heap_pos[heap[i]] = i;
+  heap_pos[heap[j]] = j;
+}
+
+void LruKPolicy::siftUp(size_t i) {
+  while (i > 0 && before(heap[i], heap[(i - 1) / 2])) {
+    swap(i, (i - 1) / 2);
+    i = (i - 1) / 2;
+  }
+}
+
+void LruKPolicy::siftDown(size_t i) {
+  while (true) {
+    size_t smallest = i;
+    for (size_t child = 2 * i + 1; child <= 2 * i + 2 && child < heap.size(); child++) {
+      if (before(heap[child], heap[smallest])) {
+        smallest = child;
+      }
+    }
+    if (smallest == i) {
+      return;
+    }
+    swap(i, smallest);
+    i = smallest;
+  }
+}
+
+void LruKPolicy::record(size_t frame) {
+  uint64_t *times = &history[frame * k];
+  if (frame == last_frame) {
+    // Correlated reference: only refresh the most recent access
+    times[0] = ++now;
+    return;
+  }
+  std::copy_backward(times, times + k - 1, times + k);
+  times[0] = ++now;
+  accesses[frame]++;
+  last_frame = frame;
+}
+
+void LruKPolicy::insert(size_t frame, const PageId &) {
+  accesses[frame] = 0;
+  last_frame = npos;
+  record(frame);
+  push(frame);
+}
+
+void LruKPolicy::access(size_t frame) {
+  record(frame);
+  // The key of the frame only grows
+  if (heap_pos[frame] != npos) {
+    siftDown(heap_pos[frame]);
+  }
+}
+
+void LruKPolicy::push(size_t frame) {
+  heap_pos[frame] = heap.size();
+  heap.push_back(frame);
+  siftUp(heap.size() - 1);
+}
+
+void LruKPolicy::pop(size_t frame) {
+  size_t i = heap_pos[frame];
+  swap(i, heap.size() - 1);
+  heap.pop_back();
+  heap_pos[frame] = npos;
+  if (i < heap.size()) {
+    siftDown(i);
+    siftUp(i);
+  }
+}
+
+void LruKPolicy::erase(size_t frame) {
+  if (heap_pos[frame] != npos) {
+    pop(frame);
+  }
+  if (last_frame == frame) {
+    last_frame = npos;
+  }
+}
+
+void LruKPolicy::setEvictable(size_t frame, bool evictable) {
+  if (evictable && heap_pos[frame] == npos) {
+    push(frame);
+  } else if (!evictable && heap_pos[frame] != npos) {
+    pop(frame);
+  }
+}
+
+size_t LruKPolicy::victim() {
+  if (heap.empty()) {
+    throw std::runtime_error("No frame to evict");
+  }
+  return heap.front();
+}
+
+TwoQueuePolicy::TwoQueuePolicy(size_t num_frames)
+    : kin(std::max<size_t>(num_frames / 4, 1)), kout(std::max<size_t>(num_frames / 2, 1)), prev(num_frames, npos),
+      next(num_frames, npos), queue(num_frames, queue_t::NONE), pinned(num_frames), pids(num_frames), ghosts(kout + 1) {}
+
+void TwoQueuePolicy::unlink(List &list, size_t frame) {
+  (prev[frame] == npos ? list.head : next[prev[frame]]) = next[frame];
+  (next[frame] == npos ? list.tail : prev[next[frame]]) = prev[frame];
+  prev[frame] = next[frame] = npos;
+  list.size--;
+}
+
+void TwoQueuePolicy::pushFront(List &list, size_t frame) {
+  next[frame] = list.head;
+  (list.head == npos ? list.tail : prev[list.head]) = frame;
+  list.head = frame;
+  list.size++;
+}
+
+void TwoQueuePolicy::remember(const PageId &pid) {
+  a1out.emplace_back(pid, ++evictions);
+  ghosts.insert(pid, evictions);
+  if (a1out.size() > kout) {
+    // The ghost may have been promoted or remembered again since this entry was queued
+    const auto &[oldest, seq] = a1out.front();
+    if (ghosts.find(oldest) == seq) {
+      ghosts.erase(oldest);
+    }
+    a1out.pop_front();
+  }
+}
+
+void TwoQueuePolicy::insert(size_t frame, const PageId &pid) {
+  pids[frame] = pid;
+  pinned[frame] = false;
+  if (ghosts.erase(pid)) {
+    // The stale a1out entry is skipped when it expires
+    queue[frame] = queue_t::AM;
+    pushFront(am, frame);
+  } else {
+    queue[frame] = queue_t::A1IN;
+    pushFront(a1in, frame);
+  }
+}
+
+void TwoQueuePolicy::access(size_t frame) {
+  // Hits in a1in are correlated references and do not promote the page
+  if (queue[frame] == queue_t::AM && am.head != frame) {
+    unlink(am, frame);
+    pushFront(am, frame);
+  }
+}
+
+void TwoQueuePolicy::erase(size_t frame) {
+  unlink(queue[frame] == queue_t::AM ? am : a1in, frame);
+  queue[frame] = queue_t::NONE;
+}
+
+void TwoQueuePolicy::setEvictable(size_t frame, bool evictable) { pinned[frame] = !evictable; }
+
+size_t TwoQueuePolicy::oldestEvictable(const List &list) const {
+  for (size_t frame = list.tail; frame != npos; frame = prev[frame]) {
+    if (!pinned[frame]) {
+      return frame;
+    }
+  }
+  return npos;
+}
+
+size_t TwoQueuePolicy::victim() {
+  size_t in = oldestEvictable(a1in);
+  size_t m = oldestEvictable(am);
+  if (in != npos && (a1in.size > kin || m == npos)) {
+    remember(pids[in]);
+    return in;
+  }
+  if (m == npos) {
+    throw std::runtime_error("No frame to evict");
+  }
+  return m;
+}
+
+std::unique_ptr<ReplacementPolicy> db::makeReplacementPolicy(replacement_t policy, size_t num_frames) {
+  switch (policy) {
+  case replacement_t::LRU:
+    return std::make_unique<LruPolicy>(num_frames);
+  case replacement_t::CLOCK:
+    return std::make_unique<ClockPolicy>(num_frames);
+  case replacement_t::LRU_K:
+    return std::make_unique<LruKPolicy>(num_frames);
+  case replacement_t::TWO_Q:
+    return std::make_unique<TwoQueuePolicy>(num_frames);
+  }
+  throw std::logic_error("Unknown replacement policy");
+}
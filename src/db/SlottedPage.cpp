@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <db/SlottedPage.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+SlottedPage::SlottedPage(Page &page, const TupleDesc &td) : td(td), page(page.data()) {}
+
+SlottedPage::SlottedPage(const Page &page, const TupleDesc &td) : SlottedPage(const_cast<Page &>(page), td) {}
+
+uint16_t SlottedPage::read(size_t at) const {
+  uint16_t value;
+  std::memcpy(&value, page + at, sizeof(uint16_t));
+  return value;
+}
+
+void SlottedPage::write(size_t at, uint16_t value) { std::memcpy(page + at, &value, sizeof(uint16_t)); }
+
+size_t SlottedPage::dataStart() const {
+  // A zeroed page has no tuples
+  size_t start = read(sizeof(uint16_t));
+  return start == 0 ? DEFAULT_PAGE_SIZE : start;
+}
+
+size_t SlottedPage::begin() const { return scan(0); }
+
+size_t SlottedPage::scan(size_t from) const {
+  size_t slots = numSlots();
+  while (from < slots && empty(from)) {
+    from++;
+  }
+  return std::min(from, slots);
+}
+
+size_t SlottedPage::size() const {
+  size_t occupied = 0;
+  for (size_t slot = 0; slot < numSlots(); slot++) {
+    occupied += !empty(slot);
+  }
+  return occupied;
+}
+
+size_t SlottedPage::freeSpace() const {
+  size_t used = HEADER_SIZE + numSlots() * SLOT_SIZE;
+  bool reusable = false;
+  for (size_t slot = 0; slot < numSlots(); slot++) {
+    used += length(slot);
+    reusable |= empty(slot);
+  }
+  if (!reusable) {
+    used += SLOT_SIZE;
+  }
+  return used < DEFAULT_PAGE_SIZE ? DEFAULT_PAGE_SIZE - used : 0;
+}
+
+size_t SlottedPage::allocate(size_t len) {
+  size_t slots = numSlots();
+  size_t slot = 0;
+  while (slot < slots && !empty(slot)) {
+    slot++;
+  }
+  size_t directory = HEADER_SIZE + (slot == slots ? slots + 1 : slots) * SLOT_SIZE;
+  if (dataStart() < directory + len) {
+    if (freeSpace() < len) {
+      return 0;
+    }
+    compact();
+  }
+  size_t at = dataStart() - len;
+  write(sizeof(uint16_t), at);
+  write(HEADER_SIZE + slot * SLOT_SIZE, at);
+  write(HEADER_SIZE + slot * SLOT_SIZE + sizeof(uint16_t), len);
+  if (slot == slots) {
+    write(0, slots + 1);
+  }
+  return at;
+}
+
+bool SlottedPage::insertTuple(const Tuple &t) {
+  size_t at = allocate(td.length(t));
+  if (at == 0) {
+    return false;
+  }
+  td.serialize(page + at, t);
+  return true;
+}
+
+bool SlottedPage::insertSerialized(std::span<const uint8_t> row) {
+  size_t at = allocate(row.size());
+  if (at == 0) {
+    return false;
+  }
+  std::memcpy(page + at, row.data(), row.size());
+  return true;
+}
+
+void SlottedPage::deleteTuple(size_t slot) {
+  if (slot >= numSlots()) {
+    throw std::runtime_error("Out of index");
+  }
+  if (empty(slot)) {
+    throw std::runtime_error("Slot not occupied");
+  }
+  write(HEADER_SIZE + slot * SLOT_SIZE, 0);
+  write(HEADER_SIZE + slot * SLOT_SIZE + sizeof(uint16_t), 0);
+  size_t slots = numSlots();
+  while (slots > 0 && empty(slots - 1)) {
+    slots--;
+  }
+  write(0, slots);
+  if (slots == 0) {
+    write(sizeof(uint16_t), 0);
+  }
+}
+
+void SlottedPage::compact() {
+  std::vector<size_t> slots;
+  for (size_t slot = 0; slot < numSlots(); slot++) {
+    if (!empty(slot)) {
+      slots.push_back(slot);
+    }
+  }
+  // From the highest tuple down, so that every tuple moves up over space that was already moved
+  std::sort(slots.begin(), slots.end(), [this](size_t a, size_t b) { return offset(a) > offset(b); });
+  size_t end = DEFAULT_PAGE_SIZE;
+  for (size_t slot : slots) {
+    size_t len = length(slot);
+    end -= len;
+    std::memmove(page + end, page + offset(slot), len);
+    write(HEADER_SIZE + slot * SLOT_SIZE, end);
+  }
+  write(sizeof(uint16_t), end == DEFAULT_PAGE_SIZE ? 0 : end);
+}
+
+Tuple SlottedPage::getTuple(size_t slot) const {
+  if (slot >= numSlots() || empty(slot)) {
+    throw std::runtime_error("Slot not occupied");
+  }
+  return td.deserialize(page + offset(slot));
+}
+
+TupleView SlottedPage::getTupleView(size_t slot) const {
+  if (slot >= numSlots() || empty(slot)) {
+    throw std::runtime_error("Slot not occupied");
+  }
+  return {td, page + offset(slot)};
+}
+
+uint64_t SlottedPage::select(size_t i, const Filter &filter) const {
+  uint64_t mask = 0;
+  size_t first = i * 64;
+  size_t last = std::min(first + 64, numSlots());
+  for (size_t slot = first; slot < last; slot++) {
+    if (!empty(slot) && filter.matches(page + offset(slot))) {
+      mask |= uint64_t{1} << (63 - (slot - first));
+    }
+  }
+  return mask;
+}
+
+void SlottedPage::decode(std::span<const size_t> slots, DataChunk &chunk) const {
+  std::array<const uint8_t *, 256> rows;
+  for (size_t first = 0; first < slots.size(); first += rows.size()) {
+    size_t n = std::min(rows.size(), slots.size() - first);
+    for (size_t i = 0; i < n; i++) {
+      rows[i] = page + offset(slots[first + i]);
+    }
+    chunk.append({rows.data(), n});
+  }
+}
@@ -0,0 +1,66 @@
+#include <db/ThreadPool.hpp>
+#include <stdexcept>
+#include <utility>
+
+using namespace db;
+
+ThreadPool::ThreadPool(size_t num_threads) {
+  if (num_threads == 0) {
+    throw std::invalid_argument("A thread pool needs at least one thread");
+  }
+  threads.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back(&ThreadPool::loop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock(mutex);
+    stop = true;
+  }
+  start_cv.notify_all();
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+}
+
+void ThreadPool::loop(size_t worker) {
+  size_t seen = 0;
+  std::unique_lock lock(mutex);
+  while (true) {
+    start_cv.wait(lock, [&] { return stop || generation != seen; });
+    if (stop) {
+      return;
+    }
+    seen = generation;
+    lock.unlock();
+    try {
+      (*task)(worker);
+    } catch (...) {
+      std::lock_guard error_lock(mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+    lock.lock();
+    if (--running == 0) {
+      done_cv.notify_one();
+    }
+  }
+}
+
+void ThreadPool::run(const std::function<void(size_t worker)> &task) {
+  std::lock_guard run_lock(run_mutex);
+  std::unique_lock lock(mutex);
+  this->task = &task;
+  running = threads.size();
+  error = nullptr;
+  generation++;
+  start_cv.notify_all();
+  done_cv.wait(lock, [this] { return running == 0; });
+  this->task = nullptr;
+  if (error) {
+    std::rethrow_exception(std::exchange(error, nullptr));
+  }
+}
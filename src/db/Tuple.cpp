@@ -32,21 +32,13 @@ TupleDesc::TupleDesc(const std::vector<type_t> &types, const std::vector<std::st
   for (size_t i = 0; i < types.size(); i++) {
     offsets.push_back(offset);
     name_to_index[names[i]] = i;
-    switch (types[i]) {
-    case type_t::INT:
-      offset += INT_SIZE;
-      break;
-    case type_t::DOUBLE:
-      offset += DOUBLE_SIZE;
-      break;
-    case type_t::CHAR:
-      offset += CHAR_SIZE;
-      break;
-    }
+    offset += size_of(types[i]);
+    variable |= types[i] == type_t::VARCHAR;
   }
   if (name_to_index.size() != names.size()) {
     throw std::logic_error("Duplicate name");
   }
+  bytes = offset;
 }
 
 bool TupleDesc::compatible(const Tuple &tuple) const {
@@ -55,7 +47,9 @@ bool TupleDesc::compatible(const Tuple &tuple) const {
   }
 
   for (size_t i = 0; i < tuple.size(); i++) {
-    if (tuple.field_type(i) != types[i]) {
+    // A Tuple holds CHAR and VARCHAR values alike as std::string
+    type_t type = types[i] == type_t::VARCHAR ? type_t::CHAR : types[i];
+    if (tuple.field_type(i) != type) {
       return false;
     }
   }
@@ -65,29 +59,30 @@ bool TupleDesc::compatible(const Tuple &tuple) const {
 
 size_t TupleDesc::offset_of(const size_t &index) const { return offsets.at(index); }
 
+type_t TupleDesc::type_of(const size_t &index) const { return types.at(index); }
+
 size_t TupleDesc::index_of(const std::string &name) const { return name_to_index.at(name); }
 
-size_t TupleDesc::length() const {
-  size_t length = 0;
-  for (type_t type : types) {
-    switch (type) {
-    case type_t::INT:
-      length += INT_SIZE;
-      break;
-    case type_t::DOUBLE:
-      length += DOUBLE_SIZE;
-      break;
-    case type_t::CHAR:
-      length += CHAR_SIZE;
-      break;
+size_t TupleDesc::length() const { return bytes; }
+
+size_t TupleDesc::length(const Tuple &t) const {
+  size_t length = bytes;
+  if (variable) {
+    for (size_t i = 0; i < types.size(); i++) {
+      if (types[i] == type_t::VARCHAR) {
+        length += std::get<std::string>(t.get_field(i)).size();
+      }
     }
   }
   return length;
 }
 
+bool TupleDesc::variable_length() const { return variable; }
+
 size_t TupleDesc::size() const { return types.size(); }
 
 Tuple TupleDesc::deserialize(const uint8_t *data) const {
+  const uint8_t *row = data;
   std::vector<field_t> fields;
   fields.reserve(types.size());
   for (const type_t &type : types) {
@@ -104,12 +99,73 @@ Tuple TupleDesc::deserialize(const uint8_t *data) const {
       fields.emplace_back(std::string(reinterpret_cast<const char *>(data)));
       data += CHAR_SIZE;
       break;
+    case type_t::VARCHAR: {
+      uint16_t at, size;
+      std::memcpy(&at, data, sizeof(uint16_t));
+      std::memcpy(&size, data + sizeof(uint16_t), sizeof(uint16_t));
+      fields.emplace_back(std::string(reinterpret_cast<const char *>(row + at), size));
+      data += VARCHAR_SIZE;
+      break;
+    }
     }
   }
   return {fields};
 }
 
+Tuple TupleDesc::deserialize(const uint8_t *minipages, size_t slots, size_t slot) const {
+  std::vector<field_t> fields;
+  fields.reserve(types.size());
+  for (size_t i = 0; i < types.size(); i++) {
+    const uint8_t *field = minipages + offsets[i] * slots + slot * size_of(types[i]);
+    switch (types[i]) {
+    case type_t::INT: {
+      int value;
+      std::memcpy(&value, field, INT_SIZE);
+      fields.emplace_back(value);
+      break;
+    }
+    case type_t::DOUBLE: {
+      double value;
+      std::memcpy(&value, field, DOUBLE_SIZE);
+      fields.emplace_back(value);
+      break;
+    }
+    case type_t::CHAR: {
+      const char *chars = reinterpret_cast<const char *>(field);
+      fields.emplace_back(std::string(chars, strnlen(chars, CHAR_SIZE)));
+      break;
+    }
+    case type_t::VARCHAR:
+      throw std::logic_error("VARCHAR fields are not stored in columns");
+    }
+  }
+  return {fields};
+}
+
+void TupleDesc::serialize(uint8_t *minipages, size_t slots, size_t slot, const Tuple &t) const {
+  for (size_t i = 0; i < types.size(); i++) {
+    uint8_t *field = minipages + offsets[i] * slots + slot * size_of(types[i]);
+    const field_t &value = t.get_field(i);
+    switch (types[i]) {
+    case type_t::INT:
+      std::memcpy(field, &std::get<int>(value), INT_SIZE);
+      break;
+    case type_t::DOUBLE:
+      std::memcpy(field, &std::get<double>(value), DOUBLE_SIZE);
+      break;
+    case type_t::CHAR:
+      strncpy(reinterpret_cast<char *>(field), std::get<std::string>(value).c_str(), CHAR_SIZE);
+      break;
+    case type_t::VARCHAR:
+      throw std::logic_error("VARCHAR fields are not stored in columns");
+    }
+  }
+}
+
 void TupleDesc::serialize(uint8_t *data, const Tuple &t) const {
+  // The characters of the VARCHAR fields follow the fixed-size fields
+  uint16_t tail = bytes;
+  uint8_t *row = data;
   for (size_t i = 0; i < types.size(); i++) {
     const type_t &type = types[i];
     const field_t &field = t.get_field(i);
@@ -126,6 +182,16 @@ void TupleDesc::serialize(uint8_t *data, const Tuple &t) const {
       strncpy(reinterpret_cast<char *>(data), std::get<std::string>(field).c_str(), CHAR_SIZE);
       data += CHAR_SIZE;
       break;
+    case type_t::VARCHAR: {
+      const std::string &value = std::get<std::string>(field);
+      auto size = static_cast<uint16_t>(value.size());
+      std::memcpy(data, &tail, sizeof(uint16_t));
+      std::memcpy(data + sizeof(uint16_t), &size, sizeof(uint16_t));
+      std::memcpy(row + tail, value.data(), size);
+      tail += size;
+      data += VARCHAR_SIZE;
+      break;
+    }
     }
   }
 }
@@ -142,3 +208,17 @@ db::TupleDesc TupleDesc::merge(const TupleDesc &td1, const TupleDesc &td2) {
   }
   return {types, names};
 }
+
+db::TupleDesc TupleDesc::project(std::span<const size_t> columns) const {
+  std::vector<std::string> all(types.size());
+  for (const auto &[name, index] : name_to_index) {
+    all[index] = name;
+  }
+  std::vector<type_t> projected_types;
+  std::vector<std::string> names;
+  for (size_t column : columns) {
+    projected_types.push_back(types.at(column));
+    names.push_back(all[column]);
+  }
+  return {projected_types, names};
+}
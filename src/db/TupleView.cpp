@@ -0,0 +1,68 @@
+#include <cstring>
+#include <db/TupleView.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+size_t TupleView::size() const { return td->size(); }
+
+type_t TupleView::field_type(size_t i) const { return td->type_of(i); }
+
+int TupleView::get_int(size_t i) const {
+  if (td->type_of(i) != type_t::INT) {
+    throw std::logic_error("Field is not an INT");
+  }
+  int value;
+  std::memcpy(&value, field(i), INT_SIZE);
+  return value;
+}
+
+double TupleView::get_double(size_t i) const {
+  if (td->type_of(i) != type_t::DOUBLE) {
+    throw std::logic_error("Field is not a DOUBLE");
+  }
+  double value;
+  std::memcpy(&value, field(i), DOUBLE_SIZE);
+  return value;
+}
+
+std::string_view TupleView::get_string_view(size_t i) const {
+  type_t type = td->type_of(i);
+  if (type == type_t::VARCHAR) {
+    uint16_t at, size;
+    std::memcpy(&at, field(i), sizeof(uint16_t));
+    std::memcpy(&size, field(i) + sizeof(uint16_t), sizeof(uint16_t));
+    return {reinterpret_cast<const char *>(data + at), size};
+  }
+  if (type != type_t::CHAR) {
+    throw std::logic_error("Field is not a CHAR or VARCHAR");
+  }
+  const char *chars = reinterpret_cast<const char *>(field(i));
+  // A string of CHAR_SIZE characters fills the field without a terminating NUL
+  return {chars, strnlen(chars, CHAR_SIZE)};
+}
+
+field_t TupleView::get_field(size_t i) const {
+  switch (td->type_of(i)) {
+  case type_t::INT:
+    return get_int(i);
+  case type_t::DOUBLE:
+    return get_double(i);
+  case type_t::CHAR:
+  case type_t::VARCHAR:
+    return std::string(get_string_view(i));
+  }
+  throw std::logic_error("Unknown field type");
+}
+
+Tuple TupleView::materialize() const {
+  if (offsets == nullptr && slots == 0) {
+    return td->deserialize(data);
+  }
+  std::vector<field_t> fields;
+  fields.reserve(size());
+  for (size_t i = 0; i < size(); i++) {
+    fields.push_back(get_field(i));
+  }
+  return {fields};
+}
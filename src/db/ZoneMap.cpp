@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <db/ZoneMap.hpp>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+constexpr uint32_t MAGIC = 0x5a4d4150;
+
+/// The first bytes of the header page of the map file
+struct Header {
+  uint32_t magic;
+  /// Whether the zones were written after the last change
+  uint32_t clean;
+  uint64_t zone_size;
+  /// The number of zones in the file
+  uint64_t pages;
+};
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+} // namespace
+
+ZoneMap::ZoneMap(const std::string &name, const TupleDesc &td, size_t pages) : file(name, TupleDesc()) {
+  for (size_t i = 0; i < td.size(); i++) {
+    if (td.type_of(i) == type_t::INT || td.type_of(i) == type_t::DOUBLE) {
+      columns.push_back(i);
+      offsets.push_back(td.offset_of(i));
+      ints.push_back(td.type_of(i) == type_t::INT);
+    }
+  }
+  zone_size = 2 * sizeof(uint32_t) + 2 * columns.size() * sizeof(double);
+  if (zone_size > DEFAULT_PAGE_SIZE) {
+    throw std::invalid_argument("Too many fields for a zone map");
+  }
+  zones_per_page = DEFAULT_PAGE_SIZE / zone_size;
+
+  size_t map_pages = std::filesystem::file_size(name) / DEFAULT_PAGE_SIZE;
+  size_t covered = 0;
+  Page page;
+  if (map_pages != 0) {
+    file.readPage(page, 0);
+    Header header;
+    std::memcpy(&header, page.data(), sizeof(Header));
+    if (header.magic == MAGIC && header.clean && header.zone_size == zone_size) {
+      covered = std::min({static_cast<size_t>(header.pages), pages, (map_pages - 1) * zones_per_page});
+      clean_on_disk = true;
+    }
+  }
+  resize(covered, true);
+  size_t width = 2 * columns.size();
+  for (size_t first = 0; first < covered; first += zones_per_page) {
+    file.readPage(page, 1 + first / zones_per_page);
+    for (size_t i = first; i < std::min(first + zones_per_page, covered); i++) {
+      const uint8_t *zone = page.data() + (i - first) * zone_size;
+      uint32_t flag;
+      std::memcpy(&counts[i], zone, sizeof(uint32_t));
+      std::memcpy(&flag, zone + sizeof(uint32_t), sizeof(uint32_t));
+      known[i] = flag != 0;
+      std::memcpy(&bounds[i * width], zone + 2 * sizeof(uint32_t), width * sizeof(double));
+    }
+  }
+  dirty.assign(dirty.size(), false);
+  // The pages the file does not cover may hold anything
+  resize(pages, false);
+}
+
+ZoneMap::~ZoneMap() {
+  try {
+    flush();
+  } catch (const std::runtime_error &) {
+    // The header still marks the map as out of date: it is discarded the next time it is loaded
+  }
+}
+
+void ZoneMap::resize(size_t pages, bool covered) {
+  size_t old = counts.size();
+  if (pages <= old) {
+    return;
+  }
+  counts.resize(pages);
+  known.resize(pages);
+  bounds.resize(2 * columns.size() * pages);
+  dirty.resize((pages + zones_per_page - 1) / zones_per_page);
+  for (size_t i = old; i < pages; i++) {
+    reset(i);
+    known[i] = covered;
+  }
+}
+
+void ZoneMap::reset(size_t page) {
+  counts[page] = 0;
+  known[page] = true;
+  double *zone = &bounds[2 * columns.size() * page];
+  for (size_t c = 0; c < columns.size(); c++) {
+    zone[2 * c] = INF;
+    zone[2 * c + 1] = -INF;
+  }
+  dirty[page / zones_per_page] = true;
+}
+
+void ZoneMap::touch() {
+  if (clean_on_disk) {
+    writeHeader(false);
+    clean_on_disk = false;
+  }
+}
+
+void ZoneMap::writeHeader(bool clean) {
+  Page page{};
+  Header header{.magic = MAGIC, .clean = clean, .zone_size = zone_size, .pages = counts.size()};
+  std::memcpy(page.data(), &header, sizeof(Header));
+  file.writePage(page, 0);
+}
+
+template <typename F> void ZoneMap::widen(size_t page, F &&value) {
+  std::lock_guard lock(mutex);
+  touch();
+  // A page past the end of the map is new, and was empty
+  resize(page + 1, true);
+  if (!known[page]) {
+    return;
+  }
+  counts[page]++;
+  double *zone = &bounds[2 * columns.size() * page];
+  for (size_t c = 0; c < columns.size(); c++) {
+    double v = value(c);
+    if (std::isnan(v)) {
+      // NaN is not ordered: only NE accepts it, and no bounds exclude every value
+      zone[2 * c] = -INF;
+      zone[2 * c + 1] = INF;
+    } else {
+      zone[2 * c] = std::min(zone[2 * c], v);
+      zone[2 * c + 1] = std::max(zone[2 * c + 1], v);
+    }
+  }
+  dirty[page / zones_per_page] = true;
+}
+
+void ZoneMap::add(size_t page, const Tuple &t) {
+  widen(page, [&](size_t c) {
+    const field_t &field = t.get_field(columns[c]);
+    return std::holds_alternative<int>(field) ? std::get<int>(field) : std::get<double>(field);
+  });
+}
+
+void ZoneMap::add(size_t page, const uint8_t *row) {
+  widen(page, [&](size_t c) {
+    if (ints[c]) {
+      int value;
+      std::memcpy(&value, row + offsets[c], INT_SIZE);
+      return static_cast<double>(value);
+    }
+    double value;
+    std::memcpy(&value, row + offsets[c], DOUBLE_SIZE);
+    return value;
+  });
+}
+
+void ZoneMap::remove(size_t page, size_t remaining) {
+  std::lock_guard lock(mutex);
+  touch();
+  resize(page + 1, true);
+  if (remaining == 0) {
+    // The bounds of an empty page are known again, and as narrow as possible
+    reset(page);
+  } else if (known[page]) {
+    counts[page] = remaining;
+    dirty[page / zones_per_page] = true;
+  }
+}
+
+bool ZoneMap::mayMatch(size_t page, const Filter &filter) const {
+  std::lock_guard lock(mutex);
+  stats.pages_checked++;
+  if (page >= counts.size() || !known[page]) {
+    return true;
+  }
+  bool skip = counts[page] == 0;
+  const double *zone = &bounds[2 * columns.size() * page];
+  for (size_t c = 0; c < columns.size() && !skip; c++) {
+    skip = !filter.mayMatch(columns[c], zone[2 * c], zone[2 * c + 1]);
+  }
+  if (skip) {
+    stats.pages_skipped++;
+    stats.bytes_skipped += DEFAULT_PAGE_SIZE;
+  }
+  return !skip;
+}
+
+bool ZoneMap::covers(size_t page) const {
+  std::lock_guard lock(mutex);
+  return page < counts.size() && known[page];
+}
+
+size_t ZoneMap::count(size_t page) const {
+  std::lock_guard lock(mutex);
+  return counts.at(page);
+}
+
+std::pair<double, double> ZoneMap::range(size_t page, size_t column) const {
+  std::lock_guard lock(mutex);
+  auto c = std::find(columns.begin(), columns.end(), column);
+  if (c == columns.end()) {
+    throw std::invalid_argument("Zone maps only cover INT and DOUBLE fields");
+  }
+  size_t at = 2 * (columns.size() * page + (c - columns.begin()));
+  return {bounds.at(at), bounds.at(at + 1)};
+}
+
+ZoneMapStats ZoneMap::getStats() const {
+  std::lock_guard lock(mutex);
+  return stats;
+}
+
+void ZoneMap::flush() {
+  std::lock_guard lock(mutex);
+  if (clean_on_disk) {
+    return;
+  }
+  Page page;
+  size_t width = 2 * columns.size();
+  for (size_t i = 0; i < dirty.size(); i++) {
+    if (!dirty[i]) {
+      continue;
+    }
+    page.fill(0);
+    size_t first = i * zones_per_page;
+    for (size_t j = first; j < std::min(first + zones_per_page, counts.size()); j++) {
+      uint8_t *zone = page.data() + (j - first) * zone_size;
+      uint32_t flag = known[j];
+      std::memcpy(zone, &counts[j], sizeof(uint32_t));
+      std::memcpy(zone + sizeof(uint32_t), &flag, sizeof(uint32_t));
+      std::memcpy(zone + 2 * sizeof(uint32_t), &bounds[j * width], width * sizeof(double));
+    }
+    file.writePage(page, 1 + i);
+    dirty[i] = false;
+  }
+  writeHeader(true);
+  clean_on_disk = true;
+}
@@ -10,12 +10,25 @@ class BTreeFile : public DbFile {
   static constexpr size_t root_id = 0;
   size_t key_index;
 
+  /**
+   * @brief Insert a tuple into the tree, splitting the full nodes along its path
+   * @param key the key of the tuple
+   * @param insert called with the leaf of the key, inserts the tuple and returns true if the leaf is full
+   */
+  template <typename F> void insert(int key, F &&insert);
+
+  /**
+   * @brief Insert a tuple into the subtree of an index page, as insertTupleRecursive
+   */
+  template <typename F> bool insertRecursive(IndexPage &node, int key, F &&insert);
+
 public:
 
   /**
    * @brief Initialize a BTreeFile
    *
    * @param key_index the index of the key in the tuple
+   * @throws std::invalid_argument if the tuples have VARCHAR fields: leaf pages hold fixed-size tuples
    */
   BTreeFile(const std::string &name, const TupleDesc &td, size_t key_index);
 
@@ -28,6 +41,23 @@ public:
    * @param t the tuple to insert
    */
   void insertTuple(const Tuple &t) override;
+
+  /**
+   * @brief Insert a tuple already serialized by the TupleDesc into the file, as insertTuple
+   * @details The bytes are copied to the leaf as they are, without building a Tuple. See StaticTupleDesc.
+   * @param row the bytes of the tuple, as written by TupleDesc::serialize
+   * @throws std::invalid_argument if the length of the row is not the length of the TupleDesc
+   */
+  void insertSerialized(std::span<const uint8_t> row);
+
+  /**
+   * @brief Insert a tuple into the subtree of an index page
+   * @details The pages along the path are held by write guards, so they stay pinned until the split of a child has
+   * been inserted into its parent.
+   * @param node the index page at the root of the subtree
+   * @param t the tuple to insert
+   * @return true if the node is full and needs to be split
+   */
   bool insertTupleRecursive(IndexPage &node, const Tuple &t);
 
   void deleteTuple(const Iterator &it) override;
@@ -40,6 +70,8 @@ public:
    */
   Tuple getTuple(const Iterator &it) const override;
 
+  using DbFile::getTuple;
+
   /**
    * @brief Advance the iterator to the next tuple.
    * @details Advance the iterator to the next tuple by moving to the next slot of the page.
@@ -48,6 +80,14 @@ public:
    */
   void next(Iterator &it) const override;
 
+  TupleView getTupleView(const Iterator &it, ReadPageGuard &guard) const override;
+
+  void next(Iterator &it, ReadPageGuard &guard) const override;
+
+  size_t scan(Iterator &it, DataChunk &chunk) const override;
+
+  using DbFile::scan;
+
   /**
    * @brief Get the iterator to the first tuple of the leftmost leaf (head).
    * @details Traverse the tree to reach the head leaf and return the first tuple.
@@ -57,7 +97,8 @@ public:
 
   /**
    * @brief Get the iterator to the end of the file.
-   * @details Return an iterator that points to the end of the file.
+   * @details Return an iterator that points to the end of the file. The last leaf links to the root page, so the end is
+   * the first slot of the root page.
    * @return The iterator to the end of the file.
    */
   Iterator end() const override;
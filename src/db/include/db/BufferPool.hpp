@@ -1,37 +1,247 @@
 #pragma once
 
+#include <db/IoBackend.hpp>
+#include <db/PageArena.hpp>
+#include <db/PageGuard.hpp>
+#include <db/PageTable.hpp>
+#include <db/ReplacementPolicy.hpp>
 #include <db/types.hpp>
-#include <list>
-#include <unordered_map>
-#include <unordered_set>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
 #include <vector>
 
 namespace db {
 constexpr size_t DEFAULT_NUM_PAGES = 50;
+
+/**
+ * @brief How a BufferPool reads ahead of sequential scans.
+ */
+enum class read_ahead_t {
+  /// Read pages only when they are requested
+  NONE,
+  /// Ask the kernel to read the next pages into its page cache with `posix_fadvise`
+  FADVISE,
+  /// Read the next pages into frames of the pool with batched `preadv` calls on a background thread
+  PREADV,
+};
+
+/**
+ * @brief Configuration of a BufferPool.
+ */
+struct BufferPoolOptions {
+  /// Number of frames in the pool. The memory budget is `num_pages * DEFAULT_PAGE_SIZE`.
+  size_t num_pages = DEFAULT_NUM_PAGES;
+
+  /// Whether to back the frames with transparent huge pages
+  bool huge_pages = false;
+
+  /// Which page to evict when the pool is full
+  replacement_t policy = replacement_t::LRU;
+
+  /// Number of independently locked partitions of the pool. With one shard the policy applies to the whole pool.
+  size_t num_shards = 1;
+
+  /// Whether a background thread writes dirty pages back so that evictions find clean victims
+  bool background_flush = false;
+
+  /// The flusher wakes up when more than this fraction of the frames is dirty
+  double flush_high_watermark = 0.1;
+
+  /// The flusher goes back to sleep once at most this fraction of the frames is dirty
+  double flush_low_watermark = 0.02;
+
+  /// How to read ahead of sequential scans
+  read_ahead_t read_ahead = read_ahead_t::NONE;
+
+  /// Number of pages read ahead of a sequential scan. The pool clamps it to a quarter of the frames of a shard, so that
+  /// the pages being read ahead never take all the frames a scan needs.
+  size_t read_ahead_window = 64;
+
+  /// How pages are read and written. io_uring falls back to blocking calls when the kernel does not support it.
+  io_backend_t io_backend = io_backend_t::SYNC;
+
+  /// Number of requests the I/O backend keeps in flight
+  unsigned io_queue_depth = 64;
+
+  /// Whether flushing a file, and destroying the pool, ends with one `fdatasync` of each file that was written
+  bool sync_on_flush = false;
+
+  /// Whether the files of the Database bypass the kernel page cache with `O_DIRECT`, so that the pool is the only
+  /// cache of their pages. Files on filesystems that refuse the flag keep using the page cache. FADVISE read-ahead
+  /// has no effect on direct files.
+  bool direct_io = false;
+};
+
+/**
+ * @brief Counters describing how well the BufferPool is serving requests.
+ */
+struct BufferPoolStats {
+  /// Number of getPage calls served from memory
+  size_t hits = 0;
+
+  /// Number of getPage calls that had to read the page from disk
+  size_t misses = 0;
+
+  /// Number of pages evicted to make room for another page
+  size_t evictions = 0;
+
+  /// Number of evictions that had to write the dirty victim before reading the requested page
+  size_t sync_writes = 0;
+
+  /// Number of dirty pages written by the background flusher
+  size_t background_writes = 0;
+
+  /// Number of frames holding a dirty page when the snapshot was taken
+  size_t dirty_pages = 0;
+
+  /// Number of pages read into the pool ahead of a scan
+  size_t read_ahead_pages = 0;
+
+  /// Number of read calls handed to the kernel by the I/O backend. Reads of consecutive pages may share a call.
+  size_t read_calls = 0;
+
+  /// Number of bytes read by the I/O backend
+  size_t bytes_read = 0;
+
+  /// Number of write calls handed to the kernel by the I/O backend. Writes of consecutive pages may share a call.
+  size_t write_calls = 0;
+
+  /// Number of bytes written by the I/O backend
+  size_t bytes_written = 0;
+
+  /// Latency of the read and write calls of the I/O backend
+  LatencyHistogram io_latency{};
+};
+
 /**
  * @brief Represents a buffer pool for database pages.
  * @details The BufferPool class is responsible for managing the database pages in memory.
  * It provides functions to get a page, mark a page as dirty, and check the status of pages.
  * The class also supports flushing pages to disk and discarding pages from the buffer pool.
+ * Pages accessed through a ReadPageGuard or WritePageGuard are pinned and are never evicted while the guard is alive.
+ *
+ * The frames are partitioned into shards. A page always maps to the same shard, and each shard has its own lock, page
+ * table, free list and replacement policy, so threads working on different shards do not contend. Every frame also has
+ * a reader/writer latch: a ReadPageGuard holds it shared and a WritePageGuard holds it exclusively.
+ *
+ * With `background_flush`, a flusher thread sweeps the frames and writes dirty pages back whenever more than the high
+ * watermark of the frames is dirty, until the low watermark is reached. It skips pages that are being written, so
+ * a foreground miss rarely has to write its victim first.
+ *
+ * With `read_ahead`, the pool tracks the pages each file is read at. Once a file is read sequentially, the next
+ * `read_ahead_window` pages are requested ahead of the scan, either from the kernel or into frames of the pool. Pages
+ * read ahead into the pool are only added to its page table once their data is in, so guards never see them half read.
+ *
+ * All I/O goes through an IoBackend. Flushing a file, the flusher and read-ahead hand whole batches of pages to it, so
+ * with io_uring many requests are in flight at once. The frames are registered with the backend once. Batches of
+ * writes are sorted by file and page number, so that runs of dirty pages that are contiguous on disk are written
+ * in order and the sync backend merges them into one `pwritev`.
  * @note A BufferPool owns the Page objects that are stored in it.
+ * @note getPage returns an unpinned and unlatched page and is only safe when a single thread uses the pool and
+ * `read_ahead` is not PREADV.
  */
 class BufferPool {
-  std::array<Page, DEFAULT_NUM_PAGES> pages;
-  std::array<PageId, DEFAULT_NUM_PAGES> pos_to_pid;
-  std::unordered_map<const PageId, size_t> pid_to_pos;
-  std::unordered_set<size_t> dirty;
-  std::vector<size_t> available;
-  std::list<size_t> lru_list;
-  std::unordered_map<size_t, std::list<size_t>::iterator> pos_to_lru;
+  struct Shard {
+    mutable std::mutex mutex;
+    PageTable pid_to_pos;
+    std::vector<size_t> available;
+    /// The policy sees the frames of the shard as `[0, end - begin)`
+    std::unique_ptr<ReplacementPolicy> policy;
+    size_t begin = 0;
+    size_t end = 0;
+    BufferPoolStats stats;
+  };
+
+  const BufferPoolOptions options;
+  PageArena pages;
+  std::unique_ptr<IoBackend> io;
+  std::vector<PageId> pos_to_pid;
+  std::unique_ptr<std::atomic<bool>[]> dirty;
+  std::vector<uint32_t> pins;
+  std::unique_ptr<std::shared_mutex[]> latches;
+  std::unique_ptr<Shard[]> shards;
+
+  std::atomic<size_t> num_dirty = 0;
+  std::atomic<size_t> background_writes = 0;
+  size_t high_watermark;
+  size_t low_watermark;
+  std::mutex flusher_mutex;
+  std::condition_variable flusher_cv;
+  bool stop_flusher = false;
+  std::thread flusher;
+
+  /// Where a file was last read, to detect sequential scans
+  struct Stream {
+    size_t last = -1;
+    size_t run = 0;
+    size_t until = 0;
+  };
+
+  std::mutex read_ahead_mutex;
+  std::condition_variable read_ahead_cv;
+  std::vector<Stream> streams;
+  std::condition_variable read_ahead_done;
+  std::deque<std::pair<PageId, size_t>> read_ahead_queue;
+  file_id_t loading = 0;
+  bool stop_read_ahead = false;
+  std::thread read_ahead_thread;
+  std::atomic<size_t> read_ahead_pages = 0;
+
+  friend class PageGuard;
+
+  Shard &shardOf(const PageId &pid) const;
+
+  Shard &shardOfFrame(size_t pos) const;
+
+  void setDirty(size_t pos);
+
+  bool clearDirty(size_t pos);
+
+  void flushLoop();
+
+  size_t fetch(Shard &shard, const PageId &pid);
+
+  size_t allocate(Shard &shard, const PageId &pid);
+
+  size_t claim(Shard &shard);
+
+  void track(Shard &shard, const PageId &pid, size_t pos);
+
+  size_t frameOf(const Shard &shard, const PageId &pid) const;
+
+  IoRequest request(size_t pos, bool write) const;
+
+  void writeBack(size_t pos);
+
+  size_t writeBatch(std::span<const size_t> candidates);
+
+  void release(size_t pos, bool exclusive);
+
+  void unpin(size_t pos);
+
+  void readAhead(const PageId &pid);
+
+  void readAheadLoop();
+
+  void load(const PageId &first, size_t count);
 
 public:
   /**
-   * @brief: Constructs a BufferPool object with the default number of pages.
+   * @brief: Constructs a BufferPool object with the specified number of pages.
+   * @param options: The size of the pool and how its memory is allocated.
+   * @throws std::invalid_argument if the pool would have no pages, a shard would have no pages or the flush
+   * watermarks are not `0 <= low <= high <= 1`.
+   * @throws std::runtime_error if the memory for the pages cannot be mapped.
    */
-  explicit BufferPool();
+  explicit BufferPool(const BufferPoolOptions &options = {});
 
   /**
-   * @brief: Destructs a BufferPool object after flushing all dirty pages to disk.
+   * @brief: Destructs a BufferPool object after stopping its threads and flushing all dirty pages to disk.
+   * @details Every file with dirty pages is flushed with flushFile.
    */
   ~BufferPool();
 
@@ -47,10 +257,38 @@ public:
    * @brief: Returns the page with the specified page id.
    * @param pid: The page id of the page to return.
    * @return: The page with the specified page id.
-   * @note This method should make this page the most recently used page.
+   * @note This method reports the access to the replacement policy.
+   * @note The page is not pinned: the reference is invalidated when the page is evicted by a later call.
+   * @throws std::runtime_error if the page is not in the pool and every page is pinned, or if writing back the
+   * evicted page fails. The evicted page then stays in the pool, dirty.
    */
   Page &getPage(const PageId &pid);
 
+  /**
+   * @brief: Pins the page with the specified page id and latches it for reading.
+   * @param pid: The page id of the page to return.
+   * @return: A guard that unlatches and unpins the page when it is destroyed.
+   * @throws std::runtime_error if the page is not in the pool and every page is pinned, or if writing back the
+   * evicted page fails. The evicted page then stays in the pool, dirty.
+   */
+  ReadPageGuard fetchRead(const PageId &pid);
+
+  /**
+   * @brief: Pins the page with the specified page id and latches it exclusively for writing.
+   * @param pid: The page id of the page to return.
+   * @return: A guard that marks the page dirty, unlatches and unpins it when it is destroyed.
+   * @throws std::runtime_error if the page is not in the pool and every page is pinned, or if writing back the
+   * evicted page fails. The evicted page then stays in the pool, dirty.
+   */
+  WritePageGuard fetchWrite(const PageId &pid);
+
+  /**
+   * @brief: Returns whether the page with the specified page id is pinned by a guard.
+   * @param pid: The page id of the page to check.
+   * @return: True if at least one guard holds the page, false otherwise.
+   */
+  bool isPinned(const PageId &pid) const;
+
   /**
    * @brief: Marks the page with the specified page id as dirty.
    * @param pid: The page id of the page to mark as dirty.
@@ -75,21 +313,56 @@ public:
    * @brief: Discards the page with the specified page id from the buffer pool.
    * @param pid: The page id of the page to discard.
    * @note This method does NOT flush the page to disk.
-   * @note This method also updates the LRU and dirty pages to exclude tracking this page.
+   * @throws std::logic_error if the page is pinned.
+   * @note This method also updates the replacement policy and dirty pages to exclude tracking this page.
    */
   void discardPage(const PageId &pid);
 
+  /**
+   * @brief: Discards the pages of a file from the specified page on, without writing them, so the file can be shrunk.
+   * @param file: The id of the associated file.
+   * @param first: The first page to discard.
+   * @note Pending read-ahead of the file is cancelled first and an in-flight load of the file is waited for. Pages
+   * pinned by the background flusher or by another thread are waited for, so the caller must not hold a guard on them.
+   * @note The dirty flags of the discarded pages are cleared.
+   */
+  void discardPages(file_id_t file, size_t first);
+
   /**
    * @brief: Flushes the page with the specified page id to disk.
    * @param pid: The page id of the page to flush.
    * @note This method should remove the page from dirty pages.
+   * @note The page is latched for reading while it is written, so the caller must not hold a write guard on it.
+   * @throws std::runtime_error if the write fails. The page stays dirty.
    */
   void flushPage(const PageId &pid);
   /**
    * @brief: Flushes all dirty pages in the specified file to disk.
-   * @param file: The name of the associated file.
+   * @param file: The id of the associated file.
    * @note This method should call BufferPool::flushPage(pid).
+   * @note Pending read-ahead of the file is cancelled first, so no read of the file is in flight when this returns.
+   * @note The pages are written in page order. With `sync_on_flush`, the file is synced once at the end.
+   * @throws std::runtime_error if a write or the sync fails.
+   */
+  void flushFile(file_id_t file);
+
+  /**
+   * @brief: Flushes all dirty pages in the file with the specified name to disk.
+   * @param file: The name of the associated file.
+   * @throws std::out_of_range if no file with that name is in the Database.
    */
   void flushFile(const std::string &file);
+
+  /**
+   * @brief: Returns the number of pages the buffer pool can hold.
+   */
+  size_t size() const;
+
+  const BufferPoolOptions &getOptions() const;
+
+  /**
+   * @brief: Returns a snapshot of the counters of all shards.
+   */
+  BufferPoolStats getStats() const;
 };
 } // namespace db
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <db/Projection.hpp>
+#include <span>
+#include <string_view>
+
+namespace db {
+/**
+ * @brief A batch of up to a fixed number of rows of a file, stored column by column.
+ * @details Each INT and DOUBLE column is a contiguous array, so that code consuming a chunk can run tight loops over
+ * the values of a column. Each CHAR and VARCHAR column is an array of string views into a buffer owned by the chunk,
+ * so the values stay valid after the pages they were read from are unpinned. All memory is allocated when the chunk
+ * is constructed and reused by every batch, except for the characters of VARCHAR values, whose buffer grows to fit
+ * the longest batch.
+ *
+ * A chunk built from a Projection only holds, and decodes, the selected fields of the rows it is given.
+ */
+class DataChunk {
+  using column_t = std::variant<std::vector<int>, std::vector<double>, std::vector<std::string_view>>;
+
+  const TupleDesc &td;
+  /// The offset of each column in the serialized rows
+  std::vector<size_t> offsets;
+  size_t capacity;
+  size_t count = 0;
+  std::vector<column_t> columns;
+  /// The characters of the CHAR columns, `CHAR_SIZE` bytes per value
+  std::vector<char> chars;
+  /// The characters of the VARCHAR columns, one value after the other
+  std::vector<char> varchars;
+  /// The number of bytes of varchars in use
+  size_t used = 0;
+
+  /**
+   * @brief Make room in varchars for the VARCHAR values of rows about to be appended.
+   * @details The buffer grows geometrically, so a chunk reused for many batches soon stops allocating.
+   */
+  void reserveVarchars(std::span<const uint8_t *const> rows);
+
+public:
+  /**
+   * @brief Allocate a chunk for rows of the specified TupleDesc.
+   * @param td The tuple descriptor of the rows.
+   * @param capacity The maximum number of rows of the chunk.
+   * @throws std::invalid_argument if capacity is 0.
+   */
+  explicit DataChunk(const TupleDesc &td, size_t capacity = 2048);
+
+  /**
+   * @brief Allocate a chunk for the selected fields of rows.
+   * @param projection The fields to decode. It must outlive the chunk.
+   * @param capacity The maximum number of rows of the chunk.
+   * @throws std::invalid_argument if capacity is 0.
+   */
+  explicit DataChunk(const Projection &projection, size_t capacity = 2048);
+
+  DataChunk(const DataChunk &) = delete;
+
+  DataChunk &operator=(const DataChunk &) = delete;
+
+  /**
+   * @brief Get the TupleDesc of the columns of the chunk.
+   */
+  const TupleDesc &getTupleDesc() const { return td; }
+
+  /**
+   * @brief Get the number of rows in the chunk.
+   */
+  size_t size() const { return count; }
+
+  size_t getCapacity() const { return capacity; }
+
+  bool full() const { return count == capacity; }
+
+  /**
+   * @brief Remove all the rows. The string views of the previous rows become invalid.
+   */
+  void clear() {
+    count = 0;
+    used = 0;
+  }
+
+  /**
+   * @brief Decode serialized rows and add them to the chunk, one column at a time.
+   * @param rows The first byte of each row, laid out as described by the TupleDesc, or by the source TupleDesc of the
+   * Projection of the chunk.
+   * @throws std::length_error if the rows do not fit in the chunk.
+   */
+  void append(std::span<const uint8_t *const> rows);
+
+  /**
+   * @brief Decode some slots of a PaxPage and add them to the chunk, one column at a time.
+   * @details The values of a column are copied with a single memcpy when the slots are consecutive.
+   * @param minipages The first byte of the minipages: the field at offset `o` of a row starts the minipage at
+   * `minipages + o * page_slots`.
+   * @param page_slots The number of slots of the page.
+   * @param slots The slots, in increasing order.
+   * @throws std::length_error if the rows do not fit in the chunk.
+   * @throws std::logic_error if a column is a VARCHAR, which PaxPages do not store.
+   */
+  void append(const uint8_t *minipages, size_t page_slots, std::span<const size_t> slots);
+
+  /**
+   * @brief Get the values of an INT column.
+   * @throws std::bad_variant_access if the column is not an INT.
+   */
+  std::span<const int> ints(size_t column) const;
+
+  /**
+   * @brief Get the values of a DOUBLE column.
+   * @throws std::bad_variant_access if the column is not a DOUBLE.
+   */
+  std::span<const double> doubles(size_t column) const;
+
+  /**
+   * @brief Get the values of a CHAR or VARCHAR column, valid until the chunk is cleared or rows are appended.
+   * @throws std::bad_variant_access if the column is not a CHAR or a VARCHAR.
+   */
+  std::span<const std::string_view> strings(size_t column) const;
+
+  /**
+   * @brief Copy a row out of the chunk.
+   * @param row The index of the row in the chunk.
+   * @return The row as a Tuple.
+   */
+  Tuple getTuple(size_t row) const;
+};
+} // namespace db
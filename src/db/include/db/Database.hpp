@@ -15,9 +15,16 @@ namespace db {
 class Database {
   std::unordered_map<std::string, std::unique_ptr<DbFile>> files;
 
-  BufferPool bufferPool;
+  /// The files indexed by id. Ids are not reused: the slot of a removed file stays null.
+  std::vector<DbFile *> ids;
 
-  Database() = default;
+  std::unique_ptr<BufferPool> bufferPool;
+
+  /**
+   * @brief Creates the database with a buffer pool of `DEFAULT_NUM_PAGES` frames.
+   * @note The number of frames can be overridden with the `DB_NUM_PAGES` environment variable.
+   */
+  Database();
 
 public:
   friend Database &getDatabase();
@@ -34,10 +41,23 @@ public:
   BufferPool &getBufferPool();
 
   /**
-   * @brief Adds a new file to the Database.
+   * @brief Replaces the buffer pool with a new one built from the specified options.
+   * @param options The configuration of the new buffer pool.
+   * @throws std::invalid_argument if the new pool would have no pages, or if the BufferPool rejects the options.
+   * @throws std::runtime_error if the memory of the new pool cannot be allocated.
+   * @note The dirty pages of the current buffer pool are flushed first. If the new pool cannot be built, the current
+   * one is kept.
+   * @note Direct I/O is turned on or off for every file according to `options.direct_io`.
+   * @note References to pages or to the previous BufferPool are invalidated.
+   */
+  void configureBufferPool(const BufferPoolOptions &options);
+
+  /**
+   * @brief Adds a new file to the Database and assigns it the next file id.
    * @param file The file to add.
    * @throws std::logic_error if the file name already exists.
    * @note This method takes ownership of the DbFile.
+   * @note The file uses direct I/O if the buffer pool was configured with `direct_io`.
    */
   void add(std::unique_ptr<DbFile> file);
 
@@ -58,6 +78,14 @@ public:
    * @throws std::logic_error if the name does not exist.
    */
   DbFile &get(const std::string &name) const;
+
+  /**
+   * @brief Returns the DbFile of the specified id.
+   * @param id The id assigned to the file by Database::add.
+   * @return The DbFile object.
+   * @throws std::out_of_range if no file has this id.
+   */
+  DbFile &get(file_id_t id) const;
 };
 
 /**
@@ -1,10 +1,34 @@
 #pragma once
 
+#include <db/DataChunk.hpp>
+#include <db/Filter.hpp>
+#include <db/IoBackend.hpp>
+#include <db/IoTrace.hpp>
 #include <db/Iterator.hpp>
+#include <db/PageGuard.hpp>
+#include <atomic>
 #include <db/types.hpp>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace db {
+/**
+ * @brief Counters of the pages a DbFile read and wrote.
+ */
+struct DbFileStats {
+  size_t pages_read = 0;
+
+  size_t bytes_read = 0;
+
+  size_t pages_written = 0;
+
+  size_t bytes_written = 0;
+
+  /// Latency of the reads and writes the file ran itself, with readPage() and writePage(). The I/O of the BufferPool
+  /// is in BufferPoolStats::io_latency.
+  LatencyHistogram latency{};
+};
 
 /**
  * @brief Represents a database file.
@@ -13,15 +37,61 @@ namespace db {
  * @note A `DbFile` object owns the `TupleDesc` object that describes the schema of the tuples in the file.
  */
 class DbFile {
-  mutable std::vector<size_t> reads;
-  mutable std::vector<size_t> writes;
+  mutable std::atomic<size_t> pages_read = 0;
+  mutable std::atomic<size_t> pages_written = 0;
+  std::atomic<bool> tracing = false;
+  mutable std::mutex trace_mutex;
+  std::unique_ptr<IoTrace> read_trace;
+  std::unique_ptr<IoTrace> write_trace;
+  mutable SyncIoBackend io;
 
   int fd;
+  std::atomic<bool> direct = false;
+  bool mapped = false;
+  const Page *mapping = nullptr;
+  size_t mapped_pages = 0;
+
+  friend class Database;
 
 protected:
+  /// Assigned by Database::add, 0 until the file is added
+  file_id_t id = 0;
   const std::string name;
   const TupleDesc td;
-  size_t numPages;
+  std::atomic<size_t> numPages;
+
+  /**
+   * @brief Pin a page of the file for reading.
+   * @param page The page number.
+   * @return A guard on the page in the BufferPool, or on the page in the mapping if the file is mapped. A guard on
+   * the mapping does not pin a frame.
+   */
+  ReadPageGuard fetchRead(size_t page) const;
+
+  /**
+   * @brief Pin a page of the file in the BufferPool for writing.
+   * @param page The page number.
+   * @return A guard on the page.
+   * @throws std::logic_error if the file is mapped.
+   */
+  WritePageGuard fetchWrite(size_t page);
+
+  /**
+   * @brief Keep a guard on a page of the file, pinning the page unless the guard already holds it.
+   * @param page The page number.
+   * @param guard The guard, replaced by a guard on the page if it holds another one.
+   */
+  void fetchRead(size_t page, ReadPageGuard &guard) const;
+
+  /**
+   * @brief Shrink the file to its first pages, dropping the frames of the other pages from the BufferPool unwritten.
+   * @param pages The number of pages to keep, at least 1.
+   * @details The frames are dropped with BufferPool::discardPages() before the file shrinks, waiting for the pages
+   * the background flusher is writing. The caller must not hold a guard on a dropped page.
+   * @throws std::logic_error if the file is mapped.
+   * @throws std::runtime_error if the file cannot be truncated.
+   */
+  void truncate(size_t pages);
 
 public:
   /**
@@ -41,33 +111,173 @@ public:
 
   const std::string &getName() const;
 
-  const std::vector<size_t> &getReads() const;
+  file_id_t getId() const;
+
+  /**
+   * @brief Start keeping the page numbers of the last reads and writes of the file, in order, or stop.
+   * @param capacity The number of reads, and of writes, kept. 0 stops tracing.
+   * @note Starting a trace drops the previous one.
+   */
+  void setTrace(size_t capacity);
+
+  /**
+   * @brief Returns the page numbers of the last reads kept by the trace, oldest first.
+   * @return The reads, or nothing if tracing is off.
+   */
+  std::vector<size_t> getReads() const;
+
+  /**
+   * @brief Returns the page numbers of the last writes kept by the trace, oldest first.
+   * @return The writes, or nothing if tracing is off.
+   */
+  std::vector<size_t> getWrites() const;
+
+  /**
+   * @brief Returns a snapshot of the I/O counters of the file. They are kept whether or not tracing is on.
+   */
+  DbFileStats getStats() const;
+
+  /**
+   * @brief Map the file read-only, so that reads of its tuples are served from the mapping instead of the BufferPool.
+   * @details Scans then skip the copy into a frame and the bookkeeping of the pool. The pages of the file that are
+   * dirty in the pool are flushed first.
+   * @param sequential Whether to advise the kernel that the mapping is read sequentially (`MADV_SEQUENTIAL`) rather
+   * than at random (`MADV_RANDOM`). In both cases the kernel is asked to start reading the file (`MADV_WILLNEED`).
+   * @throws std::runtime_error if the file cannot be mapped.
+   * @note The file cannot be modified while it is mapped. The mapping covers the pages of the file when it is mapped;
+   * mapping or unmapping must not run concurrently with reads of the file.
+   */
+  void map(bool sequential = true);
+
+  /**
+   * @brief Unmap the file: reads go through the BufferPool again.
+   */
+  void unmap();
+
+  bool isMapped() const;
 
-  const std::vector<size_t> &getWrites() const;
+  /**
+   * @brief Turn direct I/O (`O_DIRECT`) on or off, so that reads and writes bypass the kernel page cache.
+   * @param enable Whether to use direct I/O.
+   * @return Whether direct I/O is now in use. It stays off when the filesystem refuses `O_DIRECT`.
+   * @note With direct I/O, requests built by readRequest and writeRequest need pages aligned to `DEFAULT_PAGE_SIZE`,
+   * like the frames of a BufferPool. readPage and writePage accept any page.
+   */
+  bool setDirectIo(bool enable);
+
+  bool isDirectIo() const;
 
   /**
    * @brief Read a page from the file.
    * @param page The page to read into.
    * @param id The page number of the page to be read. It determines the offset within the file.
+   * @note The part of the page past the end of the file is zero-filled.
+   * @throws std::runtime_error if the read fails.
    */
   void readPage(Page &page, size_t id) const;
 
+  /**
+   * @brief Build a request that reads a page of the file, to be run by an IoBackend.
+   * @param page The page to read into.
+   * @param id The page number of the page to be read.
+   * @return The request.
+   * @note The read is counted, and traced, when the request is built.
+   */
+  IoRequest readRequest(Page &page, size_t id) const;
+
+  /**
+   * @brief Build a request that writes a page of the file, to be run by an IoBackend.
+   * @param page The page to write. It must not change until the request is complete.
+   * @param id The page number of the page to be written.
+   * @return The request.
+   * @note The write is counted, and traced, when the request is built.
+   */
+  IoRequest writeRequest(const Page &page, size_t id) const;
+
+  /**
+   * @brief Ask the kernel to start reading pages into the page cache without waiting for them.
+   * @param first The page number of the first page.
+   * @param count The number of pages.
+   */
+  void prefetch(size_t first, size_t count) const;
+
   /**
    * @brief Write a page to the file.
    * @param page The page to write.
    * @param id The page number of the page to which the data will be written.
    * It determines the offset in the file.
+   * @throws std::runtime_error if the write fails.
    */
   void writePage(const Page &page, size_t id) const;
 
+  /**
+   * @brief Wait until the pages written to the file are on stable storage, with `fdatasync`.
+   * @throws std::runtime_error if the sync fails.
+   */
+  void sync() const;
+
   virtual void insertTuple(const Tuple &t);
 
   virtual void deleteTuple(const Iterator &it);
 
   virtual Tuple getTuple(const Iterator &it) const;
 
+  /**
+   * @brief Get some fields of a tuple of the file, without decoding the others.
+   * @param it The iterator that identifies the tuple.
+   * @param projection The fields to get.
+   * @return The projected tuple.
+   */
+  Tuple getTuple(const Iterator &it, const Projection &projection) const;
+
   virtual void next(Iterator &it) const;
 
+  /**
+   * @brief View a tuple of the file in place, without deserializing it.
+   * @param it The iterator that identifies the tuple.
+   * @param guard Keeps the page of the tuple pinned. It is reused if it already holds that page.
+   * @return A view of the tuple, valid while guard holds the page.
+   */
+  virtual TupleView getTupleView(const Iterator &it, ReadPageGuard &guard) const;
+
+  /**
+   * @brief Advance the iterator to the next tuple, reusing the page held by guard.
+   * @details guard is left on the page of the next tuple, and released at the end of the file.
+   */
+  virtual void next(Iterator &it, ReadPageGuard &guard) const;
+
+  /**
+   * @brief Get the tuples of the file as TupleViews.
+   */
+  TupleViews views() const;
+
+  /**
+   * @brief Get some fields of the tuples of the file as TupleViews.
+   * @param projection The fields to view. It must outlive the iteration.
+   */
+  TupleViews views(const Projection &projection) const;
+
+  /**
+   * @brief Fill a chunk with the next tuples of the file, in iteration order.
+   * @details The scan fetches each page once per chunk and decodes the rows it reads from the page column by column.
+   * @param it The position of the first tuple to read, for example begin(). It is advanced to the tuple after the last
+   * one read, or to end().
+   * @param chunk The chunk to fill. It is cleared first. A chunk built from a Projection only decodes its fields.
+   * @return The number of tuples read: 0 at the end of the file.
+   */
+  virtual size_t scan(Iterator &it, DataChunk &chunk) const;
+
+  /**
+   * @brief Fill a chunk with the next tuples of the file that satisfy a filter.
+   * @details The filter is evaluated on the serialized tuples, and only the matching ones are decoded.
+   * @param it The position of the first tuple to examine. It is advanced past the tuples examined, to end() at the
+   * end of the file.
+   * @param chunk The chunk to fill. It is cleared first. A chunk built from a Projection only decodes its fields.
+   * @param filter The conjunction of predicates the tuples must satisfy, on any field of the file.
+   * @return The number of tuples read: 0 at the end of the file.
+   */
+  virtual size_t scan(Iterator &it, DataChunk &chunk, const Filter &filter) const;
+
   virtual Iterator begin() const;
 
   virtual Iterator end() const;
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <db/Tuple.hpp>
+#include <span>
+
+namespace db {
+enum class predicate_op_t { EQ, NE, LT, LE, GT, GE, BETWEEN, PREFIX };
+
+/**
+ * @brief A condition on one field of a tuple: `field op value`, or `value <= field <= upper` for BETWEEN.
+ * @details INT and DOUBLE fields support every operator but PREFIX. CHAR fields support EQ, NE and PREFIX, and compare
+ * at most `CHAR_SIZE` characters, as many as are stored. VARCHAR fields support EQ, NE and PREFIX on whole values.
+ */
+struct Predicate {
+  size_t column;
+  predicate_op_t op;
+  field_t value;
+  /// The inclusive upper bound of BETWEEN
+  field_t upper = 0;
+};
+
+/**
+ * @brief A conjunction of predicates, prepared to be evaluated on the serialized tuples of a page.
+ * @details Every predicate is turned into a test on the bytes of its field at the offset given by the TupleDesc, so
+ * tuples are never deserialized. Comparisons on INT and DOUBLE fields become a range check, evaluated for the slots
+ * of a page 8 INT or 4 DOUBLE fields at a time with AVX2 gathers when the CPU supports them, and one at a time
+ * otherwise. Predicates on CHAR and VARCHAR fields are only evaluated on the slots that pass all the others.
+ */
+class Filter {
+  struct Term {
+    size_t column = 0;
+    size_t offset = 0;
+    type_t type = type_t::INT;
+    /// Whether the term holds when the field is outside the range, for NE
+    bool negate = false;
+    int int_lo = 0;
+    int int_hi = 0;
+    double double_lo = 0;
+    double double_hi = 0;
+    /// The bytes the field starts with: all `CHAR_SIZE` of them for EQ and NE, fewer for PREFIX. The whole value of a
+    /// VARCHAR field for EQ and NE
+    std::string chars{};
+    /// Whether a VARCHAR field may be longer than chars, for PREFIX
+    bool prefix = false;
+  };
+
+  std::vector<Term> numeric;
+  std::vector<Term> strings;
+  bool simd;
+
+  /**
+   * @brief Evaluate a term on a field.
+   * @param field The first byte of the field. A VARCHAR field must be in its row.
+   */
+  static bool matches(const Term &term, const uint8_t *field);
+
+  /**
+   * @brief Evaluate the filter on up to 64 consecutive slots.
+   * @param fields Maps a term to the first byte of its field in the first slot and the distance between two slots.
+   */
+  template <typename Fields> uint64_t select(Fields fields, size_t count, uint64_t candidates) const;
+
+public:
+  /**
+   * @brief Prepare the conjunction of the predicates for tuples of the specified TupleDesc.
+   * @param td The tuple descriptor of the tuples.
+   * @param predicates The predicates. An empty list selects every tuple.
+   * @param simd Whether to use AVX2 when the CPU supports it. Turning it off forces the scalar code, to compare both.
+   * @throws std::invalid_argument if a predicate refers to a missing column, has a value of another type than its
+   * column, or uses an operator its column does not support.
+   */
+  Filter(const TupleDesc &td, std::span<const Predicate> predicates, bool simd = true);
+
+  /**
+   * @brief Whether the filter evaluates with AVX2.
+   */
+  bool usesSimd() const;
+
+  /**
+   * @brief Evaluate the filter on up to 64 consecutive slots.
+   * @param rows The first byte of the first slot.
+   * @param stride The distance between two slots, the length of a tuple.
+   * @param count The number of slots, at most 64. Only their bytes are read.
+   * @param candidates The slots to consider, the first slot in the most significant bit.
+   * @return The candidates that satisfy every predicate.
+   */
+  uint64_t select(const uint8_t *rows, size_t stride, size_t count, uint64_t candidates) const;
+
+  /**
+   * @brief Evaluate the filter on up to 64 consecutive slots of a PaxPage.
+   * @details The fields of a column are contiguous, so the AVX2 evaluation loads them without gathers.
+   * @param minipages The first byte of the minipages: the field at offset `o` of a row starts the minipage at
+   * `minipages + o * slots`.
+   * @param slots The number of slots of the page.
+   * @param first The first slot to evaluate.
+   * @param count The number of slots, at most 64.
+   * @param candidates The slots to consider, slot first in the most significant bit.
+   * @return The candidates that satisfy every predicate.
+   */
+  uint64_t selectColumns(const uint8_t *minipages, size_t slots, size_t first, size_t count,
+                         uint64_t candidates) const;
+
+  /**
+   * @brief Evaluate the filter on one serialized tuple.
+   */
+  bool matches(const uint8_t *row) const;
+
+  /**
+   * @brief Check if a tuple whose field lies in a range may satisfy the filter.
+   * @details Only the predicates on the INT or DOUBLE field are considered, so a tuple may still fail the others.
+   * @param column The index of an INT or DOUBLE field.
+   * @param min The smallest value of the field.
+   * @param max The largest value of the field.
+   * @return false if no value in `[min, max]` satisfies the predicates on the field.
+   */
+  bool mayMatch(size_t column, double min, double max) const;
+};
+} // namespace db
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <db/DbFile.hpp>
+#include <mutex>
+#include <vector>
+
+namespace db {
+/**
+ * @brief Records how much room each page of a HeapFile has left, so that inserts reuse the space freed by deletes.
+ * @details Each page gets a 2-bit category, from FULL to EMPTY, packed 32 pages to a word. A second level keeps one
+ * bit per word that is set when some page of the word has room, so finding a page with room reads one bit per 2048
+ * pages and then a single word.
+ *
+ * The map is stored in a file of its own, next to the heap file, and is loaded when the HeapFile is opened and
+ * written back by flush(). The file starts with a header page that also records the format of the pages of the heap
+ * file, as set by its owner, since the categories are only meaningful for that format. It is only a hint: a page the map reports as having room may turn out to be full, and the
+ * caller then corrects its entry. Pages the map does not cover, for example after the map file was lost, are
+ * reported as EMPTY until they are tried.
+ */
+class FreeSpaceMap {
+  static constexpr size_t PAGES_PER_WORD = 32;
+  static constexpr size_t WORDS_PER_PAGE = DEFAULT_PAGE_SIZE / sizeof(uint64_t);
+
+  mutable std::mutex mutex;
+  DbFile file;
+  std::vector<uint64_t> words;
+  /// Bit `i` of `summary[j]` is set when `words[64 * j + i]` has a page with room
+  std::vector<uint64_t> summary;
+  /// Whether each page of words of the map file changed since it was last written
+  std::vector<bool> dirty;
+  uint32_t format = 0;
+  bool header_dirty = true;
+
+  void resize(size_t pages);
+
+  void store(size_t page, uint8_t category);
+
+public:
+  static constexpr uint8_t FULL = 0;
+  static constexpr uint8_t LOW = 1;
+  static constexpr uint8_t HALF = 2;
+  static constexpr uint8_t EMPTY = 3;
+  static constexpr size_t npos = -1;
+
+  /**
+   * @brief Open or create the map file.
+   * @param name The name of the map file.
+   * @param pages The number of pages of the heap file. Pages the map file does not cover are reported as EMPTY, and
+   * entries past the end of the heap file are dropped. A map file without a valid header covers no page.
+   * @throws std::runtime_error if the map file cannot be opened or read.
+   */
+  FreeSpaceMap(const std::string &name, size_t pages);
+
+  /**
+   * @brief Write back the map, ignoring errors.
+   */
+  ~FreeSpaceMap();
+
+  /**
+   * @brief The category of a page with the specified number of free slots.
+   * @param free The number of free slots.
+   * @param capacity The number of slots of the page.
+   */
+  static uint8_t category(size_t free, size_t capacity);
+
+  /**
+   * @brief Find a page with room for at least one more tuple.
+   * @return The lowest page number whose category is not FULL, or npos if there is none.
+   */
+  size_t find() const;
+
+  uint8_t get(size_t page) const;
+
+  /**
+   * @brief Get the format of the pages of the heap file recorded in the map file, or 0 if none was recorded.
+   */
+  uint32_t getFormat() const;
+
+  /**
+   * @brief Record the format of the pages of the heap file. It is written with the map.
+   */
+  void setFormat(uint32_t format);
+
+  /**
+   * @brief Record the category of a page. The map grows to cover the page if needed.
+   */
+  void set(size_t page, uint8_t category);
+
+  /**
+   * @brief Write the pages of the map that changed to the map file.
+   * @throws std::runtime_error if a write fails.
+   */
+  void flush();
+};
+} // namespace db
@@ -1,26 +1,163 @@
 #pragma once
 
 #include <db/DbFile.hpp>
+#include <db/FreeSpaceMap.hpp>
+#include <db/HeapPage.hpp>
+#include <db/PaxPage.hpp>
+#include <db/SlottedPage.hpp>
+#include <db/ZoneMap.hpp>
+#include <memory>
+#include <span>
 
 namespace db {
+/**
+ * @brief How the pages of a HeapFile store tuples of a fixed size: in rows (HeapPage) or in columns (PaxPage).
+ */
+enum class page_layout_t { ROW, PAX };
+
+/**
+ * @brief A file of unordered tuples stored in HeapPages.
+ * @details A FreeSpaceMap, stored in the file `<name>.fsm`, tracks the pages with free slots so that inserts fill the
+ * space left by deletes before the file grows.
+ *
+ * Tuples with VARCHAR fields have different lengths: they are stored in SlottedPages instead, and the free space map
+ * then tracks the free bytes of each page. A file created with the PAX layout stores its tuples in PaxPages, which
+ * keep each field in a minipage of its own. Inserts, deletes, iterators and scans work the same for every layout.
+ *
+ * A file opened with a zone map also keeps the smallest and largest value of the INT and DOUBLE fields of each page
+ * in a ZoneMap, stored in the file `<name>.zm`, and filtered scans skip the pages whose values cannot satisfy the
+ * filter without reading them.
+ */
 class HeapFile : public DbFile {
+  /// The end page of a scan of the whole file
+  static constexpr size_t NO_END = -1;
+
+  FreeSpaceMap fsm;
+  page_layout_t layout;
+  std::unique_ptr<ZoneMap> zones;
+
+  friend class HeapLoader;
+  friend class HeapVacuum;
+
+  /**
+   * @brief Call a function with a page wrapped in the page layout of the file.
+   * @param page The page, const for reading.
+   * @param f The function, called with a HeapPage, a PaxPage or a SlottedPage.
+   */
+  template <typename P, typename F> decltype(auto) withPage(P &page, F &&f) const {
+    if (td.variable_length()) {
+      SlottedPage sp(page, td);
+      return f(sp);
+    }
+    if (layout == page_layout_t::PAX) {
+      PaxPage pp(page, td);
+      return f(pp);
+    }
+    HeapPage hp(page, td);
+    return f(hp);
+  }
+
+  static uint8_t category(const HeapPage &hp);
+
+  static uint8_t category(const PaxPage &pp);
+
+  /**
+   * @brief The category of a slotted page, from its free bytes.
+   * @details A page without room for the shortest possible tuple is FULL.
+   */
+  uint8_t category(const SlottedPage &sp) const;
+
+  /**
+   * @brief Check that a tuple can be stored.
+   * @throws std::runtime_error if the tuple is not compatible with the TupleDesc, or too long to fit in a page.
+   */
+  void check(const Tuple &t) const;
+
+  /**
+   * @brief Insert a tuple to the first page with room for it, as insertTuple().
+   * @param insert Called with a page and its index under the page latch: inserts the tuple into the page and records
+   * it in the zone map, or returns false if the page does not have room for it.
+   */
+  template <typename F> void insert(F &&insert);
+
 public:
-  HeapFile(const std::string &name, const TupleDesc &td);
+  /**
+   * @brief Open or create a heap file.
+   * @param name The name of the file.
+   * @param td The tuple descriptor of the tuples.
+   * @param layout The layout of the pages. The layout of a new file is recorded in the header of its free space map,
+   * and must be the same every time the file is opened. Files of tuples with VARCHAR fields always use SlottedPages.
+   * @param zone_map Whether to keep a zone map. A file opened without one deletes its map file, which its changes
+   * would make stale.
+   * @throws std::invalid_argument if the layout is PAX and the tuples have VARCHAR fields, or if the file was created
+   * with another layout. A file whose free space map was lost takes the layout it is opened with.
+   */
+  HeapFile(const std::string &name, const TupleDesc &td, page_layout_t layout = page_layout_t::ROW,
+           bool zone_map = false);
+
+  page_layout_t getLayout() const { return layout; }
 
   /**
    * @brief Insert a tuple to the database file.
-   * @details Insert a tuple to the first available slot of the last page. If the last page is full, create a new page.
+   * @details Insert a tuple to the first available slot of the first page the free space map reports as having room,
+   * or of the last page. If the last page is full, create a new page.
    * @param t The tuple to be inserted.
+   * @throws std::runtime_error if the tuple is not compatible with the TupleDesc, or too long to fit in a page.
+   * @note A slotted page that turns out to be too full for a tuple is recorded as FULL until a delete frees some of
+   * its space, even if shorter tuples would still fit.
    */
   void insertTuple(const Tuple &t) override;
 
+  /**
+   * @brief Insert a tuple already serialized by the TupleDesc, as insertTuple().
+   * @details The bytes are copied to the page as they are, without building a Tuple. See StaticTupleDesc, which
+   * serializes the rows of a schema known at compile time.
+   * @param row The bytes of the tuple, as written by TupleDesc::serialize.
+   * @throws std::invalid_argument if the length of the row is not the length of the tuples of the TupleDesc, the row
+   * is too long to fit in a page, or the characters of a VARCHAR field are not within the row.
+   */
+  void insertSerialized(std::span<const uint8_t> row);
+
+  /**
+   * @brief Append many tuples to the database file at once.
+   * @details The tuples fill the last page, then whole new pages that are written to the end of the file in large
+   * batches without going through the BufferPool. See HeapLoader, which also loads streams of tuples.
+   * @param tuples The tuples to be inserted.
+   * @throws std::runtime_error if a tuple is not compatible with the TupleDesc or too long to fit in a page, or if a
+   * write fails. The tuples before it are inserted.
+   * @note Must not run concurrently with other inserts into the file.
+   */
+  void insertTuples(std::span<const Tuple> tuples);
+
   /**
    * @brief Delete a tuple from the database file.
-   * @details Delete a tuple from the database file by marking the slot unused.
+   * @details Delete a tuple from the database file by marking the slot unused, and record the free slot in the free
+   * space map.
    * @param it The iterator that identifies the tuple to be deleted.
    */
   void deleteTuple(const Iterator &it) override;
 
+  /**
+   * @brief Write the free space map of the file to disk.
+   * @throws std::runtime_error if a write fails.
+   * @note The map is also written when the HeapFile is destroyed.
+   */
+  void flushFreeSpaceMap();
+
+  const FreeSpaceMap &getFreeSpaceMap() const;
+
+  /**
+   * @brief Write the zone map of the file to disk, if it has one.
+   * @throws std::runtime_error if a write fails.
+   * @note The map is also written when the HeapFile is destroyed.
+   */
+  void flushZoneMap();
+
+  /**
+   * @brief Get the zone map of the file, or nullptr if it has none.
+   */
+  const ZoneMap *getZoneMap() const;
+
   /**
    * @brief Get a tuple from the database file.
    * @details Get a tuple from the database file by reading the tuple from the page.
@@ -29,6 +166,8 @@ public:
    */
   Tuple getTuple(const Iterator &it) const override;
 
+  using DbFile::getTuple;
+
   /**
    * @brief Advance the iterator to the next tuple.
    * @details Advance the iterator to the next tuple by moving to the next slot of the page.
@@ -37,6 +176,37 @@ public:
    */
   void next(Iterator &it) const override;
 
+  TupleView getTupleView(const Iterator &it, ReadPageGuard &guard) const override;
+
+  void next(Iterator &it, ReadPageGuard &guard) const override;
+
+  size_t scan(Iterator &it, DataChunk &chunk) const override;
+
+  /**
+   * @brief Fill a chunk with the next tuples that satisfy a filter.
+   * @details The filter is evaluated on 64 slots of a page at a time by HeapPage::select, or the select of the page
+   * layout of the file. With a zone map, the pages whose zone excludes the filter are skipped before they are read.
+   */
+  size_t scan(Iterator &it, DataChunk &chunk, const Filter &filter) const override;
+
+  /**
+   * @brief Fill a chunk with the next tuples of the pages before a page, as scan(it, chunk).
+   * @details Several threads can scan disjoint ranges of pages of the file at once, each with its own chunk. See
+   * ParallelScan.
+   * @param it The position of the first tuple to read, for example `{file, first, 0}` for the start of page `first`.
+   * It is advanced to the tuple after the last one read, or to `{file, end, 0}`.
+   * @param chunk The chunk to fill. It is cleared first.
+   * @param end The page the scan stops at.
+   * @return The number of tuples read: 0 once `it` reaches page `end` or the end of the file.
+   */
+  size_t scan(Iterator &it, DataChunk &chunk, size_t end) const;
+
+  /**
+   * @brief Fill a chunk with the next tuples of the pages before a page that satisfy a filter.
+   * @details See scan(it, chunk, end) and scan(it, chunk, filter).
+   */
+  size_t scan(Iterator &it, DataChunk &chunk, const Filter &filter, size_t end) const;
+
   /**
    * @brief Get the iterator to the first tuple.
    * @details Get the iterator to the first tuple by finding the first occupied slot.
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <db/HeapFile.hpp>
+#include <db/PageArena.hpp>
+#include <variant>
+
+namespace db {
+/**
+ * @brief Appends a stream of tuples to a HeapFile, filling whole pages at once.
+ * @details The loader first fills the free slots of the last page of the file through the BufferPool. It then
+ * serializes the tuples straight into fresh pages of an arena of its own and writes each full batch of pages to the
+ * end of the file with a single vectored write, so the loaded pages never take a frame of the pool. The free space map
+ * records every page written, and the pages become visible to scans once their batch is written.
+ * @note The loader only appends: it does not reuse the space freed by deletes in earlier pages. It must not run
+ * concurrently with other inserts into the same file.
+ */
+class HeapLoader {
+  HeapFile &file;
+  PageArena batch;
+  /// The page number of the first page of the batch
+  size_t first = 0;
+  /// The number of pages of the batch that hold tuples
+  size_t count = 0;
+  /// The page being filled, the last page of the batch, in the page layout of the file
+  std::variant<std::monostate, HeapPage, PaxPage, SlottedPage> page;
+  /// Whether the tuples still go to the last page of the file, through the BufferPool
+  bool top_up = true;
+
+  /**
+   * @brief Write the pages of the batch to the file and publish them.
+   * @throws std::runtime_error if a write fails.
+   */
+  void write();
+
+public:
+  /**
+   * @brief Start loading tuples into a file.
+   * @param file The file to append to.
+   * @param batch_pages The number of pages written at a time.
+   * @throws std::invalid_argument if batch_pages is 0.
+   * @throws std::logic_error if the file is mapped.
+   */
+  explicit HeapLoader(HeapFile &file, size_t batch_pages = 256);
+
+  /**
+   * @brief Write the tuples still held by the loader, as finish() does.
+   * @note Errors are ignored: call finish() to see them.
+   */
+  ~HeapLoader();
+
+  HeapLoader(const HeapLoader &) = delete;
+
+  HeapLoader &operator=(const HeapLoader &) = delete;
+
+  /**
+   * @brief Append a tuple to the file.
+   * @param t The tuple to be appended.
+   * @throws std::runtime_error if the tuple is not compatible with the TupleDesc of the file or too long to fit in a
+   * page, or if a write fails.
+   */
+  void append(const Tuple &t);
+
+  /**
+   * @brief Write the tuples appended so far, including a partly filled last page.
+   * @details Later appends first fill the rest of that page through the BufferPool.
+   * @throws std::runtime_error if a write fails.
+   */
+  void finish();
+};
+} // namespace db
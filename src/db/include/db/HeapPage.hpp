@@ -1,13 +1,44 @@
 #pragma once
 
 #include <db/DbFile.hpp>
+#include <db/Filter.hpp>
+#include <db/TupleView.hpp>
 
 namespace db {
+/**
+ * @brief A view of a page holding fixed-size tuples, with a header bitmap of the occupied slots.
+ * @details Slot `i` is occupied when bit `7 - i % 8` of header byte `i / 8` is set. The header is scanned 64 slots at
+ * a time: a word of the header is loaded big-endian so that slot order is bit order, and the next occupied or free
+ * slot is found with `std::countl_zero`. The number of occupied slots is counted with `std::popcount` the first time
+ * it is needed and kept up to date by the view, so full and empty pages are recognized without another scan.
+ */
 class HeapPage {
+protected:
   const TupleDesc &td;
   size_t capacity;
   uint8_t *header;
   uint8_t *data;
+  mutable size_t occupied = -1;
+
+  /**
+   * @brief Load the header bits of slots `[64 * i, 64 * i + 64)`, the first slot in the most significant bit.
+   * @details The bits past the capacity are cleared.
+   */
+  uint64_t word(size_t i) const;
+
+  size_t numWords() const;
+
+  /**
+   * @brief Find the first occupied slot at or after the specified slot.
+   * @return The slot, or capacity if there is none.
+   */
+  size_t scan(size_t from) const;
+
+  /**
+   * @brief Mark the first free slot occupied.
+   * @return The slot, or capacity if the page is full.
+   */
+  size_t claim();
 
 public:
   /**
@@ -20,6 +51,14 @@ public:
    */
   HeapPage(Page &page, const TupleDesc &td);
 
+  /**
+   * @brief Wrap a page with a heap page for reading.
+   * @param page The page to be wrapped.
+   * @param td The tuple descriptor of the page.
+   * @note Only the const methods may be called on a page wrapped this way.
+   */
+  HeapPage(const Page &page, const TupleDesc &td);
+
   /**
    * @brief Get the first occupied slot of the page.
    * @return The first occupied slot of the page.
@@ -30,7 +69,19 @@ public:
    * @brief Get the end of the page.
    * @return capacity can be used as the end of the page.
    */
-  size_t end() const;
+  size_t end() const { return capacity; }
+
+  /**
+   * @brief Count the occupied slots of the page.
+   * @return The number of tuples in the page.
+   */
+  size_t size() const;
+
+  /**
+   * @brief Count the free slots of the page.
+   * @return The number of slots that are not occupied.
+   */
+  size_t freeSlots() const;
 
   /**
    * @brief Insert a tuple to the page.
@@ -40,6 +91,13 @@ public:
    */
   bool insertTuple(const Tuple &t);
 
+  /**
+   * @brief Insert a tuple already serialized by the TupleDesc to the page.
+   * @param row The `td.length()` bytes of the tuple.
+   * @return True if the tuple is inserted successfully, false otherwise if the page is full.
+   */
+  bool insertSerialized(std::span<const uint8_t> row);
+
   /**
    * @brief Delete a tuple from the page.
    * @details Delete a tuple from the page by marking the slot unused.
@@ -53,7 +111,7 @@ public:
    * @param slot The slot to be checked.
    * @return True if the slot is empty, false otherwise.
    */
-  bool empty(size_t slot) const;
+  bool empty(size_t slot) const { return !(header[slot / 8] & (1 << (7 - slot % 8))); }
 
   /**
    * @brief Get the tuple at the specified slot.
@@ -63,10 +121,34 @@ public:
    */
   Tuple getTuple(size_t slot) const;
 
+  /**
+   * @brief View the tuple at the specified slot without deserializing it.
+   * @param slot The slot of the tuple.
+   * @return A view of the slot, valid while the page is.
+   * @throws std::runtime_error if the slot is not occupied.
+   */
+  TupleView getTupleView(size_t slot) const;
+
+  /**
+   * @brief Find the occupied slots of `[64 * i, 64 * i + 64)` whose tuple satisfies a filter.
+   * @param i The index of the group of 64 slots.
+   * @param filter The filter, evaluated on the slot bytes.
+   * @return The matching slots, slot `64 * i` in the most significant bit.
+   */
+  uint64_t select(size_t i, const Filter &filter) const;
+
+  /**
+   * @brief Append the tuples of some occupied slots to a chunk.
+   * @param slots The slots, in increasing order.
+   * @param chunk The chunk, with room for the tuples.
+   */
+  void decode(std::span<const size_t> slots, DataChunk &chunk) const;
+
   /**
    * @brief Advance the slot to the next occupied slot.
    * @details Advance the slot to the next occupied slot by scanning the header.
+   * @note The common case of a full page, where the next slot is occupied, is inlined.
    */
-  void next(size_t &slot) const;
+  void next(size_t &slot) const { slot = slot + 1 < capacity && !empty(slot + 1) ? slot + 1 : scan(slot + 1); }
 };
 } // namespace db
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <db/HeapFile.hpp>
+#include <functional>
+#include <span>
+
+namespace db {
+/**
+ * @brief A tuple moved by a HeapVacuum, from one slot of a HeapFile to another.
+ */
+struct TupleMove {
+  size_t from_page;
+  size_t from_slot;
+  size_t to_page;
+  size_t to_slot;
+};
+
+/**
+ * @brief Configuration of a HeapVacuum.
+ */
+struct VacuumOptions {
+  /// Number of tuples moved by each step
+  size_t moves_per_step = 256;
+
+  /// How long run() sleeps between two steps, so that the vacuum leaves the pages and the disk to the queries
+  std::chrono::microseconds pause{0};
+};
+
+/**
+ * @brief Compacts a HeapFile whose deletes left it sparse, a few tuples at a time, and truncates its empty tail.
+ * @details The vacuum moves the tuples of the last pages of the file into the free slots of the first pages, the
+ * pages the free space map reports as having room: a source finger walks down from the end of the file while the
+ * destination finger walks up from its start, until they meet. The file then holds its tuples in as few pages as a
+ * fresh load would, and every page after them is empty and can be truncated, so scans no longer walk them.
+ *
+ * Each move latches the destination page, then the source page, which comes later in the file, inserts the tuple
+ * into the destination and deletes it from the source, so readers, inserts and deletes of the file may run between
+ * and during the steps. A scan that runs during a step may see a moved tuple twice or not at all, as it would an
+ * insert and a delete. Moved tuples change location: each step reports its moves, so that the indexes of the file
+ * can be fixed up.
+ * @note truncate() must not run concurrently with other operations on the file.
+ */
+class HeapVacuum {
+  HeapFile &file;
+  VacuumOptions options;
+  /// The last page that may still hold tuples to move
+  size_t source;
+  bool finished = false;
+  std::vector<TupleMove> moves;
+
+  /**
+   * @brief Whether a page of the file holds no tuple.
+   */
+  bool empty(size_t page) const;
+
+public:
+  /**
+   * @brief Prepare the compaction of a file.
+   * @param file The file to compact.
+   * @param options The configuration of the vacuum.
+   * @throws std::invalid_argument if `options.moves_per_step` is 0.
+   * @throws std::logic_error if the file is mapped.
+   */
+  explicit HeapVacuum(HeapFile &file, const VacuumOptions &options = {});
+
+  /**
+   * @brief Move up to `options.moves_per_step` tuples.
+   * @return The moves of the step, valid until the next call. Empty once there is nothing left to move.
+   */
+  std::span<const TupleMove> step();
+
+  /**
+   * @brief Whether every tuple that can be moved was moved.
+   */
+  bool done() const { return finished; }
+
+  /**
+   * @brief Drop the empty pages at the end of the file from the file, and from the BufferPool.
+   * @return The number of pages dropped.
+   * @throws std::runtime_error if the file cannot be truncated.
+   * @note Must not run concurrently with other operations on the file.
+   */
+  size_t truncate();
+
+  /**
+   * @brief Run the steps until done, sleeping `options.pause` between them, then truncate the file.
+   * @param on_moves Called with the moves of each step.
+   * @return The number of pages dropped.
+   * @note The steps run online, but the final truncation must not run concurrently with other operations.
+   */
+  size_t run(const std::function<void(std::span<const TupleMove>)> &on_moves = {});
+};
+} // namespace db
@@ -20,21 +20,28 @@ struct IndexPage {
   size_t *children;
 
   /**
-   * @brief Initialize a leaf page
+   * @brief Initialize an index page
    *
    * @details The provided page has a header of type IndexPageHeader, followed by `IndexPageHeader::size` keys and
    * `IndexPageHeader::size + 1` page numbers. The keys are sorted in ascending order.
    * The capacity of the page is calculated based on the remaining size of the page.
+   * A zeroed page is an empty index page.
    *
    * @param page the page contents
-   * @param key_index the index of the key in the tuple
    */
   explicit IndexPage(Page &page);
 
+  /**
+   * @brief Initialize an index page for reading
+   * @note Only lookups may be performed on a page wrapped this way.
+   * @param page the page contents
+   */
+  explicit IndexPage(const Page &page);
+
   /**
    * @brief Insert a new key with a corresponding child page number
    * @param key the key to insert
-   * @param child the child page number
+   * @param child the child page number, responsible for the keys greater than or equal to `key`
    * @return true if the page is full and needs to be split
    */
   bool insert(int key, size_t child);
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <db/types.hpp>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace db {
+enum class io_backend_t { SYNC, IO_URING };
+
+/**
+ * @brief A read or a write of one page.
+ */
+struct IoRequest {
+  int fd;
+  Page *page;
+  /// Offset in the file, in bytes
+  size_t offset;
+  bool write;
+};
+
+/// Number of buckets of a LatencyHistogram
+constexpr size_t LATENCY_BUCKETS = 32;
+
+/**
+ * @brief Counts of I/O calls by latency on a log scale.
+ * @details Bucket `i` counts the calls that took `[2^i, 2^(i+1))` ns. Bucket 0 also counts shorter calls and the last
+ * bucket longer ones.
+ */
+using LatencyHistogram = std::array<size_t, LATENCY_BUCKETS>;
+
+/**
+ * @brief Estimate a percentile of the latencies counted by a histogram.
+ * @param histogram The histogram.
+ * @param fraction The percentile, in `[0, 1]`.
+ * @return The upper bound in ns of the bucket holding the percentile, or 0 if the histogram is empty.
+ */
+size_t latencyPercentile(const LatencyHistogram &histogram, double fraction);
+
+/**
+ * @brief Counters of the I/O an IoBackend handed to the kernel.
+ */
+struct IoStats {
+  /// Number of read system calls, or of io_uring read operations. A `preadv` of several pages counts once.
+  size_t read_calls = 0;
+
+  /// Number of bytes read
+  size_t bytes_read = 0;
+
+  /// Number of write system calls, or of io_uring write operations. A `pwritev` of several pages counts once.
+  size_t write_calls = 0;
+
+  /// Number of bytes written
+  size_t bytes_written = 0;
+
+  /// Latency of the read and write calls. The latency of an io_uring operation runs from its submission to the reaping
+  /// of its completion.
+  LatencyHistogram latency{};
+};
+
+/**
+ * @brief Executes batches of page reads and writes.
+ * @details submit() returns once every request of the batch is complete. Backends may run the requests of a batch in
+ * any order and concurrently, so a batch must not read and write the same page. Reads past the end of a file are
+ * zero-filled.
+ */
+class IoBackend {
+  std::atomic<size_t> read_calls = 0;
+  std::atomic<size_t> bytes_read = 0;
+  std::atomic<size_t> write_calls = 0;
+  std::atomic<size_t> bytes_written = 0;
+  std::array<std::atomic<size_t>, LATENCY_BUCKETS> latency{};
+
+protected:
+  /**
+   * @brief Count one call handed to the kernel.
+   * @param write Whether the call writes.
+   * @param bytes The number of bytes the call covers.
+   * @param nanoseconds How long the call took.
+   */
+  void count(bool write, size_t bytes, size_t nanoseconds);
+
+public:
+  virtual ~IoBackend() = default;
+
+  /**
+   * @brief Run a batch of requests and wait for all of them.
+   * @param requests The requests to run.
+   * @throws std::runtime_error if a request fails or a write is short.
+   */
+  virtual void submit(std::span<const IoRequest> requests) = 0;
+
+  /**
+   * @brief Tell the backend where the buffers of later requests live, so that it can map them once.
+   * @param base The start of the memory holding the pages.
+   * @param bytes The size of the memory.
+   * @note Requests may still use pages outside of this memory.
+   */
+  virtual void registerBuffers([[maybe_unused]] void *base, [[maybe_unused]] size_t bytes) {}
+
+  /**
+   * @brief Returns a snapshot of the counters.
+   */
+  IoStats getStats() const;
+};
+
+/**
+ * @brief Runs the requests one after the other with blocking system calls.
+ * @details Reads or writes of consecutive pages of a file that follow each other in the batch are merged into one
+ * `preadv` or `pwritev`, so a batch sorted by file and page number does sequential I/O with few system calls.
+ */
+class SyncIoBackend : public IoBackend {
+public:
+  void submit(std::span<const IoRequest> requests) override;
+};
+
+/**
+ * @brief Runs batches on io_uring submission queues.
+ * @details A batch is written to the submission queue and handed to the kernel with one `io_uring_enter`, so all of its
+ * requests are in flight together. Completions are reaped from the shared completion ring without a system call when
+ * they are already there. Pages inside the registered buffers use `READ_FIXED`/`WRITE_FIXED`, which skips mapping the
+ * pages on every request. The backend owns several rings, each used by one batch at a time, so concurrent threads do
+ * not wait for each other's batches.
+ * @note The rings are set up with raw system calls: liburing is not required.
+ */
+class IoUringBackend : public IoBackend {
+  struct Ring {
+    std::mutex mutex;
+    int fd = -1;
+    unsigned entries = 0;
+    void *sq_map = nullptr;
+    size_t sq_map_size = 0;
+    void *cq_map = nullptr;
+    size_t cq_map_size = 0;
+    io_uring_sqe *sqes = nullptr;
+    size_t sqes_size = 0;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    io_uring_cqe *cqes;
+    bool registered = false;
+
+    Ring() = default;
+
+    /**
+     * @brief Unmap the queues and close the ring, also when its setup failed halfway.
+     */
+    ~Ring();
+
+    Ring(const Ring &) = delete;
+
+    Ring &operator=(const Ring &) = delete;
+  };
+
+  std::vector<std::unique_ptr<Ring>> rings;
+  char *buffers = nullptr;
+  size_t buffers_size = 0;
+
+  void run(Ring &ring, std::span<const IoRequest> requests);
+
+public:
+  /**
+   * @brief Set up the rings.
+   * @param queue_depth The number of requests each ring keeps in flight.
+   * @param num_rings The number of batches that can run concurrently.
+   * @throws std::runtime_error if the kernel does not support io_uring.
+   */
+  explicit IoUringBackend(unsigned queue_depth = 64, size_t num_rings = 4);
+
+  IoUringBackend(const IoUringBackend &) = delete;
+
+  IoUringBackend &operator=(const IoUringBackend &) = delete;
+
+  void submit(std::span<const IoRequest> requests) override;
+
+  void registerBuffers(void *base, size_t bytes) override;
+};
+
+/**
+ * @brief Create an I/O backend.
+ * @param backend The kind of backend to create.
+ * @param queue_depth The number of requests the backend keeps in flight.
+ * @return The backend, or a SyncIoBackend if io_uring is requested but not available.
+ */
+std::unique_ptr<IoBackend> makeIoBackend(io_backend_t backend, unsigned queue_depth);
+} // namespace db
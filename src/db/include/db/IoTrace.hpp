@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace db {
+/**
+ * @brief Keeps the last page numbers read or written by a DbFile, in a ring of fixed capacity.
+ * @details Recording never allocates: once the ring is full the oldest entry is overwritten, so a trace left enabled
+ * in a long-running process uses a bounded amount of memory.
+ * @note The trace is not synchronized: the owner serializes calls.
+ */
+class IoTrace {
+  std::vector<size_t> ring;
+  size_t count = 0;
+
+public:
+  /**
+   * @brief Creates an empty trace.
+   * @param capacity The number of entries kept.
+   * @throws std::invalid_argument if capacity is 0.
+   */
+  explicit IoTrace(size_t capacity);
+
+  void record(size_t page);
+
+  /**
+   * @brief Returns the entries kept, oldest first.
+   */
+  std::vector<size_t> get() const;
+
+  /**
+   * @brief Returns the number of entries recorded, including those overwritten.
+   */
+  size_t size() const { return count; }
+};
+} // namespace db
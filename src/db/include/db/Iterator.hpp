@@ -1,6 +1,7 @@
 #pragma once
 
-#include <db/Tuple.hpp>
+#include <db/PageGuard.hpp>
+#include <db/Projection.hpp>
 
 namespace db {
 class DbFile;
@@ -23,4 +24,59 @@ public:
   bool operator==(const Iterator &other) const { return page == other.page && slot == other.slot; }
   bool operator!=(const Iterator &) const = default;
 };
+
+/**
+ * @brief Iterates over the tuples of a file as TupleViews, without deserializing them.
+ * @details The iterator keeps the page of the current tuple pinned, so each page is fetched once for all of its
+ * tuples. A view it yields is valid until the iterator moves to another page, is released or is destroyed.
+ *
+ * The pinned page is also latched for reading, so the thread iterating must not get, insert or delete tuples through
+ * the DbFile while the iterator holds it: the DbFile would latch the page again. Call release() first.
+ */
+class ViewIterator {
+  Iterator it;
+  ReadPageGuard guard;
+  const Projection *projection;
+
+public:
+  /**
+   * @param it The position of the iterator.
+   * @param projection The fields to view, or nullptr to view every field.
+   */
+  explicit ViewIterator(const Iterator &it, const Projection *projection = nullptr);
+
+  TupleView operator*();
+
+  ViewIterator &operator++();
+
+  /**
+   * @brief Get the position of the iterator, for example to get or delete the tuple with the DbFile after release().
+   */
+  const Iterator &position() const { return it; }
+
+  /**
+   * @brief Unpin and unlatch the page of the current tuple, so that the DbFile can be used on it.
+   * @details The views yielded so far become invalid. The iterator stays at its position: dereferencing or advancing
+   * it fetches the page again.
+   */
+  void release();
+
+  bool operator==(const ViewIterator &other) const { return it == other.it; }
+};
+
+/**
+ * @brief The tuples of a file, iterated as TupleViews: `for (TupleView t : file.views())`.
+ */
+class TupleViews {
+  const DbFile &file;
+  const Projection *projection;
+
+public:
+  explicit TupleViews(const DbFile &file, const Projection *projection = nullptr)
+      : file(file), projection(projection) {}
+
+  ViewIterator begin() const;
+
+  ViewIterator end() const;
+};
 } // namespace db
\ No newline at end of file
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <db/Tuple.hpp>
+#include <db/TupleView.hpp>
 
 namespace db {
 
@@ -28,6 +28,7 @@ struct LeafPage {
    *
    * @details The provided page has a header of type LeafPageHeader, followed by a sequence of tuples.
    * The capacity of the page is calculated based on the remaining size of the page and the size of the tuples.
+   * A zeroed page is an empty leaf page.
    *
    * @param page the page contents
    * @param td the tuple descriptor
@@ -35,6 +36,12 @@ struct LeafPage {
    */
   LeafPage(Page &page, const TupleDesc &td, size_t key_index);
 
+  /**
+   * @brief Initialize a leaf page for reading
+   * @note Only getTuple may be called on a page wrapped this way.
+   */
+  LeafPage(const Page &page, const TupleDesc &td, size_t key_index);
+
   /**
    * @brief Insert a tuple into the page
    * @details The tuple is inserted in sorted order based on the key. If the key already exists, the previous tuple is replaced.
@@ -42,6 +49,13 @@ struct LeafPage {
    */
   bool insertTuple(const Tuple &t);
 
+  /**
+   * @brief Insert a tuple already serialized by the TupleDesc into the page, as insertTuple
+   * @param row the `td.length()` bytes of the tuple
+   * @return true if the leaf is full and needs to be split.
+   */
+  bool insertSerialized(std::span<const uint8_t> row);
+
   /**
    * @brief Split the leaf page
    * @details The page is split into two pages. The old page contains the first half of the tuples, and the new page contains the second half.
@@ -57,9 +71,18 @@ struct LeafPage {
    * @return The tuple read from the page.
    */
   Tuple getTuple(size_t slot) const;
+
+  /**
+   * @brief View the tuple at the specified slot without deserializing it.
+   * @return A view of the slot, valid while the page is.
+   * @throws std::runtime_error if the slot is out of bounds.
+   */
+  TupleView getTupleView(size_t slot) const;
 	
 private:												// helpers
 	size_t findInsertPosition(int key) const;	
+	uint8_t *place(int key);
+	int keyAt(size_t slot) const;
 	void copyTuple(size_t from, size_t to);
 };
 
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <db/types.hpp>
+
+namespace db {
+/**
+ * @brief A single page-aligned block of memory holding a fixed number of pages.
+ * @details The arena is obtained with an anonymous `mmap`, so every page starts on a `DEFAULT_PAGE_SIZE` boundary.
+ * When huge pages are requested the mapping is rounded up to a 2 MB boundary and advised with `MADV_HUGEPAGE`.
+ * @note The memory is released when the arena is destroyed.
+ */
+class PageArena {
+  Page *pages;
+  size_t num_pages;
+  size_t bytes;
+
+public:
+  /**
+   * @brief Map an arena large enough to hold the specified number of pages.
+   * @param num_pages The number of pages in the arena.
+   * @param huge_pages Whether to ask the kernel to back the arena with transparent huge pages.
+   * @throws std::invalid_argument if num_pages is 0.
+   * @throws std::runtime_error if the `mmap` system call fails.
+   */
+  PageArena(size_t num_pages, bool huge_pages);
+
+  /**
+   * @brief Unmaps the arena.
+   */
+  ~PageArena();
+
+  PageArena(const PageArena &) = delete;
+
+  PageArena(PageArena &&) = delete;
+
+  PageArena &operator=(const PageArena &) = delete;
+
+  PageArena &operator=(PageArena &&) = delete;
+
+  Page &operator[](size_t pos) { return pages[pos]; }
+
+  const Page &operator[](size_t pos) const { return pages[pos]; }
+
+  Page *data() { return pages; }
+
+  size_t size() const { return num_pages; }
+
+  /**
+   * @brief Get the number of bytes mapped for the arena.
+   * @return The size of the mapping, including the padding added for huge pages.
+   */
+  size_t capacity() const { return bytes; }
+};
+} // namespace db
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <db/types.hpp>
+
+namespace db {
+class BufferPool;
+
+/**
+ * @brief Keeps a page of a BufferPool pinned while it is in scope.
+ * @details A pinned page cannot be evicted or discarded, so references to its contents stay valid until the guard is
+ * released or destroyed. The guard also holds the latch of the frame. Guards can be moved but not copied.
+ */
+class PageGuard {
+protected:
+  BufferPool *pool = nullptr;
+  size_t pos = 0;
+  PageId pid{};
+  Page *page = nullptr;
+
+  PageGuard(BufferPool *pool, size_t pos, const PageId &pid, Page *page);
+
+  void release(bool exclusive);
+
+public:
+  PageGuard() = default;
+
+  PageGuard(const PageGuard &) = delete;
+
+  PageGuard &operator=(const PageGuard &) = delete;
+
+  PageGuard(PageGuard &&other) noexcept;
+
+  PageGuard &operator=(PageGuard &&other) noexcept;
+
+  /**
+   * @brief Whether the guard holds a page.
+   */
+  explicit operator bool() const { return page != nullptr; }
+
+  const PageId &getPageId() const { return pid; }
+};
+
+/**
+ * @brief A guard for reading a page.
+ * @details Holds the latch of the frame shared: other readers may hold the page at the same time. A guard on a page of
+ * a mapped DbFile has no frame to pin.
+ */
+class ReadPageGuard : public PageGuard {
+  friend class BufferPool;
+  friend class DbFile;
+
+  ReadPageGuard(BufferPool *pool, size_t pos, const PageId &pid, Page *page) : PageGuard(pool, pos, pid, page) {}
+
+public:
+  ReadPageGuard() = default;
+
+  ReadPageGuard(ReadPageGuard &&) noexcept = default;
+
+  ReadPageGuard &operator=(ReadPageGuard &&) noexcept;
+
+  /**
+   * @brief Unpins the page.
+   */
+  ~ReadPageGuard();
+
+  const Page &operator*() const { return *page; }
+
+  const Page *operator->() const { return page; }
+
+  /**
+   * @brief Unpins the page before the guard goes out of scope.
+   */
+  void release();
+};
+
+/**
+ * @brief A guard for modifying a page.
+ * @details Holds the latch of the frame exclusively. The page is marked dirty when the guard is released.
+ */
+class WritePageGuard : public PageGuard {
+  friend class BufferPool;
+
+  WritePageGuard(BufferPool *pool, size_t pos, const PageId &pid, Page *page) : PageGuard(pool, pos, pid, page) {}
+
+public:
+  WritePageGuard() = default;
+
+  WritePageGuard(WritePageGuard &&) noexcept = default;
+
+  WritePageGuard &operator=(WritePageGuard &&) noexcept;
+
+  /**
+   * @brief Marks the page dirty and unpins it.
+   */
+  ~WritePageGuard();
+
+  Page &operator*() const { return *page; }
+
+  Page *operator->() const { return page; }
+
+  /**
+   * @brief Marks the page dirty and unpins it before the guard goes out of scope.
+   */
+  void release();
+};
+} // namespace db
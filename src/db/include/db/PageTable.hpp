@@ -0,0 +1,61 @@
+#pragma once
+
+#include <db/types.hpp>
+#include <vector>
+
+namespace db {
+/**
+ * @brief An open-addressing hash table from PageId to an integer, such as the frame that holds the page.
+ * @details The slots are a power-of-two array probed linearly and kept at most half full, so a lookup usually reads a
+ * single cache line. Erasing shifts the following entries of the probe sequence back instead of leaving tombstones.
+ * The invalid PageId (file 0) marks empty slots and cannot be stored.
+ */
+class PageTable {
+  struct Slot {
+    PageId pid;
+    size_t value;
+  };
+
+  std::vector<Slot> slots;
+  size_t capacity;
+  size_t shift;
+  size_t count = 0;
+
+  size_t home(const PageId &pid) const;
+
+public:
+  static constexpr size_t npos = -1;
+
+  /**
+   * @brief Creates an empty table.
+   * @param capacity The maximum number of entries.
+   */
+  explicit PageTable(size_t capacity = 0);
+
+  /**
+   * @brief Returns the value stored for a page.
+   * @param pid The page to look up.
+   * @return The value, or `npos` if the page is not in the table.
+   */
+  size_t find(const PageId &pid) const;
+
+  bool contains(const PageId &pid) const;
+
+  /**
+   * @brief Stores a value for a page, replacing the previous one.
+   * @param pid The page, which must not be the invalid PageId.
+   * @param value The value to store.
+   * @throws std::length_error if the page is new and the table already holds `capacity` entries.
+   */
+  void insert(const PageId &pid, size_t value);
+
+  /**
+   * @brief Removes a page from the table.
+   * @param pid The page to remove.
+   * @return True if the page was in the table, false otherwise.
+   */
+  bool erase(const PageId &pid);
+
+  size_t size() const;
+};
+} // namespace db
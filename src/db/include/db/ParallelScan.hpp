@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <db/HeapFile.hpp>
+#include <db/ThreadPool.hpp>
+#include <memory>
+
+namespace db {
+/**
+ * @brief Counters describing how the morsels of a ParallelScan were handed out.
+ */
+struct ParallelScanStats {
+  /// Number of morsels scanned
+  size_t morsels = 0;
+
+  /// Number of morsels a worker took from the range of another worker
+  size_t steals = 0;
+};
+
+/**
+ * @brief Scans the pages of a HeapFile with the workers of a ThreadPool, a morsel of consecutive pages at a time.
+ * @details The pages `[0, numPages)` are split into one contiguous range per worker. Each worker takes morsels from
+ * the front of its own range, so it reads its pages in order, and once its range is exhausted steals morsels from the
+ * back of the ranges of the other workers, so that a worker slowed down by its pages, its consumer or the scheduler
+ * does not hold back the others. Each range is locked only to take a morsel.
+ *
+ * The workers read the pages through the BufferPool of the Database, which must be configured with enough shards for
+ * them not to queue on its locks. Pages appended to the file after a run starts are not scanned by that run.
+ * @note The runs of a ParallelScan must not overlap: use a ParallelScan per thread that starts runs.
+ */
+class ParallelScan {
+  /// The pages left in the range of a worker, on a cache line of its own
+  struct alignas(64) Range {
+    std::mutex mutex;
+    size_t next = 0;
+    size_t end = 0;
+  };
+
+  const HeapFile &file;
+  ThreadPool &pool;
+  size_t morsel_pages;
+  std::unique_ptr<Range[]> ranges;
+  std::atomic<size_t> morsels;
+  std::atomic<size_t> steals;
+
+  /**
+   * @brief Take the next morsel of a worker, from its own range or from another.
+   * @return false once every range is exhausted.
+   */
+  bool take(size_t worker, size_t &first, size_t &end);
+
+public:
+  /**
+   * @brief Prepare parallel scans of a file.
+   * @param file The file to scan.
+   * @param pool The workers that scan it.
+   * @param morsel_pages The number of pages handed out at a time.
+   * @throws std::invalid_argument if morsel_pages is 0.
+   */
+  ParallelScan(const HeapFile &file, ThreadPool &pool, size_t morsel_pages = 64);
+
+  /**
+   * @brief Hand every page of the file out to the workers, a morsel at a time.
+   * @param scan Called by the workers with their index and the pages `[first, end)` of a morsel.
+   * @throws The first exception thrown by scan, once every worker stopped. A worker stops at its first exception.
+   */
+  ParallelScanStats run(const std::function<void(size_t worker, size_t first, size_t end)> &scan);
+
+  /**
+   * @brief Scan every tuple of the file into a chunk per worker, and hand each chunk to a consumer.
+   * @param projection The fields to decode.
+   * @param consume Called by the workers with their index and each chunk they fill, in page order within a morsel.
+   * @throws The first exception thrown by consume, once every worker stopped.
+   */
+  ParallelScanStats run(const Projection &projection,
+                        const std::function<void(size_t worker, const DataChunk &chunk)> &consume);
+
+  /**
+   * @brief Scan the tuples of the file that satisfy a filter into a chunk per worker, as the other run().
+   */
+  ParallelScanStats run(const Projection &projection, const Filter &filter,
+                        const std::function<void(size_t worker, const DataChunk &chunk)> &consume);
+};
+} // namespace db
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <db/HeapPage.hpp>
+
+namespace db {
+/**
+ * @brief A view of a page holding fixed-size tuples column by column (PAX), with the header bitmap of a HeapPage.
+ * @details The page has the capacity and the header of a HeapPage for the same TupleDesc, so the slots are found and
+ * counted in the same way. The data area is split into one minipage per field instead of one slot per tuple: the
+ * field at offset `o` of a serialized tuple has its minipage at `data + o * capacity`, and the value of slot `s` at
+ * `s * size_of(type)` in it. Scans that read a few fields then only touch the cache lines of those fields, and the
+ * values of a field are contiguous for the filters and the DataChunks.
+ */
+class PaxPage : private HeapPage {
+public:
+  /**
+   * @brief Wrap a page with a PAX page.
+   * @param page The page to be wrapped.
+   * @param td The tuple descriptor of the page.
+   * @throws std::invalid_argument if the tuples have VARCHAR fields.
+   */
+  PaxPage(Page &page, const TupleDesc &td);
+
+  /**
+   * @brief Wrap a page with a PAX page for reading.
+   * @note Only the const methods may be called on a page wrapped this way.
+   */
+  PaxPage(const Page &page, const TupleDesc &td);
+
+  using HeapPage::begin;
+  using HeapPage::deleteTuple;
+  using HeapPage::empty;
+  using HeapPage::end;
+  using HeapPage::freeSlots;
+  using HeapPage::next;
+  using HeapPage::size;
+
+  /**
+   * @brief Insert a tuple to the first free slot, one field per minipage.
+   * @return True if the tuple is inserted, false if the page is full.
+   */
+  bool insertTuple(const Tuple &t);
+
+  /**
+   * @brief Insert a tuple serialized in a row by the TupleDesc, scattering its fields to the minipages.
+   * @param row The `td.length()` bytes of the tuple.
+   * @return True if the tuple is inserted, false if the page is full.
+   */
+  bool insertSerialized(std::span<const uint8_t> row);
+
+  /**
+   * @brief Get the tuple at the specified slot.
+   * @throws std::runtime_error if the slot is not occupied.
+   */
+  Tuple getTuple(size_t slot) const;
+
+  /**
+   * @brief View the tuple at the specified slot, reading each field from its minipage.
+   * @throws std::runtime_error if the slot is not occupied.
+   */
+  TupleView getTupleView(size_t slot) const;
+
+  /**
+   * @brief Find the occupied slots of `[64 * i, 64 * i + 64)` whose tuple satisfies a filter.
+   * @details The filter loads the contiguous values of each column.
+   * @return The matching slots, slot `64 * i` in the most significant bit.
+   */
+  uint64_t select(size_t i, const Filter &filter) const;
+
+  /**
+   * @brief Append the tuples of some occupied slots to a chunk, one column at a time.
+   * @param slots The slots, in increasing order.
+   * @param chunk The chunk, with room for the tuples.
+   */
+  void decode(std::span<const size_t> slots, DataChunk &chunk) const;
+};
+} // namespace db
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <db/TupleView.hpp>
+
+namespace db {
+/**
+ * @brief Selects some fields of the tuples of a TupleDesc, so that only those fields are decoded.
+ * @details The projection has a projected TupleDesc, with the selected fields in the requested order, and the offset
+ * of each selected field in the full serialized tuple. Views, Tuples and DataChunks built from a projection read the
+ * selected fields straight from the full tuple and never touch the others.
+ */
+class Projection {
+  TupleDesc td;
+  std::vector<size_t> columns;
+  std::vector<size_t> offsets;
+
+public:
+  /**
+   * @brief Select fields by index.
+   * @param source The tuple descriptor of the full tuples.
+   * @param columns The indexes of the fields to keep, in the order of the projected tuples.
+   * @throws std::out_of_range if an index is out of range.
+   * @throws std::logic_error if an index is repeated.
+   */
+  Projection(const TupleDesc &source, std::vector<size_t> columns);
+
+  /**
+   * @brief Select fields by name.
+   * @throws std::out_of_range if a name is not a field of source.
+   * @throws std::logic_error if a name is repeated.
+   */
+  Projection(const TupleDesc &source, const std::vector<std::string> &names);
+
+  /**
+   * @brief Get the TupleDesc of the projected tuples.
+   */
+  const TupleDesc &getTupleDesc() const { return td; }
+
+  /**
+   * @brief Get the indexes of the selected fields in the full tuples.
+   */
+  const std::vector<size_t> &getColumns() const { return columns; }
+
+  /**
+   * @brief Get the offsets of the selected fields in the full serialized tuples.
+   */
+  const std::vector<size_t> &getOffsets() const { return offsets; }
+
+  /**
+   * @brief View the selected fields of a full serialized tuple.
+   * @param row The first byte of the full tuple.
+   */
+  TupleView view(const uint8_t *row) const { return {td, row, offsets.data()}; }
+
+  /**
+   * @brief View the selected fields of a view of a full tuple, stored as a row or in a PaxPage.
+   * @param row A view of the full tuple, with every field.
+   */
+  TupleView view(const TupleView &row) const { return {td, row.data, offsets.data(), row.slots, row.slot}; }
+
+  /**
+   * @brief Decode the selected fields of a full serialized tuple.
+   * @param row The first byte of the full tuple.
+   * @return The projected Tuple.
+   */
+  Tuple project(const uint8_t *row) const;
+};
+} // namespace db
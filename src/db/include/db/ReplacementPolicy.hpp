@@ -0,0 +1,193 @@
+#pragma once
+
+#include <db/PageTable.hpp>
+#include <db/types.hpp>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace db {
+enum class replacement_t { LRU, CLOCK, LRU_K, TWO_Q };
+
+/**
+ * @brief Decides which frame of a BufferPool to evict.
+ * @details The BufferPool notifies the policy when a page is loaded into a frame, when the page of a frame is accessed
+ * and when a frame is emptied. Frames are identified by their position in the pool, in `[0, num_frames)`. A frame whose
+ * page is pinned is not evictable and must not be returned by victim().
+ * @note Implementations preallocate their bookkeeping for all frames so that a hit does not allocate.
+ */
+class ReplacementPolicy {
+public:
+  virtual ~ReplacementPolicy() = default;
+
+  /**
+   * @brief A page was loaded into an empty frame.
+   * @param frame The frame that now holds the page.
+   * @param pid The page id of the loaded page.
+   */
+  virtual void insert(size_t frame, const PageId &pid) = 0;
+
+  /**
+   * @brief The page held by the frame was accessed.
+   * @param frame The accessed frame.
+   */
+  virtual void access(size_t frame) = 0;
+
+  /**
+   * @brief The frame was emptied and should no longer be tracked.
+   * @param frame The emptied frame.
+   */
+  virtual void erase(size_t frame) = 0;
+
+  /**
+   * @brief Allow or forbid evicting the frame.
+   * @param frame A tracked frame.
+   * @param evictable False while the page of the frame is pinned.
+   * @note Frames are evictable when they are inserted.
+   */
+  virtual void setEvictable(size_t frame, bool evictable) = 0;
+
+  /**
+   * @brief Choose the frame to evict next.
+   * @return The frame to evict.
+   * @throws std::runtime_error if no tracked frame is evictable.
+   * @note The frame is still tracked until erase(frame) is called.
+   */
+  virtual size_t victim() = 0;
+};
+
+/**
+ * @brief Least recently used.
+ * @details Frames are kept in an intrusive doubly linked list over frame positions. Pinned frames stay in the list and
+ * are skipped when looking for a victim.
+ */
+class LruPolicy : public ReplacementPolicy {
+  static constexpr size_t npos = -1;
+  std::vector<size_t> prev;
+  std::vector<size_t> next;
+  std::vector<bool> pinned;
+  size_t head = npos;
+  size_t tail = npos;
+
+  void unlink(size_t frame);
+  void pushFront(size_t frame);
+
+public:
+  explicit LruPolicy(size_t num_frames);
+  void insert(size_t frame, const PageId &pid) override;
+  void access(size_t frame) override;
+  void erase(size_t frame) override;
+  void setEvictable(size_t frame, bool evictable) override;
+  size_t victim() override;
+};
+
+/**
+ * @brief CLOCK (second chance).
+ * @details A reference bit per frame is set on every access. The hand sweeps over the frames, clearing the bits it
+ * finds set, and evicts the first tracked frame whose bit is already clear.
+ */
+class ClockPolicy : public ReplacementPolicy {
+  std::vector<bool> tracked;
+  std::vector<bool> referenced;
+  std::vector<bool> pinned;
+  size_t hand = 0;
+  /// Number of tracked frames that are evictable
+  size_t size = 0;
+
+public:
+  explicit ClockPolicy(size_t num_frames);
+  void insert(size_t frame, const PageId &pid) override;
+  void access(size_t frame) override;
+  void erase(size_t frame) override;
+  void setEvictable(size_t frame, bool evictable) override;
+  size_t victim() override;
+};
+
+/**
+ * @brief LRU-K.
+ * @details Evicts the frame whose K-th most recent access is the oldest. Frames with fewer than K accesses have an
+ * infinite backward K-distance and are evicted first, least recently used among them. Consecutive accesses to the same
+ * frame are treated as one correlated reference, so scanning the tuples of a page counts once. Pinned frames leave the
+ * heap and keep their history.
+ */
+class LruKPolicy : public ReplacementPolicy {
+  static constexpr size_t npos = -1;
+  const size_t k;
+  uint64_t now = 0;
+  size_t last_frame = npos;
+  /// The last k access times of every frame, most recent at `history[frame * k]`
+  std::vector<uint64_t> history;
+  std::vector<size_t> accesses;
+  /// Indexed min-heap of the tracked frames ordered by their backward K-distance
+  std::vector<size_t> heap;
+  std::vector<size_t> heap_pos;
+
+  bool before(size_t a, size_t b) const;
+  void siftUp(size_t i);
+  void siftDown(size_t i);
+  void swap(size_t i, size_t j);
+  void push(size_t frame);
+  void pop(size_t frame);
+  void record(size_t frame);
+
+public:
+  explicit LruKPolicy(size_t num_frames, size_t k = 2);
+  void insert(size_t frame, const PageId &pid) override;
+  void access(size_t frame) override;
+  void erase(size_t frame) override;
+  void setEvictable(size_t frame, bool evictable) override;
+  size_t victim() override;
+};
+
+/**
+ * @brief 2Q.
+ * @details Newly loaded pages enter the A1in FIFO, and hits there do not promote them. When a page is evicted from
+ * A1in its id is remembered in the A1out ghost queue; if it is loaded again while remembered it goes to the Am LRU list.
+ * A sequential scan therefore only cycles through A1in and does not displace the pages in Am.
+ */
+class TwoQueuePolicy : public ReplacementPolicy {
+  static constexpr size_t npos = -1;
+  enum class queue_t : uint8_t { NONE, A1IN, AM };
+
+  struct List {
+    size_t head = npos;
+    size_t tail = npos;
+    size_t size = 0;
+  };
+
+  const size_t kin;
+  const size_t kout;
+  std::vector<size_t> prev;
+  std::vector<size_t> next;
+  std::vector<queue_t> queue;
+  std::vector<bool> pinned;
+  std::vector<PageId> pids;
+  List a1in;
+  List am;
+  /// Ids of the pages recently evicted from a1in, with the sequence number of their eviction
+  std::deque<std::pair<PageId, uint64_t>> a1out;
+  PageTable ghosts;
+  uint64_t evictions = 0;
+
+  void unlink(List &list, size_t frame);
+  void pushFront(List &list, size_t frame);
+  size_t oldestEvictable(const List &list) const;
+  void remember(const PageId &pid);
+
+public:
+  explicit TwoQueuePolicy(size_t num_frames);
+  void insert(size_t frame, const PageId &pid) override;
+  void access(size_t frame) override;
+  void erase(size_t frame) override;
+  void setEvictable(size_t frame, bool evictable) override;
+  size_t victim() override;
+};
+
+/**
+ * @brief Create a replacement policy.
+ * @param policy The kind of policy to create.
+ * @param num_frames The number of frames in the pool.
+ * @return The replacement policy.
+ */
+std::unique_ptr<ReplacementPolicy> makeReplacementPolicy(replacement_t policy, size_t num_frames);
+} // namespace db
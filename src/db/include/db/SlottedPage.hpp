@@ -0,0 +1,158 @@
+#pragma once
+
+#include <db/DbFile.hpp>
+#include <db/Filter.hpp>
+#include <db/TupleView.hpp>
+
+namespace db {
+/**
+ * @brief A view of a page holding tuples of different lengths, located through a slot directory.
+ * @details The page starts with a header of two 16-bit words, the number of slots of the directory and the offset of
+ * the lowest tuple in the page. The directory follows, with the offset and the length of the tuple of each slot,
+ * 16 bits each. Tuples are written from the end of the page towards the directory. An offset of 0 marks an empty
+ * slot, and a zeroed page is an empty page.
+ *
+ * Deleting a tuple empties its slot and leaves a hole among the tuples. Inserts reuse the empty slots, so the slot of
+ * a tuple never changes, and compact the tuples towards the end of the page when the free space is enough for the new
+ * tuple but is not contiguous.
+ */
+class SlottedPage {
+  static constexpr size_t HEADER_SIZE = 2 * sizeof(uint16_t);
+  static constexpr size_t SLOT_SIZE = 2 * sizeof(uint16_t);
+
+  const TupleDesc &td;
+  uint8_t *page;
+
+  uint16_t read(size_t at) const;
+
+  void write(size_t at, uint16_t value);
+
+  size_t numSlots() const { return read(0); }
+
+  /// The offset of the lowest tuple, where the free space ends
+  size_t dataStart() const;
+
+  size_t offset(size_t slot) const { return read(HEADER_SIZE + slot * SLOT_SIZE); }
+
+  size_t length(size_t slot) const { return read(HEADER_SIZE + slot * SLOT_SIZE + sizeof(uint16_t)); }
+
+  /**
+   * @brief Find the first occupied slot at or after the specified slot.
+   * @return The slot, or end() if there is none.
+   */
+  size_t scan(size_t from) const;
+
+  /**
+   * @brief Make room for a tuple in a slot.
+   * @param len The length of the tuple.
+   * @return The offset to write the tuple at, or 0 if the page does not have room for it.
+   */
+  size_t allocate(size_t len);
+
+public:
+  /// The length of the longest tuple a page holds, alone in an empty page
+  static constexpr size_t CAPACITY = DEFAULT_PAGE_SIZE - HEADER_SIZE - SLOT_SIZE;
+
+  /**
+   * @brief Wrap a page with a slotted page.
+   * @param page The page to be wrapped.
+   * @param td The tuple descriptor of the page.
+   */
+  SlottedPage(Page &page, const TupleDesc &td);
+
+  /**
+   * @brief Wrap a page with a slotted page for reading.
+   * @note Only the const methods may be called on a page wrapped this way.
+   */
+  SlottedPage(const Page &page, const TupleDesc &td);
+
+  /**
+   * @brief Get the first occupied slot of the page.
+   */
+  size_t begin() const;
+
+  /**
+   * @brief Get the end of the page, the number of slots of the directory.
+   */
+  size_t end() const { return numSlots(); }
+
+  /**
+   * @brief Count the occupied slots of the page.
+   */
+  size_t size() const;
+
+  /**
+   * @brief Get the length of the longest tuple that can be inserted.
+   * @details The free space between the directory and the tuples, plus the holes left by deletes, less the room of a
+   * new slot when no slot is empty.
+   */
+  size_t freeSpace() const;
+
+  /**
+   * @brief Insert a tuple to the page.
+   * @details The tuple goes to the first empty slot, or to a new slot at the end of the directory. The page is
+   * compacted first if the tuple only fits in the holes left by deletes.
+   * @param t The tuple to be inserted.
+   * @return True if the tuple is inserted, false if the page does not have room for it.
+   */
+  bool insertTuple(const Tuple &t);
+
+  /**
+   * @brief Insert a tuple already serialized by the TupleDesc to the page, as insertTuple().
+   * @param row The `td.length(t)` bytes of the tuple, with the characters of its VARCHAR fields.
+   * @return True if the tuple is inserted, false if the page does not have room for it.
+   */
+  bool insertSerialized(std::span<const uint8_t> row);
+
+  /**
+   * @brief Delete a tuple from the page.
+   * @details The slot becomes empty. The empty slots at the end of the directory are removed.
+   * @param slot The slot of the tuple to be deleted.
+   * @throws std::runtime_error if the slot is out of range or not occupied.
+   */
+  void deleteTuple(size_t slot);
+
+  /**
+   * @brief Move the tuples to the end of the page, so that the free space is contiguous.
+   * @details The slots keep their tuples.
+   */
+  void compact();
+
+  /**
+   * @brief Check if the slot is empty.
+   * @param slot A slot of the directory.
+   */
+  bool empty(size_t slot) const { return offset(slot) == 0; }
+
+  /**
+   * @brief Get the tuple at the specified slot.
+   * @throws std::runtime_error if the slot is out of range or not occupied.
+   */
+  Tuple getTuple(size_t slot) const;
+
+  /**
+   * @brief View the tuple at the specified slot without deserializing it.
+   * @throws std::runtime_error if the slot is out of range or not occupied.
+   */
+  TupleView getTupleView(size_t slot) const;
+
+  /**
+   * @brief Find the occupied slots of `[64 * i, 64 * i + 64)` whose tuple satisfies a filter.
+   * @details The tuples are not evenly spaced, so the filter is evaluated one tuple at a time.
+   * @return The matching slots, slot `64 * i` in the most significant bit.
+   */
+  uint64_t select(size_t i, const Filter &filter) const;
+
+  /**
+   * @brief Append the tuples of some occupied slots to a chunk.
+   * @param slots The slots, in increasing order.
+   * @param chunk The chunk, with room for the tuples.
+   */
+  void decode(std::span<const size_t> slots, DataChunk &chunk) const;
+
+  /**
+   * @brief Advance the slot to the next occupied slot.
+   */
+  void next(size_t &slot) const { slot = scan(slot + 1); }
+};
+} // namespace db
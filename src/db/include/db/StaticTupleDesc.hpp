@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstring>
+#include <db/Tuple.hpp>
+#include <string_view>
+#include <tuple>
+
+namespace db {
+/**
+ * @brief The type of a CHAR field of a StaticTupleDesc, stored in `CHAR_SIZE` bytes as in a TupleDesc.
+ */
+struct Char {};
+
+/**
+ * @brief How a StaticTupleDesc stores a field of a C++ type: `int`, `double` or `Char`.
+ * @details value_type is the type of the field in a row, read() decodes it and view() reads it without copying.
+ */
+template <typename T> struct StaticField;
+
+template <> struct StaticField<int> {
+  static constexpr type_t type = type_t::INT;
+  using value_type = int;
+
+  static void write(uint8_t *data, int value) { std::memcpy(data, &value, INT_SIZE); }
+
+  static int read(const uint8_t *data) {
+    int value;
+    std::memcpy(&value, data, INT_SIZE);
+    return value;
+  }
+
+  static int view(const uint8_t *data) { return read(data); }
+};
+
+template <> struct StaticField<double> {
+  static constexpr type_t type = type_t::DOUBLE;
+  using value_type = double;
+
+  static void write(uint8_t *data, double value) { std::memcpy(data, &value, DOUBLE_SIZE); }
+
+  static double read(const uint8_t *data) {
+    double value;
+    std::memcpy(&value, data, DOUBLE_SIZE);
+    return value;
+  }
+
+  static double view(const uint8_t *data) { return read(data); }
+};
+
+template <> struct StaticField<Char> {
+  static constexpr type_t type = type_t::CHAR;
+  using value_type = std::string;
+
+  /// Truncated to `CHAR_SIZE` bytes and padded with zeros, as by TupleDesc::serialize
+  static void write(uint8_t *data, const std::string &value) {
+    size_t size = strnlen(value.c_str(), CHAR_SIZE);
+    std::memcpy(data, value.data(), size);
+    std::memset(data + size, 0, CHAR_SIZE - size);
+  }
+
+  static std::string read(const uint8_t *data) { return std::string(view(data)); }
+
+  static std::string_view view(const uint8_t *data) {
+    const char *chars = reinterpret_cast<const char *>(data);
+    return {chars, strnlen(chars, CHAR_SIZE)};
+  }
+};
+
+/**
+ * @brief A TupleDesc whose fields are known at compile time, such as `StaticTupleDesc<int, double, Char>`.
+ * @details The offsets and the length are constants, and serialize() and deserialize() are unrolled into one copy
+ * per field, without the loop over the types and the switch of a TupleDesc, or the variants of a Tuple. The rows are
+ * std::tuples of `int`, `double` and `std::string`.
+ *
+ * The serialized rows are those of the TupleDesc returned by desc(), so they can be inserted into a HeapFile or a
+ * BTreeFile of that TupleDesc with insertSerialized(), and get() reads the fields of the TupleViews of their scans
+ * in place. The fields of the TupleViews of a PaxPage are not contiguous: read them with the TupleView instead.
+ */
+template <typename... Fields> class StaticTupleDesc {
+  static constexpr std::array<type_t, sizeof...(Fields)> types{StaticField<Fields>::type...};
+
+  static constexpr std::array<size_t, sizeof...(Fields)> offsets = [] {
+    std::array<size_t, sizeof...(Fields)> offsets{};
+    size_t offset = 0;
+    for (size_t i = 0; i < sizeof...(Fields); i++) {
+      offsets[i] = offset;
+      offset += size_of(types[i]);
+    }
+    return offsets;
+  }();
+
+  template <size_t... I> static void serialize(uint8_t *data, const auto &row, std::index_sequence<I...>) {
+    (StaticField<Fields>::write(data + offsets[I], std::get<I>(row)), ...);
+  }
+
+  template <size_t... I> static auto deserialize(const uint8_t *data, std::index_sequence<I...>) {
+    return row_type{StaticField<Fields>::read(data + offsets[I])...};
+  }
+
+  template <size_t... I> static auto row(const Tuple &t, std::index_sequence<I...>) {
+    return row_type{std::get<typename StaticField<Fields>::value_type>(t.get_field(I))...};
+  }
+
+public:
+  using row_type = std::tuple<typename StaticField<Fields>::value_type...>;
+
+  static constexpr size_t size() { return sizeof...(Fields); }
+
+  static constexpr size_t length() { return (size_of(StaticField<Fields>::type) + ... + 0); }
+
+  static constexpr size_t offset_of(size_t index) { return offsets[index]; }
+
+  static constexpr type_t type_of(size_t index) { return types[index]; }
+
+  /**
+   * @brief Build the TupleDesc of the same fields, to open a HeapFile or a BTreeFile.
+   * @param names The names of the fields.
+   * @throws std::logic_error if the number of names is not the number of fields, or the names are not unique.
+   */
+  static TupleDesc desc(const std::vector<std::string> &names) {
+    return {std::vector<type_t>(types.begin(), types.end()), names};
+  }
+
+  /**
+   * @brief Check if a TupleDesc has the same fields, and so serializes its tuples to the same bytes.
+   */
+  static bool matches(const TupleDesc &td) {
+    if (td.size() != size()) {
+      return false;
+    }
+    for (size_t i = 0; i < size(); i++) {
+      if (td.type_of(i) != types[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Serialize a row into `length()` bytes.
+   */
+  static void serialize(uint8_t *data, const row_type &row) {
+    serialize(data, row, std::index_sequence_for<Fields...>{});
+  }
+
+  /**
+   * @brief Serialize a row, for example to pass it to HeapFile::insertSerialized().
+   */
+  static std::array<uint8_t, length()> serialize(const row_type &row) {
+    std::array<uint8_t, length()> bytes;
+    serialize(bytes.data(), row);
+    return bytes;
+  }
+
+  static row_type deserialize(const uint8_t *data) { return deserialize(data, std::index_sequence_for<Fields...>{}); }
+
+  /**
+   * @brief Read a field of a serialized row in place.
+   * @return The value of an INT or DOUBLE field, a view of the characters of a CHAR field.
+   */
+  template <size_t I> static auto get(const uint8_t *data) {
+    return StaticField<std::tuple_element_t<I, std::tuple<Fields...>>>::view(data + offsets[I]);
+  }
+
+  /**
+   * @brief Convert a row to a Tuple.
+   */
+  static Tuple tuple(const row_type &row) {
+    return std::apply([](const auto &...values) { return Tuple({field_t(values)...}); }, row);
+  }
+
+  /**
+   * @brief Convert a Tuple to a row.
+   * @throws std::bad_variant_access if a field of the Tuple has another type.
+   * @throws std::out_of_range if the Tuple has fewer fields.
+   */
+  static row_type row(const Tuple &t) { return row(t, std::index_sequence_for<Fields...>{}); }
+};
+} // namespace db
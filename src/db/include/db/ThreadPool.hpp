@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace db {
+/**
+ * @brief A fixed set of worker threads that run a task together, for scans split across threads.
+ * @details The threads are started once and sleep between tasks, so a task costs a wake-up rather than a thread
+ * creation. run() hands the same task to every worker and returns when all of them are done: the task splits the work
+ * itself, for example by taking morsels from a ParallelScan.
+ */
+class ThreadPool {
+  std::vector<std::thread> threads;
+  /// Serializes the calls to run()
+  std::mutex run_mutex;
+  std::mutex mutex;
+  std::condition_variable start_cv;
+  std::condition_variable done_cv;
+  const std::function<void(size_t)> *task = nullptr;
+  /// Incremented for each task, so that each worker runs it once
+  size_t generation = 0;
+  /// The number of workers still running the current task
+  size_t running = 0;
+  bool stop = false;
+  /// The first exception thrown by the current task
+  std::exception_ptr error;
+
+  void loop(size_t worker);
+
+public:
+  /**
+   * @brief Start the worker threads.
+   * @param num_threads The number of workers, by default one per hardware thread.
+   * @throws std::invalid_argument if num_threads is 0.
+   */
+  explicit ThreadPool(size_t num_threads = std::max(1u, std::thread::hardware_concurrency()));
+
+  /**
+   * @brief Stop and join the worker threads.
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  size_t size() const { return threads.size(); }
+
+  /**
+   * @brief Run a task on every worker, and wait until all of them return.
+   * @param task Called once by each worker with its index, from 0 to size() - 1.
+   * @throws The first exception thrown by the task, once every worker returned.
+   * @note Concurrent calls run one after the other.
+   */
+  void run(const std::function<void(size_t worker)> &task);
+};
+} // namespace db
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <db/types.hpp>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
@@ -20,6 +21,10 @@ public:
 class TupleDesc {
   std::vector<type_t> types;
   std::vector<size_t> offsets;
+  /// The length of the fixed-size fields of a serialized Tuple, computed once: it is needed for every tuple read
+  size_t bytes = 0;
+  /// Whether a field is a VARCHAR
+  bool variable = false;
   std::unordered_map<std::string, size_t> name_to_index;
 
 public:
@@ -51,6 +56,13 @@ public:
    */
   size_t offset_of(const size_t &index) const;
 
+  /**
+   * @brief Get the type of the field
+   * @param index the index of the field
+   * @return the type of the field
+   */
+  type_t type_of(const size_t &index) const;
+
   /**
    * @brief Get the index of the field
    * @details The index of the field is the position of the field in the Tuple
@@ -67,13 +79,29 @@ public:
 
   /**
    * @brief Get the length of the TupleDesc
-   * @return the number of bytes needed to serialize a Tuple with this TupleDesc
+   * @return the number of bytes needed to serialize a Tuple with this TupleDesc, not counting the characters of its
+   * VARCHAR fields
    */
   size_t length() const;
 
+  /**
+   * @brief Get the length of a serialized Tuple
+   * @param t a Tuple compatible with this TupleDesc
+   * @return the number of bytes needed to serialize the Tuple, including the characters of its VARCHAR fields
+   */
+  size_t length(const Tuple &t) const;
+
+  /**
+   * @brief Check if the serialized Tuples have different lengths
+   * @return true if a field is a VARCHAR, false otherwise
+   */
+  bool variable_length() const;
+
   /**
    * @brief Serialize a Tuple
-   * @param data the buffer to serialize the Tuple into
+   * @details Each VARCHAR field holds the offset of its characters from the start of the Tuple and their number. The
+   * characters follow the fixed-size fields, in the order of the fields.
+   * @param data the buffer to serialize the Tuple into, of `length(t)` bytes
    * @param t the Tuple to serialize
    */
   void serialize(uint8_t *data, const Tuple &t) const;
@@ -85,6 +113,28 @@ public:
    */
   Tuple deserialize(const uint8_t *data) const;
 
+  /**
+   * @brief Serialize a Tuple into the slot of a page stored column by column
+   * @details The field at offset `o` of a serialized Tuple is stored at `minipages + o * slots + slot * size`, where
+   * size is the length of the field
+   * @param minipages the first byte of the columns of the page
+   * @param slots the number of slots of the page
+   * @param slot the slot to serialize the Tuple into
+   * @param t the Tuple to serialize
+   * @throws std::logic_error if a field is a VARCHAR
+   */
+  void serialize(uint8_t *minipages, size_t slots, size_t slot, const Tuple &t) const;
+
+  /**
+   * @brief Deserialize a Tuple from the slot of a page stored column by column
+   * @param minipages the first byte of the columns of the page
+   * @param slots the number of slots of the page
+   * @param slot the slot to deserialize the Tuple from
+   * @return the deserialized Tuple
+   * @throws std::logic_error if a field is a VARCHAR
+   */
+  Tuple deserialize(const uint8_t *minipages, size_t slots, size_t slot) const;
+
   /**
    * @brief Merge two TupleDescs
    * @details The merged TupleDesc has all the fields of the two TupleDescs
@@ -93,5 +143,15 @@ public:
    * @return the merged TupleDesc
    */
   static db::TupleDesc merge(const TupleDesc &td1, const TupleDesc &td2);
+
+  /**
+   * @brief Project a TupleDesc on some of its fields
+   * @details The projected TupleDesc has the selected fields, with their names, in the order of the indexes
+   * @param columns the indexes of the fields to keep
+   * @return the projected TupleDesc
+   * @throws std::out_of_range if an index is out of range
+   * @throws std::logic_error if an index is repeated
+   */
+  TupleDesc project(std::span<const size_t> columns) const;
 };
 } // namespace db
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <db/Tuple.hpp>
+#include <string_view>
+
+namespace db {
+/**
+ * @brief A read-only view of a serialized tuple, in place in its page.
+ * @details The accessors decode a single field from the bytes of the slot at the offset given by the TupleDesc, so
+ * reading a field allocates nothing. A Tuple is only built when materialize() is called.
+ * A Projection views some fields of a row: the view then has the fields of the projected TupleDesc, read at their
+ * offsets in the full row.
+ *
+ * A view of a slot of a PaxPage reads each field from the minipage of its column: the field at offset `o` in a row is
+ * at `data + o * slots + slot * size_of(type)`, where `slots` is the number of slots of the page.
+ * @note The view does not own the bytes: it is valid as long as the page it points into stays pinned.
+ */
+class TupleView {
+  const TupleDesc *td;
+  const uint8_t *data;
+  /// The offsets of the fields in the row when the view projects a wider row, nullptr otherwise
+  const size_t *offsets = nullptr;
+  /// The number of slots of the PaxPage the view points into, 0 for a row stored contiguously
+  size_t slots = 0;
+  /// The slot of the tuple in its PaxPage
+  size_t slot = 0;
+
+  friend class Projection;
+  friend class PaxPage;
+
+  TupleView(const TupleDesc &td, const uint8_t *data, const size_t *offsets, size_t slots = 0, size_t slot = 0)
+      : td(&td), data(data), offsets(offsets), slots(slots), slot(slot) {}
+
+  size_t offset_of(size_t i) const { return offsets ? offsets[i] : td->offset_of(i); }
+
+  /// The first byte of field i
+  const uint8_t *field(size_t i) const {
+    return slots == 0 ? data + offset_of(i) : data + offset_of(i) * slots + slot * size_of(td->type_of(i));
+  }
+
+public:
+  /**
+   * @brief View the tuple serialized at the specified address.
+   * @param td the tuple descriptor of the tuple.
+   * @param data the first byte of the tuple.
+   */
+  TupleView(const TupleDesc &td, const uint8_t *data) : td(&td), data(data) {}
+
+  /**
+   * @brief Get the first byte of the serialized tuple, the full row for a projected view.
+   * @note The fields of a view of a PaxPage are not contiguous: this is then the first byte of the minipages.
+   */
+  const uint8_t *bytes() const { return data; }
+
+  /**
+   * @brief Get the number of fields of the tuple.
+   */
+  size_t size() const;
+
+  type_t field_type(size_t i) const;
+
+  /**
+   * @brief Read an INT field.
+   * @throws std::logic_error if the field is not an INT.
+   */
+  int get_int(size_t i) const;
+
+  /**
+   * @brief Read a DOUBLE field.
+   * @throws std::logic_error if the field is not a DOUBLE.
+   */
+  double get_double(size_t i) const;
+
+  /**
+   * @brief Read a CHAR or VARCHAR field.
+   * @return The characters of the field, up to its first NUL for a CHAR, in place in the page.
+   * @throws std::logic_error if the field is not a CHAR or a VARCHAR.
+   */
+  std::string_view get_string_view(size_t i) const;
+
+  /**
+   * @brief Copy a field out of the page.
+   */
+  field_t get_field(size_t i) const;
+
+  /**
+   * @brief Copy the tuple out of the page.
+   * @return The deserialized Tuple.
+   */
+  Tuple materialize() const;
+};
+} // namespace db
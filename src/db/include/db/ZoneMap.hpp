@@ -0,0 +1,151 @@
+#pragma once
+
+#include <db/DbFile.hpp>
+#include <db/Filter.hpp>
+#include <mutex>
+#include <vector>
+
+namespace db {
+/**
+ * @brief Counters describing how many pages a ZoneMap let scans skip.
+ */
+struct ZoneMapStats {
+  /// Number of pages whose zone was checked against a filter
+  size_t pages_checked = 0;
+
+  /// Number of pages skipped because no tuple of the page could satisfy the filter
+  size_t pages_skipped = 0;
+
+  /// Number of bytes of the skipped pages, neither read nor decoded
+  size_t bytes_skipped = 0;
+};
+
+/**
+ * @brief Summarizes the INT and DOUBLE fields of each page of a HeapFile, so that filtered scans skip whole pages.
+ * @details The zone of a page holds the number of tuples of the page and the smallest and largest value of each INT
+ * and DOUBLE field, as doubles, which hold every int exactly. Inserts widen the zone of their page. Deletes only
+ * decrement the count, so a zone may be wider than the values left in its page, but never narrower, until the page
+ * is empty and the zone is reset.
+ *
+ * The map is stored in a file of its own, next to the heap file: a header page, then the zones, packed as many to a
+ * page as fit. The header records whether the zones were written after the last change. The first change after the
+ * map is loaded or flushed clears that mark on disk, so that a map that was not flushed, for example after a crash,
+ * is discarded the next time it is loaded. The zones of the pages the map does not cover are unknown and never
+ * skipped, until the page is emptied.
+ *
+ * Filters only consult the map before reading a page: the bounds of a page that is being changed may lag behind
+ * its tuples, as a scan that read the page just before the change would.
+ */
+class ZoneMap {
+  mutable std::mutex mutex;
+  DbFile file;
+  /// The indexes of the INT and DOUBLE fields
+  std::vector<size_t> columns;
+  /// The offsets of those fields in a serialized tuple
+  std::vector<size_t> offsets;
+  /// Whether each of those fields is an INT rather than a DOUBLE
+  std::vector<bool> ints;
+  /// The number of bytes of a zone in the map file
+  size_t zone_size;
+  size_t zones_per_page;
+  /// The number of tuples of each page
+  std::vector<uint32_t> counts;
+  /// Whether the zone of each page is known
+  std::vector<bool> known;
+  /// The smallest and largest value of each field, `2 * columns.size()` values per page
+  std::vector<double> bounds;
+  /// Whether each page of zones changed since it was last written
+  std::vector<bool> dirty;
+  /// Whether the map file is marked as up to date
+  bool clean_on_disk = false;
+  mutable ZoneMapStats stats;
+
+  void resize(size_t pages, bool covered);
+
+  void reset(size_t page);
+
+  /**
+   * @brief Clear the up-to-date mark of the map file before the first change to the zones.
+   */
+  void touch();
+
+  void writeHeader(bool clean);
+
+  /**
+   * @brief Widen the zone of a page with the values of a tuple inserted into it.
+   * @param value Called with the index of each field in columns, returns its value.
+   */
+  template <typename F> void widen(size_t page, F &&value);
+
+public:
+  /**
+   * @brief Open or create the map file.
+   * @param name The name of the map file.
+   * @param td The tuple descriptor of the heap file.
+   * @param pages The number of pages of the heap file.
+   * @throws std::runtime_error if the map file cannot be opened or read.
+   * @throws std::invalid_argument if the zone of a page does not fit in a page of the map file.
+   */
+  ZoneMap(const std::string &name, const TupleDesc &td, size_t pages);
+
+  /**
+   * @brief Write back the map, ignoring errors.
+   */
+  ~ZoneMap();
+
+  /**
+   * @brief Widen the zone of a page with a tuple inserted into it. The map grows to cover the page if needed.
+   * @throws std::runtime_error if the map file cannot be marked as out of date.
+   */
+  void add(size_t page, const Tuple &t);
+
+  /**
+   * @brief Widen the zone of a page with a tuple inserted into it, as serialized by the TupleDesc.
+   * @throws std::runtime_error if the map file cannot be marked as out of date.
+   */
+  void add(size_t page, const uint8_t *row);
+
+  /**
+   * @brief Record that a tuple was deleted from a page.
+   * @param page The page.
+   * @param remaining The number of tuples left in the page. The zone of a page left empty is reset, even if it was
+   * unknown.
+   * @throws std::runtime_error if the map file cannot be marked as out of date.
+   */
+  void remove(size_t page, size_t remaining);
+
+  /**
+   * @brief Check if a tuple of a page may satisfy a filter.
+   * @return false if the page is known to be empty, or if the zone of a field excludes every value the filter
+   * accepts.
+   */
+  bool mayMatch(size_t page, const Filter &filter) const;
+
+  /**
+   * @brief Whether the zone of a page is known.
+   */
+  bool covers(size_t page) const;
+
+  /**
+   * @brief Get the number of tuples of a page.
+   * @param page A page the map covers.
+   */
+  size_t count(size_t page) const;
+
+  /**
+   * @brief Get the smallest and largest value of a field in a page.
+   * @param page A page the map covers.
+   * @param column The index of an INT or DOUBLE field.
+   * @throws std::invalid_argument if the field is not an INT or a DOUBLE.
+   */
+  std::pair<double, double> range(size_t page, size_t column) const;
+
+  ZoneMapStats getStats() const;
+
+  /**
+   * @brief Write the pages of the map that changed to the map file, and mark it as up to date.
+   * @throws std::runtime_error if a write fails.
+   */
+  void flush();
+};
+} // namespace db
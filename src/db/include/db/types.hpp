@@ -2,6 +2,7 @@
 
 #include <array>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <cstdint>
@@ -10,19 +11,68 @@ namespace db {
 constexpr size_t INT_SIZE = sizeof(int);
 constexpr size_t DOUBLE_SIZE = sizeof(double);
 constexpr size_t CHAR_SIZE = 64;
+/// A VARCHAR field holds the offset of its characters from the start of the tuple and their number, 16 bits each
+constexpr size_t VARCHAR_SIZE = 2 * sizeof(uint16_t);
 
-enum class type_t { INT, CHAR, DOUBLE };
+/**
+ * @brief The type of a field.
+ * @details CHAR strings are stored in a fixed field of `CHAR_SIZE` bytes and truncated to fit. VARCHAR strings are
+ * stored whole after the fixed-size fields of the tuple, which then has a variable length.
+ */
+enum class type_t { INT, CHAR, DOUBLE, VARCHAR };
+
+/**
+ * @brief The number of bytes a field of the type takes in the fixed-size part of a serialized tuple.
+ */
+constexpr size_t size_of(type_t type) {
+  switch (type) {
+  case type_t::INT:
+    return INT_SIZE;
+  case type_t::DOUBLE:
+    return DOUBLE_SIZE;
+  case type_t::CHAR:
+    return CHAR_SIZE;
+  case type_t::VARCHAR:
+    return VARCHAR_SIZE;
+  }
+  return 0;
+}
 
 using field_t = std::variant<int, double, std::string>;
 
+/// Id assigned to a file by the Database catalog. Id 0 is never assigned.
+using file_id_t = uint32_t;
+
+/**
+ * @brief Identifies a page by the id of its file and its page number.
+ * @details A PageId is a trivially copyable 64-bit value, so it can be hashed and compared without touching memory.
+ * The default PageId, with file 0, does not refer to any page.
+ */
 struct PageId {
-  std::string file;
-  size_t page;
+  file_id_t file = 0;
+  uint32_t page = 0;
+
+  PageId() = default;
+
+  constexpr PageId(file_id_t file, size_t page) : file(file), page(static_cast<uint32_t>(page)) {}
+
+  /**
+   * @brief Identifies a page of a file by the name the file was added to the Database with.
+   * @throws std::out_of_range if no file with that name is in the Database.
+   * @note This looks up the catalog: hot paths should use the id of the file instead.
+   */
+  PageId(const std::string &file, size_t page);
+
+  /**
+   * @brief The file id in the high half and the page number in the low half.
+   */
+  constexpr uint64_t key() const { return static_cast<uint64_t>(file) << 32 | page; }
 
-public:
   bool operator==(const PageId &) const = default;
 };
 
+static_assert(sizeof(PageId) == sizeof(uint64_t) && std::is_trivially_copyable_v<PageId>);
+
 constexpr size_t DEFAULT_PAGE_SIZE = 4096;
 
 using Page = std::array<uint8_t, DEFAULT_PAGE_SIZE>;
@@ -30,6 +80,11 @@ using Page = std::array<uint8_t, DEFAULT_PAGE_SIZE>;
 
 template <> struct std::hash<const db::PageId> {
   std::size_t operator()(const db::PageId &r) const {
-    return std::hash<std::string>()(r.file) ^ std::hash<size_t>()(r.page);
+    // Finalizer of MurmurHash3: every bit of the key affects every bit of the hash
+    uint64_t h = r.key();
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
   }
 };
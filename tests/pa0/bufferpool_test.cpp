@@ -2,6 +2,7 @@
 
 #include <db/Database.hpp>
 #include <db/DbFile.hpp>
+#include <thread>
 
 TEST(BufferPoolTest, getPage) {
   db::Database &db = db::getDatabase();
@@ -10,6 +11,7 @@ TEST(BufferPoolTest, getPage) {
   std::string name{"file"};
   db::TupleDesc td;
   db.add(std::make_unique<db::DbFile>(name, td));
+  db.get(name).setTrace(1024);
   std::array<db::Page *, db::DEFAULT_NUM_PAGES> pages{};
   for (size_t i = 0; i < db::DEFAULT_NUM_PAGES; i++) {
     pages[i] = &bufferPool.getPage({name, i});
@@ -37,6 +39,7 @@ TEST(BufferPoolTest, getPageMultipleFiles) {
   for (size_t i = 0; i < db::DEFAULT_NUM_PAGES; i++) {
     auto file = std::make_unique<db::DbFile>(std::to_string(i), td);
     files[i] = file.get();
+    file->setTrace(db::DEFAULT_NUM_PAGES);
     db.add(std::move(file));
   }
   std::array<db::Page *, db::DEFAULT_NUM_PAGES> pages{};
@@ -65,6 +68,7 @@ TEST(BufferPoolTest, eviction) {
   std::string name{"file"};
   db::TupleDesc td;
   db.add(std::make_unique<db::DbFile>(name, td));
+  db.get(name).setTrace(1024);
   std::array<db::Page *, db::DEFAULT_NUM_PAGES> pages{};
   for (size_t i = 0; i < db::DEFAULT_NUM_PAGES; i++) {
     pages[i] = &bufferPool.getPage({name, i});
@@ -95,6 +99,7 @@ TEST(BufferPoolTest, markDirty) {
   std::string name{"file"};
   db::TupleDesc td;
   db.add(std::make_unique<db::DbFile>(name, td));
+  db.get(name).setTrace(1024);
   std::array<db::Page *, db::DEFAULT_NUM_PAGES> pages{};
   for (size_t i = 0; i < db::DEFAULT_NUM_PAGES; i++) {
     pages[i] = &bufferPool.getPage({name, i});
@@ -128,6 +133,7 @@ TEST(BufferPoolTest, flushPage) {
   std::string name{"file"};
   db::TupleDesc td;
   db.add(std::make_unique<db::DbFile>(name, td));
+  db.get(name).setTrace(1024);
   db::PageId pid{name, 0};
   bufferPool.getPage(pid);
   bufferPool.markDirty(pid);
@@ -154,6 +160,7 @@ TEST(BufferPoolTest, discardPage) {
   std::string name{"file"};
   db::TupleDesc td;
   db.add(std::make_unique<db::DbFile>(name, td));
+  db.get(name).setTrace(1024);
   db::PageId pid{name, 0};
   bufferPool.getPage(pid);
   bufferPool.markDirty(pid);
@@ -171,6 +178,48 @@ TEST(BufferPoolTest, discardPage) {
   EXPECT_EQ(writes.size(), 0);
 }
 
+TEST(BufferPoolTest, discardPages) {
+  constexpr size_t size = 100;
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = size,
+                          .background_flush = true,
+                          .flush_high_watermark = 0.5,
+                          .flush_low_watermark = 0,
+                          .read_ahead = db::read_ahead_t::PREADV,
+                          .read_ahead_window = 8});
+  db::BufferPool &bufferPool = db.getBufferPool();
+
+  std::string name{"discarded"};
+  std::remove(name.c_str());
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  db.get(name).setTrace(1024);
+  db::file_id_t id = db.get(name).getId();
+  for (size_t i = 0; i < size; i++) {
+    db::WritePageGuard guard = bufferPool.fetchWrite({id, i});
+    (*guard)[0] = static_cast<uint8_t>(i);
+  }
+  // The flusher is writing the pages and a sequential read queues read-ahead of the tail
+  for (size_t i = 0; i < 10; i++) {
+    bufferPool.fetchRead({id, i});
+  }
+  bufferPool.discardPages(id, size / 2);
+  size_t written = db.get(name).getWrites().size();
+  for (size_t i = 0; i < size; i++) {
+    EXPECT_EQ(bufferPool.contains({id, i}), i < size / 2);
+  }
+
+  // Only the kept pages are written from now on
+  bufferPool.flushFile(id);
+  EXPECT_EQ(bufferPool.getStats().dirty_pages, 0);
+  const std::vector<size_t> &writes = db.get(name).getWrites();
+  for (size_t i = written; i < writes.size(); i++) {
+    EXPECT_LT(writes[i], size / 2);
+  }
+  db.remove(name);
+  std::remove(name.c_str());
+}
+
 TEST(BefferPoolTest, flushFile) {
   constexpr size_t size = 10;
   db::Database &db = db::getDatabase();
@@ -179,6 +228,7 @@ TEST(BefferPoolTest, flushFile) {
   std::string name{"file"};
   db::TupleDesc td;
   db.add(std::make_unique<db::DbFile>(name, td));
+  db.get(name).setTrace(1024);
   for (size_t i = 0; i < size; i++) {
     db::PageId pid{name, i};
     bufferPool.getPage(pid);
@@ -207,6 +257,7 @@ TEST(BufferPoolTest, LRU) {
   std::string name{"file"};
   db::TupleDesc td;
   db.add(std::make_unique<db::DbFile>(name, td));
+  db.get(name).setTrace(1024);
   std::array<db::Page *, db::DEFAULT_NUM_PAGES> pages{};
   // fill the buffer pool with pages [0, DEFAULT_NUM_PAGES)
   for (size_t i = 0; i < db::DEFAULT_NUM_PAGES; i++) {
@@ -227,8 +278,8 @@ TEST(BufferPoolTest, LRU) {
   }
 
   const db::DbFile &file = db.get(name);
-  const auto &reads = file.getReads();
-  const auto &writes = file.getWrites();
+  auto reads = file.getReads();
+  auto writes = file.getWrites();
   EXPECT_EQ(reads.size(), db::DEFAULT_NUM_PAGES + size);
   EXPECT_EQ(writes.size(), size);
 
@@ -236,6 +287,8 @@ TEST(BufferPoolTest, LRU) {
   for (size_t i = size; i < size + size; i++) {
     bufferPool.getPage({name, i});
   }
+  reads = file.getReads();
+  writes = file.getWrites();
   EXPECT_EQ(reads.size(), db::DEFAULT_NUM_PAGES + size + size);
   EXPECT_EQ(writes.size(), size + size);
   for (size_t i = 0; i < db::DEFAULT_NUM_PAGES + size; i++) {
@@ -249,3 +302,399 @@ TEST(BufferPoolTest, LRU) {
     EXPECT_EQ(writes[i], size + i);
   }
 }
+
+TEST(BufferPoolTest, configureSize) {
+  constexpr size_t size = 500;
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = size});
+  db::BufferPool &bufferPool = db.getBufferPool();
+  EXPECT_EQ(bufferPool.size(), size);
+
+  std::string name{"file"};
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  for (size_t i = 0; i < size; i++) {
+    db::Page &page = bufferPool.getPage({name, i});
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(page.data()) % db::DEFAULT_PAGE_SIZE, 0);
+  }
+  for (size_t i = 0; i < size; i++) {
+    EXPECT_TRUE(bufferPool.contains({name, i}));
+  }
+  bufferPool.getPage({name, size});
+  EXPECT_FALSE(bufferPool.contains({name, 0}));
+
+  const db::BufferPoolStats &stats = bufferPool.getStats();
+  EXPECT_EQ(stats.hits, 0);
+  EXPECT_EQ(stats.misses, size + 1);
+  EXPECT_EQ(stats.evictions, 1);
+}
+
+TEST(BufferPoolTest, configureFlushesDirtyPages) {
+  db::Database &db = db::getDatabase();
+  std::string name{"file"};
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  db.get(name).setTrace(1024);
+  db::PageId pid{name, 0};
+  db.getBufferPool().getPage(pid);
+  db.getBufferPool().markDirty(pid);
+
+  db.configureBufferPool({.num_pages = 1000, .huge_pages = true});
+  EXPECT_FALSE(db.getBufferPool().contains(pid));
+  EXPECT_EQ(db.get(name).getWrites().size(), 1);
+  EXPECT_EQ(db.getBufferPool().size(), 1000);
+  EXPECT_ANY_THROW(db.configureBufferPool({.num_pages = 0}));
+  // A pool the BufferPool rejects leaves the current one in place
+  EXPECT_ANY_THROW(db.configureBufferPool({.num_pages = 4, .num_shards = 8}));
+  EXPECT_ANY_THROW(db.configureBufferPool({.flush_high_watermark = 1.5}));
+  EXPECT_EQ(db.getBufferPool().size(), 1000);
+  db.getBufferPool().getPage(pid);
+  EXPECT_TRUE(db.getBufferPool().contains(pid));
+}
+
+TEST(BufferPoolTest, pinnedPagesAreNotEvicted) {
+  db::Database &db = db::getDatabase();
+  db::BufferPool &bufferPool = db.getBufferPool();
+
+  std::string name{"file"};
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  db::ReadPageGuard guard = bufferPool.fetchRead({name, 0});
+  EXPECT_TRUE(bufferPool.isPinned({name, 0}));
+  EXPECT_ANY_THROW(bufferPool.discardPage({name, 0}));
+
+  // Cycle through twice as many pages as the pool holds: page 0 is the least recently used but stays
+  for (size_t i = 1; i < 2 * db::DEFAULT_NUM_PAGES; i++) {
+    bufferPool.getPage({name, i});
+  }
+  EXPECT_TRUE(bufferPool.contains({name, 0}));
+  EXPECT_EQ(&*guard, &bufferPool.getPage({name, 0}));
+
+  guard.release();
+  EXPECT_FALSE(bufferPool.isPinned({name, 0}));
+  EXPECT_FALSE(bufferPool.isDirty({name, 0}));
+  EXPECT_NO_THROW(bufferPool.discardPage({name, 0}));
+}
+
+TEST(BufferPoolTest, allPagesPinned) {
+  db::Database &db = db::getDatabase();
+  db::BufferPool &bufferPool = db.getBufferPool();
+
+  std::string name{"file"};
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  std::vector<db::ReadPageGuard> guards;
+  for (size_t i = 0; i < db::DEFAULT_NUM_PAGES; i++) {
+    guards.push_back(bufferPool.fetchRead({name, i}));
+  }
+  // Pinning a page twice is allowed
+  EXPECT_NO_THROW(bufferPool.fetchRead({name, 0}));
+  EXPECT_ANY_THROW(bufferPool.getPage({name, db::DEFAULT_NUM_PAGES}));
+  guards.pop_back();
+  EXPECT_NO_THROW(bufferPool.getPage({name, db::DEFAULT_NUM_PAGES}));
+  EXPECT_FALSE(bufferPool.contains({name, db::DEFAULT_NUM_PAGES - 1}));
+}
+
+TEST(BufferPoolTest, writeGuardMarksDirty) {
+  db::Database &db = db::getDatabase();
+  db::BufferPool &bufferPool = db.getBufferPool();
+
+  std::string name{"file"};
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  db::PageId pid{name, 0};
+  {
+    db::WritePageGuard guard = bufferPool.fetchWrite(pid);
+    (*guard)[0] = 42;
+    EXPECT_FALSE(bufferPool.isDirty(pid));
+    db::WritePageGuard moved = std::move(guard);
+    EXPECT_FALSE(guard);
+    EXPECT_TRUE(bufferPool.isPinned(pid));
+  }
+  EXPECT_FALSE(bufferPool.isPinned(pid));
+  EXPECT_TRUE(bufferPool.isDirty(pid));
+  bufferPool.flushPage(pid);
+  bufferPool.discardPage(pid);
+  EXPECT_EQ(bufferPool.fetchRead(pid)->at(0), 42);
+}
+
+TEST(BufferPoolTest, shards) {
+  constexpr size_t size = 64;
+  db::Database &db = db::getDatabase();
+  EXPECT_ANY_THROW(db.configureBufferPool({.num_pages = size, .num_shards = 0}));
+  EXPECT_ANY_THROW(db.configureBufferPool({.num_pages = size, .num_shards = size + 1}));
+  db.configureBufferPool({.num_pages = size, .num_shards = 4});
+  db::BufferPool &bufferPool = db.getBufferPool();
+
+  std::string name{"file"};
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  for (size_t i = 0; i < 4 * size; i++) {
+    db::WritePageGuard guard = bufferPool.fetchWrite({name, i});
+    (*guard)[0] = static_cast<uint8_t>(i);
+  }
+  // Each shard evicts its own pages, so the pool never holds more pages than it has frames
+  size_t cached = 0;
+  for (size_t i = 0; i < 4 * size; i++) {
+    cached += bufferPool.contains({name, i});
+  }
+  EXPECT_LE(cached, size);
+  for (size_t i = 0; i < 4 * size; i++) {
+    EXPECT_EQ(bufferPool.fetchRead({name, i})->at(0), static_cast<uint8_t>(i));
+  }
+  db::BufferPoolStats stats = bufferPool.getStats();
+  EXPECT_EQ(stats.hits + stats.misses, 8 * size);
+}
+
+TEST(BufferPoolTest, concurrentGuards) {
+  constexpr size_t num_threads = 8;
+  constexpr size_t num_pages = 64;
+  constexpr size_t increments = 2000;
+  db::Database &db = db::getDatabase();
+  // Every shard has a frame for each thread, wherever the pinned pages hash
+  db.configureBufferPool({.num_pages = 32, .num_shards = 2});
+  db::BufferPool &bufferPool = db.getBufferPool();
+
+  std::string name{"counters"};
+  std::remove(name.c_str());
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+
+  // Every thread increments a counter on each page while others read it: the write latch makes increments atomic and
+  // eviction under contention must never lose an update
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&bufferPool, &name, t] {
+      for (size_t i = 0; i < increments; i++) {
+        db::PageId pid{name, (t + i) % num_pages};
+        if (i % 2 == 0) {
+          db::WritePageGuard guard = bufferPool.fetchWrite(pid);
+          ++*reinterpret_cast<uint32_t *>(guard->data());
+        } else {
+          db::ReadPageGuard guard = bufferPool.fetchRead(pid);
+          EXPECT_LE(*reinterpret_cast<const uint32_t *>(guard->data()), num_threads * increments);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  size_t total = 0;
+  for (size_t i = 0; i < num_pages; i++) {
+    total += *reinterpret_cast<const uint32_t *>(bufferPool.fetchRead({name, i})->data());
+  }
+  EXPECT_EQ(total, num_threads * increments / 2);
+  db.remove(name);
+  std::remove(name.c_str());
+}
+
+TEST(BufferPoolTest, backgroundFlush) {
+  constexpr size_t size = 100;
+  db::Database &db = db::getDatabase();
+  EXPECT_ANY_THROW(db.configureBufferPool({.flush_high_watermark = 0.1, .flush_low_watermark = 0.2}));
+  EXPECT_ANY_THROW(db.configureBufferPool({.flush_high_watermark = 1.5}));
+  db.configureBufferPool(
+      {.num_pages = size, .background_flush = true, .flush_high_watermark = 0.5, .flush_low_watermark = 0});
+  db::BufferPool &bufferPool = db.getBufferPool();
+
+  std::string name{"flushed"};
+  std::remove(name.c_str());
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  db.get(name).setTrace(1024);
+  for (size_t i = 0; i < size; i++) {
+    db::WritePageGuard guard = bufferPool.fetchWrite({name, i});
+    (*guard)[0] = static_cast<uint8_t>(i);
+  }
+  // Crossing the high watermark wakes the flusher, which sweeps down to the low watermark: every page dirty at the
+  // crossing is written in the background. Pages dirtied after a sweep ends stay dirty until the next crossing.
+  for (int i = 0; i < 5000 && bufferPool.getStats().background_writes <= size / 2; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_GT(bufferPool.getStats().background_writes, size / 2);
+  bufferPool.flushFile(name);
+  db::BufferPoolStats stats = bufferPool.getStats();
+  EXPECT_EQ(stats.dirty_pages, 0);
+  EXPECT_LE(stats.background_writes, size);
+  EXPECT_EQ(db.get(name).getWrites().size(), size);
+
+  // Every victim is clean, so no eviction writes
+  for (size_t i = size; i < 2 * size; i++) {
+    bufferPool.getPage({name, i});
+  }
+  stats = bufferPool.getStats();
+  EXPECT_EQ(stats.evictions, size);
+  EXPECT_EQ(stats.sync_writes, 0);
+  for (size_t i = 0; i < size; i++) {
+    EXPECT_EQ(bufferPool.fetchRead({name, i})->at(0), static_cast<uint8_t>(i));
+  }
+  db.remove(name);
+  std::remove(name.c_str());
+}
+
+TEST(BufferPoolTest, failedWriteBack) {
+  constexpr size_t size = 4;
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = size});
+  db::BufferPool &bufferPool = db.getBufferPool();
+
+  // Reads of /dev/full return zeros and writes fail with ENOSPC
+  std::string name{"/dev/full"};
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  db::PageId pid{name, 0};
+  bufferPool.fetchWrite(pid);
+  EXPECT_THROW(bufferPool.flushPage(pid), std::runtime_error);
+  EXPECT_TRUE(bufferPool.isDirty(pid));
+  EXPECT_FALSE(bufferPool.isPinned(pid));
+  // The latch was released: the page can be written again
+  bufferPool.fetchWrite(pid);
+
+  // Evicting the page fails too, and leaves it in the pool
+  for (size_t i = 1; i < size; i++) {
+    bufferPool.getPage({name, i});
+  }
+  EXPECT_THROW(bufferPool.getPage({name, size}), std::runtime_error);
+  EXPECT_TRUE(bufferPool.contains(pid));
+  EXPECT_TRUE(bufferPool.isDirty(pid));
+
+  bufferPool.discardPage(pid);
+  db.remove(name);
+}
+
+TEST(BufferPoolTest, syncWrites) {
+  constexpr size_t size = 100;
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = size});
+  db::BufferPool &bufferPool = db.getBufferPool();
+
+  std::string name{"file"};
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  for (size_t i = 0; i < size; i++) {
+    bufferPool.fetchWrite({name, i});
+  }
+  EXPECT_EQ(bufferPool.getStats().dirty_pages, size);
+  // Without the flusher every victim is dirty
+  for (size_t i = size; i < 2 * size; i++) {
+    bufferPool.getPage({name, i});
+  }
+  db::BufferPoolStats stats = bufferPool.getStats();
+  EXPECT_EQ(stats.sync_writes, size);
+  EXPECT_EQ(stats.background_writes, 0);
+  EXPECT_EQ(stats.dirty_pages, 0);
+}
+
+TEST(BufferPoolTest, coalescedFlush) {
+  constexpr size_t size = 64;
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = size, .sync_on_flush = true});
+  db::BufferPool &bufferPool = db.getBufferPool();
+
+  std::string name{"coalesced"};
+  std::remove(name.c_str());
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  db.get(name).setTrace(1024);
+  // Dirty two runs of pages in reverse order
+  for (size_t i = size; i-- > 0;) {
+    if (i != size / 2) {
+      bufferPool.fetchWrite({name, i});
+    }
+  }
+  bufferPool.flushFile(name);
+  db::BufferPoolStats stats = bufferPool.getStats();
+  EXPECT_EQ(stats.dirty_pages, 0);
+  EXPECT_EQ(stats.write_calls, 2);
+  EXPECT_EQ(stats.bytes_written, (size - 1) * db::DEFAULT_PAGE_SIZE);
+  const std::vector<size_t> &writes = db.get(name).getWrites();
+  EXPECT_EQ(writes.size(), size - 1);
+  EXPECT_TRUE(std::is_sorted(writes.begin(), writes.end()));
+  db.remove(name);
+  std::remove(name.c_str());
+}
+
+namespace {
+// Writes the page number at the start of every page, then reads the file sequentially with read-ahead enabled
+db::BufferPoolStats scanWithReadAhead(db::read_ahead_t read_ahead) {
+  constexpr size_t size = 64;
+  constexpr size_t file_pages = 4 * size;
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = size});
+
+  std::string name{"scanned"};
+  std::remove(name.c_str());
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  for (size_t i = 0; i < file_pages; i++) {
+    db::WritePageGuard guard = db.getBufferPool().fetchWrite({name, i});
+    *reinterpret_cast<uint32_t *>(guard->data()) = i;
+  }
+  db.remove(name);
+  db.add(std::make_unique<db::DbFile>(name, td));
+
+  db.configureBufferPool({.num_pages = size, .read_ahead = read_ahead, .read_ahead_window = 16});
+  db::BufferPool &bufferPool = db.getBufferPool();
+  db::file_id_t id = db.get(name).getId();
+  for (size_t i = 0; i < file_pages; i++) {
+    EXPECT_EQ(*reinterpret_cast<const uint32_t *>(bufferPool.fetchRead({id, i})->data()), i);
+    // Let the read-ahead thread run on a single core
+    std::this_thread::yield();
+  }
+  db::BufferPoolStats stats = bufferPool.getStats();
+  db.remove(name);
+  std::remove(name.c_str());
+  return stats;
+}
+} // namespace
+
+TEST(BufferPoolTest, readAheadFadvise) {
+  db::BufferPoolStats stats = scanWithReadAhead(db::read_ahead_t::FADVISE);
+  // The kernel reads ahead into its page cache: every page is still a miss of the pool
+  EXPECT_EQ(stats.misses, 256);
+  EXPECT_EQ(stats.read_ahead_pages, 0);
+}
+
+TEST(BufferPoolTest, readAheadPreadv) {
+  db::BufferPoolStats stats = scanWithReadAhead(db::read_ahead_t::PREADV);
+  EXPECT_EQ(stats.hits + stats.misses, 256);
+  EXPECT_GT(stats.read_ahead_pages, 0);
+  EXPECT_LE(stats.read_ahead_pages + stats.misses, 256 + 16);
+}
+
+TEST(BufferPoolTest, readAheadSmallPool) {
+  constexpr size_t size = 8;
+  constexpr size_t file_pages = 64;
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = size});
+  std::string name{"small"};
+  std::remove(name.c_str());
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  for (size_t i = 0; i < file_pages; i++) {
+    db::WritePageGuard guard = db.getBufferPool().fetchWrite({name, i});
+    *reinterpret_cast<uint32_t *>(guard->data()) = i;
+  }
+  db.remove(name);
+  db.add(std::make_unique<db::DbFile>(name, td));
+
+  // The default window is larger than the pool: it is clamped to a quarter of the frames
+  db.configureBufferPool({.num_pages = size, .read_ahead = db::read_ahead_t::PREADV});
+  db::BufferPool &bufferPool = db.getBufferPool();
+  EXPECT_EQ(bufferPool.getOptions().read_ahead_window, size / 4);
+  db::file_id_t id = db.get(name).getId();
+  // A scan that holds the previous page while it reads the next always finds a frame
+  db::ReadPageGuard previous = bufferPool.fetchRead({id, 0});
+  for (size_t i = 1; i < file_pages; i++) {
+    db::ReadPageGuard guard = bufferPool.fetchRead({id, i});
+    EXPECT_EQ(*reinterpret_cast<const uint32_t *>(guard->data()), i);
+    previous = std::move(guard);
+    std::this_thread::yield();
+  }
+  previous.release();
+  EXPECT_GT(bufferPool.getStats().read_ahead_pages, 0);
+  db.remove(name);
+  std::remove(name.c_str());
+}
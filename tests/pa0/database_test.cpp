@@ -116,3 +116,59 @@ TEST(DatabaseTest, MultipleOperations) {
   db.add(std::move(file));
   EXPECT_EQ(expected, &db.get(name2));
 }
+
+TEST(DatabaseTest, FileIds) {
+  db::Database &db = db::getDatabase();
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>("test1", td));
+  db.add(std::make_unique<db::DbFile>("test2", td));
+  db::file_id_t id1 = db.get("test1").getId();
+  db::file_id_t id2 = db.get("test2").getId();
+  EXPECT_NE(id1, 0);
+  EXPECT_NE(id1, id2);
+  EXPECT_EQ(&db.get(id1), &db.get("test1"));
+  EXPECT_EQ(db::PageId("test2", 7), db::PageId(id2, 7));
+
+  // A file added again under the same name gets a new id, so pages cached for the old file are never returned
+  db.remove("test1");
+  EXPECT_ANY_THROW(db.get(id1));
+  EXPECT_ANY_THROW(db::PageId("test1", 0));
+  db.add(std::make_unique<db::DbFile>("test1", td));
+  EXPECT_NE(db.get("test1").getId(), id1);
+  EXPECT_ANY_THROW(db.get(id1));
+}
+
+TEST(DatabaseTest, DirectIo) {
+  db::Database &db = db::getDatabase();
+  db::TupleDesc td;
+  std::string name = "direct";
+  std::remove(name.c_str());
+  db.add(std::make_unique<db::DbFile>(name, td));
+  EXPECT_FALSE(db.get(name).isDirectIo());
+  db.configureBufferPool({.direct_io = true});
+  db::DbFile &file = db.get(name);
+  if (!file.isDirectIo()) {
+    GTEST_SKIP() << "The filesystem does not support O_DIRECT";
+  }
+  for (size_t i = 0; i < 2 * db::DEFAULT_NUM_PAGES; i++) {
+    db::WritePageGuard guard = db.getBufferPool().fetchWrite({name, i});
+    guard->fill(i);
+  }
+  db.getBufferPool().flushFile(name);
+
+  // Pages outside of the pool need not be aligned
+  struct {
+    char pad;
+    db::Page page;
+  } unaligned;
+  file.readPage(unaligned.page, 3);
+  EXPECT_EQ(unaligned.page[0], 3);
+  unaligned.page.fill(42);
+  file.writePage(unaligned.page, 4);
+  db.configureBufferPool({});
+  EXPECT_FALSE(file.isDirectIo());
+  EXPECT_EQ(db.getBufferPool().fetchRead({name, 4})->at(0), 42);
+  EXPECT_EQ(db.getBufferPool().fetchRead({name, 99})->at(0), 99);
+  db.remove(name);
+  std::remove(name.c_str());
+}
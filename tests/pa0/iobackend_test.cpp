@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <db/Database.hpp>
+#include <db/IoBackend.hpp>
+#include <db/PageArena.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+void roundTrip(db::IoBackend &io) {
+  constexpr size_t num_pages = 200;
+  const char *name = "io.db";
+  std::remove(name);
+  int fd = open(name, O_RDWR | O_CREAT, 0644);
+  ASSERT_NE(fd, -1);
+
+  db::PageArena arena(num_pages, false);
+  io.registerBuffers(arena.data(), arena.capacity());
+  std::vector<db::IoRequest> writes;
+  for (size_t i = 0; i < num_pages; i++) {
+    arena[i].fill(static_cast<uint8_t>(i));
+    writes.push_back({fd, &arena[i], i * db::DEFAULT_PAGE_SIZE, true});
+  }
+  io.submit(writes);
+
+  // Read the pages back into other buffers in reverse order, then past the end of the file
+  std::vector<db::Page> copies(num_pages + 2);
+  std::vector<db::IoRequest> reads;
+  for (size_t i = 0; i < copies.size(); i++) {
+    copies[i].fill(0xff);
+    reads.push_back({fd, &copies[i], (copies.size() - 1 - i) * db::DEFAULT_PAGE_SIZE, false});
+  }
+  io.submit(reads);
+  for (size_t i = 0; i < copies.size(); i++) {
+    size_t page = copies.size() - 1 - i;
+    EXPECT_EQ(copies[i][db::DEFAULT_PAGE_SIZE - 1], page < num_pages ? static_cast<uint8_t>(page) : 0);
+  }
+
+  // Registered buffers work for reads as well
+  arena[0].fill(0);
+  db::IoRequest read{fd, &arena[0], 7 * db::DEFAULT_PAGE_SIZE, false};
+  io.submit({&read, 1});
+  EXPECT_EQ(arena[0][0], 7);
+
+  db::IoRequest bad{-1, &arena[0], 0, false};
+  EXPECT_THROW(io.submit({&bad, 1}), std::runtime_error);
+  close(fd);
+  std::remove(name);
+}
+} // namespace
+
+TEST(IoBackendTest, Sync) {
+  db::SyncIoBackend io;
+  roundTrip(io);
+}
+
+TEST(IoBackendTest, IoUring) {
+  std::unique_ptr<db::IoBackend> io = db::makeIoBackend(db::io_backend_t::IO_URING, 16);
+  if (dynamic_cast<db::IoUringBackend *>(io.get()) == nullptr) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  // The queue is shallower than the batches, so requests are submitted in several rounds
+  roundTrip(*io);
+}
+
+TEST(IoBackendTest, BufferPoolOnIoUring) {
+  constexpr size_t size = 32;
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = size, .io_backend = db::io_backend_t::IO_URING, .io_queue_depth = 8});
+  db::BufferPool &bufferPool = db.getBufferPool();
+
+  std::string name{"uring.db"};
+  std::remove(name.c_str());
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>(name, td));
+  for (size_t i = 0; i < 3 * size; i++) {
+    db::WritePageGuard guard = bufferPool.fetchWrite({name, i});
+    (*guard)[0] = static_cast<uint8_t>(i);
+  }
+  bufferPool.flushFile(name);
+  EXPECT_EQ(bufferPool.getStats().dirty_pages, 0);
+  for (size_t i = 0; i < 3 * size; i++) {
+    EXPECT_EQ(bufferPool.fetchRead({name, i})->at(0), static_cast<uint8_t>(i));
+  }
+  db.remove(name);
+  std::remove(name.c_str());
+}
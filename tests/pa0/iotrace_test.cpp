@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <db/Database.hpp>
+#include <db/IoTrace.hpp>
+
+TEST(IoTraceTest, Ring) {
+  db::IoTrace trace(4);
+  EXPECT_TRUE(trace.get().empty());
+  trace.record(1);
+  trace.record(2);
+  EXPECT_EQ(trace.get(), (std::vector<size_t>{1, 2}));
+  for (size_t i = 3; i <= 10; i++) {
+    trace.record(i);
+  }
+  // Only the last entries are kept
+  EXPECT_EQ(trace.get(), (std::vector<size_t>{7, 8, 9, 10}));
+  EXPECT_EQ(trace.size(), 10);
+  EXPECT_THROW(db::IoTrace(0), std::invalid_argument);
+}
+
+TEST(IoTraceTest, DbFileCounters) {
+  db::Database &db = db::getDatabase();
+  db::TupleDesc td;
+  std::string name = "traced";
+  std::remove(name.c_str());
+  db.add(std::make_unique<db::DbFile>(name, td));
+  db::DbFile &file = db.get(name);
+  db::BufferPool &bufferPool = db.getBufferPool();
+
+  // Counters are kept without a trace
+  for (size_t i = 0; i < 8; i++) {
+    bufferPool.fetchWrite({name, i});
+  }
+  bufferPool.flushFile(name);
+  EXPECT_TRUE(file.getReads().empty());
+  EXPECT_TRUE(file.getWrites().empty());
+  db::DbFileStats stats = file.getStats();
+  EXPECT_EQ(stats.pages_read, 8);
+  EXPECT_EQ(stats.pages_written, 8);
+  EXPECT_EQ(stats.bytes_written, 8 * db::DEFAULT_PAGE_SIZE);
+
+  file.setTrace(2);
+  db::Page page;
+  for (size_t i = 0; i < 5; i++) {
+    file.readPage(page, i);
+  }
+  EXPECT_EQ(file.getReads(), (std::vector<size_t>{3, 4}));
+  EXPECT_EQ(file.getStats().pages_read, 13);
+  file.setTrace(0);
+  file.readPage(page, 0);
+  EXPECT_TRUE(file.getReads().empty());
+  // The direct reads are timed by the file, the reads of the pool by the pool
+  size_t direct = 0;
+  for (size_t n : file.getStats().latency) {
+    direct += n;
+  }
+  EXPECT_EQ(direct, 6);
+
+  db::BufferPoolStats pool = bufferPool.getStats();
+  size_t calls = 0;
+  for (size_t n : pool.io_latency) {
+    calls += n;
+  }
+  EXPECT_EQ(calls, pool.read_calls + pool.write_calls);
+  EXPECT_GT(db::latencyPercentile(pool.io_latency, 0.5), 0);
+  EXPECT_LE(db::latencyPercentile(pool.io_latency, 0.5), db::latencyPercentile(pool.io_latency, 0.99));
+  db.remove(name);
+  std::remove(name.c_str());
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <db/PageTable.hpp>
+#include <random>
+#include <unordered_map>
+
+TEST(PageTableTest, InsertFindErase) {
+  db::PageTable table(4);
+  EXPECT_EQ(table.find({1, 0}), db::PageTable::npos);
+  table.insert({1, 0}, 10);
+  table.insert({2, 0}, 20);
+  table.insert({1, 1}, 11);
+  EXPECT_EQ(table.size(), 3);
+  EXPECT_EQ(table.find({1, 0}), 10);
+  EXPECT_EQ(table.find({2, 0}), 20);
+  EXPECT_EQ(table.find({1, 1}), 11);
+  EXPECT_FALSE(table.contains({2, 1}));
+
+  table.insert({1, 0}, 12);
+  EXPECT_EQ(table.find({1, 0}), 12);
+  EXPECT_EQ(table.size(), 3);
+
+  EXPECT_TRUE(table.erase({1, 0}));
+  EXPECT_FALSE(table.erase({1, 0}));
+  EXPECT_FALSE(table.contains({1, 0}));
+  EXPECT_EQ(table.find({2, 0}), 20);
+  EXPECT_EQ(table.find({1, 1}), 11);
+  EXPECT_EQ(table.size(), 2);
+}
+
+TEST(PageTableTest, Full) {
+  db::PageTable table(2);
+  table.insert({1, 0}, 0);
+  table.insert({1, 1}, 1);
+  EXPECT_THROW(table.insert({1, 2}, 2), std::length_error);
+  // Replacing the value of a page already in the table does not need a new slot
+  EXPECT_NO_THROW(table.insert({1, 1}, 3));
+  table.erase({1, 0});
+  EXPECT_NO_THROW(table.insert({1, 2}, 2));
+}
+
+TEST(PageTableTest, MatchesUnorderedMap) {
+  // Random operations on a small key space make long probe sequences and erasures in the middle of them
+  constexpr size_t capacity = 64;
+  db::PageTable table(capacity);
+  std::unordered_map<uint64_t, size_t> expected;
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<uint32_t> file(1, 3);
+  std::uniform_int_distribution<uint32_t> page(0, 40);
+  for (size_t i = 0; i < 100000; i++) {
+    db::PageId pid{file(rng), page(rng)};
+    if (rng() % 2 == 0 && expected.size() < capacity) {
+      table.insert(pid, i);
+      expected[pid.key()] = i;
+    } else {
+      EXPECT_EQ(table.erase(pid), expected.erase(pid.key()) == 1);
+    }
+    ASSERT_EQ(table.size(), expected.size());
+  }
+  for (uint32_t f = 1; f <= 3; f++) {
+    for (uint32_t p = 0; p <= 40; p++) {
+      auto it = expected.find(db::PageId{f, p}.key());
+      EXPECT_EQ(table.find({f, p}), it == expected.end() ? db::PageTable::npos : it->second);
+    }
+  }
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <db/Database.hpp>
+#include <db/ReplacementPolicy.hpp>
+
+TEST(ReplacementPolicyTest, LRU) {
+  db::LruPolicy policy(4);
+  for (size_t i = 0; i < 4; i++) {
+    policy.insert(i, {1, i});
+  }
+  EXPECT_EQ(policy.victim(), 0);
+  policy.access(0);
+  policy.access(2);
+  EXPECT_EQ(policy.victim(), 1);
+  policy.erase(1);
+  EXPECT_EQ(policy.victim(), 3);
+  policy.erase(3);
+  EXPECT_EQ(policy.victim(), 0);
+  policy.erase(0);
+  policy.erase(2);
+  EXPECT_ANY_THROW(policy.victim());
+}
+
+TEST(ReplacementPolicyTest, CLOCK) {
+  db::ClockPolicy policy(4);
+  for (size_t i = 0; i < 4; i++) {
+    policy.insert(i, {1, i});
+  }
+  // Every frame gets a second chance, then the hand stops at the first one
+  EXPECT_EQ(policy.victim(), 0);
+  policy.erase(0);
+  policy.insert(0, {1, 4});
+  policy.access(1);
+  EXPECT_EQ(policy.victim(), 2);
+  policy.erase(2);
+  EXPECT_EQ(policy.victim(), 3);
+}
+
+TEST(ReplacementPolicyTest, LRUK) {
+  db::LruKPolicy policy(3, 2);
+  for (size_t i = 0; i < 3; i++) {
+    policy.insert(i, {1, i});
+  }
+  policy.access(0);
+  policy.access(2);
+  // frame 1 has been accessed only once
+  EXPECT_EQ(policy.victim(), 1);
+  policy.erase(1);
+  EXPECT_EQ(policy.victim(), 0);
+
+  // Consecutive accesses are correlated and count as one
+  policy.insert(1, {1, 3});
+  policy.access(1);
+  policy.access(1);
+  EXPECT_EQ(policy.victim(), 1);
+}
+
+TEST(ReplacementPolicyTest, TwoQ) {
+  db::TwoQueuePolicy policy(8); // a1in holds 2 frames, a1out remembers 4 pages
+  for (size_t i = 0; i < 8; i++) {
+    policy.insert(i, {1, i});
+  }
+  // Pages are evicted in FIFO order regardless of hits
+  policy.access(0);
+  EXPECT_EQ(policy.victim(), 0);
+  policy.erase(0);
+  // Reloading a remembered page puts it in am
+  policy.insert(0, {1, 0});
+  EXPECT_EQ(policy.victim(), 1);
+  policy.erase(1);
+  for (size_t i = 2; i < 6; i++) {
+    EXPECT_EQ(policy.victim(), i);
+    policy.erase(i);
+  }
+  // a1in is back to its share of the frames, so am gives up a page
+  EXPECT_EQ(policy.victim(), 0);
+}
+
+namespace {
+// Mixes lookups on a few hot pages with a scan, then runs a scan on its own
+bool hotPagesSurviveScan(db::replacement_t policy) {
+  constexpr size_t frames = 100;
+  constexpr size_t hot = 10;
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = frames, .policy = policy});
+  db::BufferPool &bufferPool = db.getBufferPool();
+  db::TupleDesc td;
+  db.add(std::make_unique<db::DbFile>("index", td));
+  db.add(std::make_unique<db::DbFile>("heap", td));
+
+  size_t page = 0;
+  for (; page < 10 * frames; page++) {
+    for (size_t slot = 0; slot < 50; slot++) {
+      bufferPool.getPage({"heap", page});
+    }
+    bufferPool.getPage({"index", page % hot});
+  }
+  for (size_t i = 0; i < 10 * frames; i++, page++) {
+    for (size_t slot = 0; slot < 50; slot++) {
+      bufferPool.getPage({"heap", page});
+    }
+  }
+  for (size_t i = 0; i < hot; i++) {
+    if (!bufferPool.contains({"index", i})) {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+TEST(ReplacementPolicyTest, ScanResistanceLRU) { EXPECT_FALSE(hotPagesSurviveScan(db::replacement_t::LRU)); }
+
+TEST(ReplacementPolicyTest, ScanResistanceCLOCK) { EXPECT_FALSE(hotPagesSurviveScan(db::replacement_t::CLOCK)); }
+
+TEST(ReplacementPolicyTest, ScanResistanceLRUK) { EXPECT_TRUE(hotPagesSurviveScan(db::replacement_t::LRU_K)); }
+
+TEST(ReplacementPolicyTest, ScanResistanceTwoQ) { EXPECT_TRUE(hotPagesSurviveScan(db::replacement_t::TWO_Q)); }
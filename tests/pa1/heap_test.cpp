@@ -1,7 +1,20 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <db/BTreeFile.hpp>
 #include <db/Database.hpp>
 #include <db/HeapPage.hpp>
 #include <db/HeapFile.hpp>
+#include <db/HeapLoader.hpp>
+#include <db/HeapVacuum.hpp>
+#include <db/ParallelScan.hpp>
+#include <db/PaxPage.hpp>
+#include <db/SlottedPage.hpp>
+#include <db/StaticTupleDesc.hpp>
 #include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <thread>
 
 TEST(HeapPageTest, EmptyPage) {
   db::Page page{};
@@ -138,6 +151,158 @@ TEST(HeapPageTest, GetTuple) {
   EXPECT_EQ(count, 20);
 }
 
+TEST(HeapPageTest, WideHeader) {
+  // Narrow tuples give headers of several words whose last word is partial
+  for (const db::TupleDesc &td : {db::TupleDesc({db::type_t::INT}, {"id"}),
+                                  db::TupleDesc({db::type_t::INT, db::type_t::DOUBLE}, {"id", "price"})}) {
+    std::mt19937 rng(42);
+    for (unsigned density : {0, 1, 50, 99, 100}) {
+      db::Page page{};
+      for (auto &byte : page) {
+        byte = rng();
+      }
+      db::HeapPage hp(page, td);
+      const size_t capacity = hp.end();
+      std::vector<size_t> expected;
+      for (size_t slot = 0; slot < capacity; slot++) {
+        uint8_t bit = 1 << (7 - slot % 8);
+        page[slot / 8] = rng() % 100 < density ? page[slot / 8] | bit : page[slot / 8] & ~bit;
+        if (!hp.empty(slot)) {
+          expected.push_back(slot);
+        }
+      }
+      std::vector<size_t> slots;
+      for (size_t slot = hp.begin(); slot != hp.end(); hp.next(slot)) {
+        slots.push_back(slot);
+      }
+      EXPECT_EQ(slots, expected);
+      EXPECT_EQ(hp.size(), expected.size());
+      EXPECT_EQ(hp.freeSlots(), capacity - expected.size());
+
+      // Inserts fill the free slots in order, then fail
+      size_t free = hp.freeSlots();
+      for (size_t i = 0; i < free; i++) {
+        EXPECT_TRUE(hp.insertTuple(td.length() == db::INT_SIZE ? db::Tuple({0}) : db::Tuple({0, 0.0})));
+      }
+      EXPECT_EQ(hp.freeSlots(), 0);
+      EXPECT_FALSE(hp.insertTuple(td.length() == db::INT_SIZE ? db::Tuple({0}) : db::Tuple({0, 0.0})));
+      EXPECT_EQ(db::HeapPage(page, td).size(), capacity);
+    }
+  }
+}
+
+TEST(SlottedPageTest, InsertDelete) {
+  db::Page page{};
+  db::TupleDesc td({db::type_t::INT, db::type_t::VARCHAR}, {"id", "name"});
+  db::SlottedPage sp(page, td);
+  EXPECT_EQ(sp.begin(), sp.end());
+  EXPECT_EQ(sp.freeSpace(), db::SlottedPage::CAPACITY);
+
+  // Tuples of 8 + 100 bytes and a slot of 4 bytes each
+  std::string name(100, 'x');
+  size_t inserted = 0;
+  while (sp.insertTuple({{static_cast<int>(inserted), name}})) {
+    inserted++;
+  }
+  EXPECT_EQ(inserted, (db::DEFAULT_PAGE_SIZE - 4) / (8 + 100 + 4));
+  EXPECT_EQ(sp.size(), inserted);
+  EXPECT_LT(sp.freeSpace(), 8 + name.size());
+  // A shorter tuple still fits
+  EXPECT_TRUE(sp.insertTuple({{-1, "short"}}));
+  EXPECT_EQ(sp.getTuple(inserted).get_field(1), db::field_t("short"));
+
+  // Deleted slots are skipped, and reused by later inserts without moving the other tuples
+  sp.deleteTuple(3);
+  sp.deleteTuple(4);
+  EXPECT_THROW(sp.deleteTuple(4), std::runtime_error);
+  EXPECT_THROW(sp.getTuple(3), std::runtime_error);
+  EXPECT_THROW(sp.deleteTuple(sp.end()), std::runtime_error);
+  size_t slot = 2;
+  sp.next(slot);
+  EXPECT_EQ(slot, 5);
+  // Only fits in the two holes together: the page is compacted
+  std::string longer(180, 'y');
+  EXPECT_TRUE(sp.insertTuple({{100, longer}}));
+  EXPECT_EQ(sp.getTuple(3).get_field(1), db::field_t(longer));
+  EXPECT_TRUE(sp.empty(4));
+  for (size_t i = 0; i < inserted; i++) {
+    if (i != 3 && i != 4) {
+      EXPECT_EQ(sp.getTupleView(i).get_int(0), static_cast<int>(i));
+      EXPECT_EQ(sp.getTupleView(i).get_string_view(1), name);
+    }
+  }
+
+  // Deleting the last slots shrinks the directory, and an empty page starts over
+  size_t end = sp.end();
+  sp.deleteTuple(end - 1);
+  EXPECT_EQ(sp.end(), end - 1);
+  for (size_t i = sp.begin(); i != sp.end(); i = sp.begin()) {
+    sp.deleteTuple(i);
+  }
+  EXPECT_EQ(sp.end(), 0);
+  EXPECT_EQ(sp.freeSpace(), db::SlottedPage::CAPACITY);
+  EXPECT_TRUE(sp.insertTuple({{0, std::string(db::SlottedPage::CAPACITY - 8, 'z')}}));
+  EXPECT_EQ(sp.freeSpace(), 0);
+}
+
+TEST(SlottedPageTest, Select) {
+  db::Page page{};
+  db::TupleDesc td({db::type_t::INT, db::type_t::VARCHAR}, {"id", "name"});
+  db::SlottedPage sp(page, td);
+  for (int i = 0; i < 100; i++) {
+    sp.insertTuple({{i, std::string(i % 7, 'a')}});
+  }
+  sp.deleteTuple(65);
+  using op = db::predicate_op_t;
+  std::vector<db::Predicate> predicates{{1, op::EQ, "aaa"}, {0, op::GE, 10}};
+  db::Filter filter(td, predicates);
+  EXPECT_EQ(sp.select(0, filter), uint64_t{1} << (63 - 10) | uint64_t{1} << (63 - 17) | uint64_t{1} << (63 - 24) |
+                                      uint64_t{1} << (63 - 31) | uint64_t{1} << (63 - 38) | uint64_t{1} << (63 - 45) |
+                                      uint64_t{1} << (63 - 52) | uint64_t{1} << (63 - 59));
+  // The names of 5 and 6 characters among slots 64 to 99
+  std::vector<db::Predicate> prefix{{1, op::PREFIX, "aaaaa"}};
+  EXPECT_EQ(std::popcount(sp.select(1, db::Filter(td, prefix))), 10);
+  EXPECT_EQ(sp.select(2, filter), 0);
+}
+
+TEST(PaxPageTest, Minipages) {
+  db::Page page{};
+  db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  db::PaxPage pp(page, td);
+  constexpr size_t capacity = 53;
+  for (size_t i = 0; i < capacity; i++) {
+    EXPECT_TRUE(pp.insertTuple({{static_cast<int>(i), "Hello " + std::to_string(i), i * 0.5}}));
+  }
+  EXPECT_FALSE(pp.insertTuple({{0, "", 0.0}}));
+  EXPECT_EQ(pp.freeSlots(), 0);
+
+  // Same header as a HeapPage, then the ids of all the slots, the names, and the prices
+  db::HeapPage hp(page, td);
+  EXPECT_EQ(hp.size(), capacity);
+  const uint8_t *data = page.data() + db::DEFAULT_PAGE_SIZE - capacity * td.length();
+  for (size_t i = 0; i < capacity; i++) {
+    int id;
+    std::memcpy(&id, data + i * db::INT_SIZE, db::INT_SIZE);
+    EXPECT_EQ(id, static_cast<int>(i));
+    double price;
+    std::memcpy(&price, data + capacity * td.offset_of(2) + i * db::DOUBLE_SIZE, db::DOUBLE_SIZE);
+    EXPECT_EQ(price, i * 0.5);
+  }
+
+  pp.deleteTuple(7);
+  EXPECT_THROW(pp.getTuple(7), std::runtime_error);
+  EXPECT_EQ(pp.getTuple(8).get_field(1), db::field_t("Hello 8"));
+  db::TupleView view = pp.getTupleView(9);
+  EXPECT_EQ(view.get_int(0), 9);
+  EXPECT_EQ(view.get_string_view(1), "Hello 9");
+  EXPECT_EQ(view.get_double(2), 4.5);
+  EXPECT_TRUE(pp.insertTuple({{-7, "again", 0.0}}));
+  EXPECT_EQ(pp.getTuple(7).get_field(0), db::field_t(-7));
+
+  db::TupleDesc variable({db::type_t::INT, db::type_t::VARCHAR}, {"id", "name"});
+  EXPECT_THROW(db::PaxPage(page, variable), std::invalid_argument);
+}
+
 TEST(HeapFileTest, InsertTuple) {
   std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
   std::vector<std::string> names{"id", "name", "price"};
@@ -200,3 +365,1021 @@ TEST(HeapFileTest, EmptyPage) {
     i++;
   }
 }
+
+TEST(HeapFileTest, ConcurrentInsert) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+
+  const char *name = "heapfile";
+  std::remove(name);
+  db::getDatabase().configureBufferPool({.num_pages = 16, .num_shards = 4});
+  db::getDatabase().add(std::make_unique<db::HeapFile>(name, td));
+  auto &file = db::getDatabase().get(name);
+  constexpr size_t capacity = 53;
+  constexpr int num_threads = 4;
+  constexpr int per_thread = capacity * 10;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&file, t] {
+      for (int i = 0; i < per_thread; i++) {
+        file.insertTuple({{t * per_thread + i, "Hello", 3.14}});
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Every tuple is stored exactly once and no page is skipped
+  std::vector<bool> seen(num_threads * per_thread);
+  for (const auto &t : file) {
+    int id = std::get<int>(t.get_field(0));
+    EXPECT_FALSE(seen[id]);
+    seen[id] = true;
+  }
+  EXPECT_EQ(std::count(seen.begin(), seen.end(), true), num_threads * per_thread);
+  EXPECT_EQ(file.getNumPages(), num_threads * per_thread / capacity);
+}
+
+TEST(HeapFileTest, MappedScan) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+
+  const char *name = "mapped";
+  std::remove(name);
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = 4});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  auto &file = db.get(name);
+  constexpr int num_tuples = 1000;
+  for (int i = 0; i < num_tuples; i++) {
+    file.insertTuple({{i, "Hello", 3.14}});
+  }
+
+  // The pages still dirty in the pool are flushed before the file is mapped
+  file.map();
+  EXPECT_TRUE(file.isMapped());
+  db::BufferPoolStats before = db.getBufferPool().getStats();
+  int expected = 0;
+  for (const auto &t : file) {
+    EXPECT_EQ(std::get<int>(t.get_field(0)), expected++);
+  }
+  EXPECT_EQ(expected, num_tuples);
+  db::BufferPoolStats after = db.getBufferPool().getStats();
+  EXPECT_EQ(after.hits + after.misses, before.hits + before.misses);
+  EXPECT_THROW(file.insertTuple({{num_tuples, "Hello", 3.14}}), std::logic_error);
+
+  file.unmap();
+  file.insertTuple({{num_tuples, "Hello", 3.14}});
+  int count = 0;
+  for (const auto &t : file) {
+    count++;
+  }
+  EXPECT_EQ(count, num_tuples + 1);
+  db.remove(name);
+  std::remove(name);
+}
+
+TEST(HeapFileTest, FreeSpaceReuse) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+
+  const char *name = "reused";
+  std::remove(name);
+  std::remove("reused.fsm");
+  db::Database &db = db::getDatabase();
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  auto &file = db.get(name);
+  constexpr size_t capacity = 53;
+  for (size_t i = 0; i < capacity * 3; ++i) {
+    file.insertTuple({{static_cast<int>(i), "Hello", 3.14}});
+  }
+  EXPECT_EQ(file.getNumPages(), 3);
+
+  // Free the whole first page and one slot of the second
+  for (size_t slot = 0; slot < capacity; slot++) {
+    file.deleteTuple({file, 0, slot});
+  }
+  file.deleteTuple({file, 1, 7});
+  const db::FreeSpaceMap &fsm = dynamic_cast<db::HeapFile &>(file).getFreeSpaceMap();
+  EXPECT_EQ(fsm.get(0), db::FreeSpaceMap::EMPTY);
+  EXPECT_EQ(fsm.get(1), db::FreeSpaceMap::LOW);
+  EXPECT_EQ(fsm.get(2), db::FreeSpaceMap::FULL);
+  EXPECT_EQ(fsm.find(), 0);
+
+  // The map survives reopening the file
+  db.remove(name);
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  auto &reopened = db.get(name);
+  EXPECT_EQ(dynamic_cast<db::HeapFile &>(reopened).getFreeSpaceMap().get(0), db::FreeSpaceMap::EMPTY);
+  for (size_t i = 0; i < capacity + 1; ++i) {
+    reopened.insertTuple({{1000 + static_cast<int>(i), "Hello", 3.14}});
+  }
+  EXPECT_EQ(reopened.getNumPages(), 3);
+  EXPECT_EQ(reopened.getTuple({reopened, 1, 7}).get_field(0), db::field_t(1000 + static_cast<int>(capacity)));
+  reopened.insertTuple({{2000, "Hello", 3.14}});
+  EXPECT_EQ(reopened.getNumPages(), 4);
+  db.remove(name);
+  std::remove(name);
+  std::remove("reused.fsm");
+}
+
+TEST(HeapFileTest, BulkLoad) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+
+  const char *name = "loaded";
+  std::remove(name);
+  std::remove("loaded.fsm");
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = 4});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  auto &file = dynamic_cast<db::HeapFile &>(db.get(name));
+  constexpr size_t capacity = 53;
+  file.insertTuple({{0, "Hello", 3.14}});
+
+  // Fills the rest of page 0, then 10 whole pages and one slot of page 11, written 4 pages at a time
+  std::vector<db::Tuple> tuples;
+  for (size_t i = 1; i < capacity * 11 + 1; i++) {
+    tuples.push_back({{static_cast<int>(i), "Hello", 3.14}});
+  }
+  db::BufferPoolStats before = db.getBufferPool().getStats();
+  {
+    db::HeapLoader loader(file, 4);
+    for (const db::Tuple &t : tuples) {
+      loader.append(t);
+    }
+    EXPECT_THROW(loader.append({{0, 3.14}}), std::runtime_error);
+  }
+  db::BufferPoolStats after = db.getBufferPool().getStats();
+  EXPECT_EQ(after.hits + after.misses, before.hits + before.misses + capacity);
+  EXPECT_EQ(file.getNumPages(), 12);
+  EXPECT_EQ(file.getFreeSpaceMap().get(10), db::FreeSpaceMap::FULL);
+  EXPECT_EQ(file.getFreeSpaceMap().find(), 11);
+
+  // The next bulk insert fills page 11 through the pool
+  file.insertTuples(std::vector<db::Tuple>(capacity - 1, {{-1, "Hello", 3.14}}));
+  EXPECT_EQ(file.getNumPages(), 12);
+  size_t expected = 0;
+  for (const auto &t : file) {
+    int id = std::get<int>(t.get_field(0));
+    if (expected <= capacity * 11) {
+      EXPECT_EQ(id, static_cast<int>(expected));
+    } else {
+      EXPECT_EQ(id, -1);
+    }
+    expected++;
+  }
+  EXPECT_EQ(expected, capacity * 12);
+
+  // The loaded pages survive reopening the file
+  db.remove(name);
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  EXPECT_EQ(db.get(name).getNumPages(), 12);
+  EXPECT_EQ(db.get(name).getTuple({db.get(name), 5, 0}).get_field(0), db::field_t(5 * static_cast<int>(capacity)));
+  db.remove(name);
+  std::remove(name);
+  std::remove("loaded.fsm");
+}
+
+TEST(HeapFileTest, Views) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+
+  const char *name = "viewed";
+  std::remove(name);
+  std::remove("viewed.fsm");
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = 4});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  auto &file = db.get(name);
+  constexpr int num_tuples = 1000;
+  for (int i = 0; i < num_tuples; i++) {
+    file.insertTuple({{i, "Hello", i * 0.5}});
+  }
+  // Leave the first page and a page in the middle empty
+  for (size_t slot = 0; slot < 53; slot++) {
+    file.deleteTuple({file, 0, slot});
+    file.deleteTuple({file, 5, slot});
+  }
+
+  // Each page is fetched once for all of its tuples
+  db::BufferPoolStats before = db.getBufferPool().getStats();
+  int expected = 53;
+  for (db::TupleView t : file.views()) {
+    if (expected == 5 * 53) {
+      expected += 53;
+    }
+    EXPECT_EQ(t.get_int(0), expected);
+    EXPECT_EQ(t.get_string_view(1), "Hello");
+    EXPECT_EQ(t.get_double(2), expected * 0.5);
+    expected++;
+  }
+  EXPECT_EQ(expected, num_tuples);
+  db::BufferPoolStats after = db.getBufferPool().getStats();
+  // begin() fetches pages 0 and 1, then the views fetch every page after page 0 once
+  EXPECT_EQ(after.hits + after.misses, before.hits + before.misses + 2 + file.getNumPages() - 1);
+
+  auto it = file.views().begin();
+  EXPECT_EQ((*it).materialize().get_field(0), db::field_t(53));
+  EXPECT_EQ(it.position().page, 1);
+  it.release();
+
+  // The DbFile latches the page of the current tuple again: release it before deleting through the file
+  db::TupleViews views = file.views();
+  for (db::ViewIterator vit = views.begin(); vit != views.end(); ++vit) {
+    int id = (*vit).get_int(0);
+    if (id % 2 == 0) {
+      vit.release();
+      EXPECT_EQ(file.getTuple(vit.position()).get_field(0), db::field_t(id));
+      file.deleteTuple(vit.position());
+    }
+  }
+  expected = 0;
+  for (db::TupleView t : file.views()) {
+    EXPECT_EQ(t.get_int(0) % 2, 1);
+    expected++;
+  }
+  EXPECT_EQ(expected, (num_tuples - 2 * 53) / 2);
+  db.remove(name);
+  std::remove(name);
+  std::remove("viewed.fsm");
+}
+
+TEST(HeapFileTest, Chunks) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+
+  const char *name = "chunked";
+  std::remove(name);
+  std::remove("chunked.fsm");
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = 4});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  auto &file = db.get(name);
+  constexpr int num_tuples = 1000;
+  for (int i = 0; i < num_tuples; i++) {
+    file.insertTuple({{i, "Hello", i * 0.5}});
+  }
+  // Empty the first page and a page in the middle, and leave holes in another
+  for (size_t slot = 0; slot < 53; slot++) {
+    file.deleteTuple({file, 0, slot});
+    file.deleteTuple({file, 5, slot});
+  }
+  for (size_t slot = 0; slot < 53; slot += 2) {
+    file.deleteTuple({file, 8, slot});
+  }
+  std::vector<int> expected;
+  for (const auto &t : file) {
+    expected.push_back(std::get<int>(t.get_field(0)));
+  }
+
+  // Chunks smaller than a page, and chunks that end exactly at the end of a page
+  for (size_t capacity : {20, 53, 1000}) {
+    db::DataChunk chunk(td, capacity);
+    db::Iterator it = file.begin();
+    std::vector<int> ids;
+    while (size_t rows = file.scan(it, chunk)) {
+      EXPECT_TRUE(rows == capacity || it == file.end());
+      for (size_t r = 0; r < rows; r++) {
+        ids.push_back(chunk.ints(0)[r]);
+        EXPECT_EQ(chunk.strings(1)[r], "Hello");
+        EXPECT_EQ(chunk.doubles(2)[r], chunk.ints(0)[r] * 0.5);
+      }
+    }
+    EXPECT_EQ(ids, expected);
+    EXPECT_EQ(it, file.end());
+  }
+  db.remove(name);
+  std::remove(name);
+  std::remove("chunked.fsm");
+}
+
+TEST(HeapFileTest, Pushdown) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+
+  const char *name = "filtered";
+  std::remove(name);
+  std::remove("filtered.fsm");
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = 4});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  auto &file = db.get(name);
+  std::mt19937 rng(42);
+  constexpr int num_tuples = 5000;
+  for (int i = 0; i < num_tuples; i++) {
+    int id = static_cast<int>(rng() % 1000) - 500;
+    file.insertTuple({{id, i % 3 == 0 ? "apple" : "banana", id * 0.25}});
+  }
+  for (size_t slot = 0; slot < 53; slot += 3) {
+    file.deleteTuple({file, 2, slot});
+  }
+
+  using op = db::predicate_op_t;
+  std::vector<std::vector<db::Predicate>> cases{
+      {},
+      {{0, op::GT, 42}},
+      {{0, op::LT, std::numeric_limits<int>::min()}},
+      {{0, op::NE, 0}, {2, op::LE, 10.0}},
+      {{2, op::BETWEEN, -3.0, 7.5}},
+      {{2, op::GE, 1000.0}},
+      {{1, op::EQ, "apple"}, {0, op::GE, 0}},
+      {{1, op::PREFIX, "ban"}},
+      {{1, op::NE, "apple"}, {2, op::LT, 0.0}},
+  };
+  for (const auto &predicates : cases) {
+    auto expected = [&](const db::Tuple &t) {
+      for (const db::Predicate &p : predicates) {
+        const db::field_t &f = t.get_field(p.column);
+        bool ok = false;
+        switch (p.op) {
+        case op::EQ: ok = f == p.value; break;
+        case op::NE: ok = f != p.value; break;
+        case op::LT: ok = f < p.value; break;
+        case op::LE: ok = f <= p.value; break;
+        case op::GT: ok = f > p.value; break;
+        case op::GE: ok = f >= p.value; break;
+        case op::BETWEEN: ok = f >= p.value && f <= p.upper; break;
+        case op::PREFIX: ok = std::get<std::string>(f).starts_with(std::get<std::string>(p.value)); break;
+        }
+        if (!ok) {
+          return false;
+        }
+      }
+      return true;
+    };
+    std::vector<int> ids;
+    for (const auto &t : file) {
+      if (expected(t)) {
+        ids.push_back(std::get<int>(t.get_field(0)));
+      }
+    }
+    for (bool simd : {false, true}) {
+      db::Filter filter(td, predicates, simd);
+      for (size_t capacity : {7, 2048}) {
+        db::DataChunk chunk(td, capacity);
+        db::Iterator it = file.begin();
+        std::vector<int> found;
+        while (size_t rows = file.scan(it, chunk, filter)) {
+          found.insert(found.end(), chunk.ints(0).begin(), chunk.ints(0).end());
+          for (size_t r = 0; r < rows; r++) {
+            EXPECT_TRUE(expected(chunk.getTuple(r)));
+          }
+        }
+        EXPECT_EQ(found, ids);
+        EXPECT_EQ(it, file.end());
+      }
+    }
+  }
+
+  EXPECT_THROW(db::Filter(td, std::vector<db::Predicate>{{3, op::EQ, 0}}), std::invalid_argument);
+  EXPECT_THROW(db::Filter(td, std::vector<db::Predicate>{{0, op::EQ, 1.0}}), std::invalid_argument);
+  EXPECT_THROW(db::Filter(td, std::vector<db::Predicate>{{0, op::PREFIX, 1}}), std::invalid_argument);
+  EXPECT_THROW(db::Filter(td, std::vector<db::Predicate>{{1, op::LT, "apple"}}), std::invalid_argument);
+  db.remove(name);
+  std::remove(name);
+  std::remove("filtered.fsm");
+}
+
+TEST(HeapFileTest, Projection) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+
+  const char *name = "projected";
+  std::remove(name);
+  std::remove("projected.fsm");
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = 4});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  auto &file = db.get(name);
+  constexpr int num_tuples = 500;
+  for (int i = 0; i < num_tuples; i++) {
+    file.insertTuple({{i, "Hello", i * 0.5}});
+  }
+
+  db::Projection projection(td, std::vector<std::string>{"price"});
+  db::Tuple t = file.getTuple({file, 1, 2}, projection);
+  EXPECT_EQ(t.size(), 1);
+  EXPECT_EQ(t.get_field(0), db::field_t(55 * 0.5));
+
+  int expected = 0;
+  for (db::TupleView view : file.views(projection)) {
+    EXPECT_EQ(view.size(), 1);
+    EXPECT_EQ(view.get_double(0), expected++ * 0.5);
+  }
+  EXPECT_EQ(expected, num_tuples);
+
+  // Filter on a field the chunk does not decode
+  db::DataChunk chunk(projection, 64);
+  db::Filter filter(td, std::vector<db::Predicate>{{0, db::predicate_op_t::GE, 400}});
+  db::Iterator it = file.begin();
+  std::vector<double> prices;
+  while (file.scan(it, chunk, filter)) {
+    EXPECT_EQ(chunk.getTupleDesc().size(), 1);
+    prices.insert(prices.end(), chunk.doubles(0).begin(), chunk.doubles(0).end());
+  }
+  ASSERT_EQ(prices.size(), 100);
+  EXPECT_EQ(prices.front(), 200.0);
+  db.remove(name);
+  std::remove(name);
+  std::remove("projected.fsm");
+}
+
+TEST(HeapFileTest, Varchar) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::VARCHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+
+  const char *name = "varchar";
+  std::remove(name);
+  std::remove("varchar.fsm");
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = 4});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  auto &file = dynamic_cast<db::HeapFile &>(db.get(name));
+  auto nameOf = [](int i) { return std::string(i % 200, static_cast<char>('a' + i % 26)); };
+  constexpr int num_tuples = 2000;
+  for (int i = 0; i < num_tuples / 2; i++) {
+    file.insertTuple({{i, nameOf(i), i * 0.5}});
+  }
+  std::vector<db::Tuple> tuples;
+  for (int i = num_tuples / 2; i < num_tuples; i++) {
+    tuples.push_back({{i, nameOf(i), i * 0.5}});
+  }
+  file.insertTuples(tuples);
+  EXPECT_THROW(file.insertTuple({{0, std::string(db::DEFAULT_PAGE_SIZE, 'x'), 0.0}}), std::runtime_error);
+  EXPECT_THROW(file.insertTuple({{0, 1, 0.0}}), std::runtime_error);
+  EXPECT_THROW(db::BTreeFile("varchar.btree", td, 0), std::invalid_argument);
+
+  int expected = 0;
+  for (const auto &t : file) {
+    EXPECT_EQ(t.get_field(0), db::field_t(expected));
+    EXPECT_EQ(t.get_field(1), db::field_t(nameOf(expected)));
+    expected++;
+  }
+  EXPECT_EQ(expected, num_tuples);
+  size_t pages = file.getNumPages();
+
+  // The space of deleted tuples is reused before the file grows
+  std::vector<int> deleted;
+  for (db::Iterator it = file.begin(); it != file.end(); ++it) {
+    if (it.slot % 3 == 0 && it.page < pages - 1) {
+      deleted.push_back(std::get<int>(file.getTuple(it).get_field(0)));
+      file.deleteTuple(it);
+    }
+  }
+  for (int id : deleted) {
+    file.insertTuple({{id + num_tuples, nameOf(id), 0.0}});
+  }
+  EXPECT_EQ(file.getNumPages(), pages);
+
+  std::vector<int> ids;
+  std::vector<int> prefixed;
+  for (const auto &t : file) {
+    int id = std::get<int>(t.get_field(0));
+    EXPECT_EQ(t.get_field(1), db::field_t(nameOf(id % num_tuples)));
+    ids.push_back(id);
+    if (std::get<std::string>(t.get_field(1)).starts_with("bbb") && id >= num_tuples) {
+      prefixed.push_back(id);
+    }
+  }
+  db::DataChunk chunk(td, 100);
+  std::vector<int> scanned;
+  for (db::Iterator it = file.begin(); file.scan(it, chunk);) {
+    for (size_t r = 0; r < chunk.size(); r++) {
+      EXPECT_EQ(chunk.strings(1)[r], nameOf(chunk.ints(0)[r] % num_tuples));
+      scanned.push_back(chunk.ints(0)[r]);
+    }
+  }
+  EXPECT_EQ(scanned, ids);
+  using op = db::predicate_op_t;
+  std::vector<db::Predicate> predicates{{1, op::PREFIX, "bbb"}, {0, op::GE, num_tuples}};
+  db::Filter filter(td, predicates);
+  scanned.clear();
+  for (db::Iterator it = file.begin(); file.scan(it, chunk, filter);) {
+    scanned.insert(scanned.end(), chunk.ints(0).begin(), chunk.ints(0).end());
+  }
+  EXPECT_EQ(scanned, prefixed);
+  db.remove(name);
+  std::remove(name);
+  std::remove("varchar.fsm");
+  std::remove("varchar.btree");
+}
+
+TEST(HeapFileTest, Pax) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+
+  // The same tuples and deletes in a file of each layout: every read must agree
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = 8});
+  std::vector<std::string> files{"rows", "pax"};
+  for (const std::string &name : files) {
+    std::remove(name.c_str());
+    std::remove((name + ".fsm").c_str());
+    auto layout = name == "pax" ? db::page_layout_t::PAX : db::page_layout_t::ROW;
+    db.add(std::make_unique<db::HeapFile>(name, td, layout));
+  }
+  auto &rows = dynamic_cast<db::HeapFile &>(db.get("rows"));
+  auto &pax = dynamic_cast<db::HeapFile &>(db.get("pax"));
+  EXPECT_EQ(pax.getLayout(), db::page_layout_t::PAX);
+  std::mt19937 rng(7);
+  std::vector<db::Tuple> tuples;
+  for (int i = 0; i < 3000; i++) {
+    int id = static_cast<int>(rng() % 1000);
+    tuples.push_back({{id, id % 2 ? "odd" : "even", id * 0.25}});
+  }
+  for (db::HeapFile *file : {&rows, &pax}) {
+    for (size_t i = 0; i < 1000; i++) {
+      file->insertTuple(tuples[i]);
+    }
+    file->insertTuples(std::span(tuples).subspan(1000));
+    for (size_t slot = 0; slot < 53; slot += 4) {
+      file->deleteTuple({*file, 3, slot});
+      file->deleteTuple({*file, 20, slot});
+    }
+    file->insertTuple({{-2, "even", -0.5}});
+  }
+  EXPECT_EQ(pax.getNumPages(), rows.getNumPages());
+  EXPECT_THROW(db::HeapFile("pax_varchar", db::TupleDesc({db::type_t::VARCHAR}, {"name"}), db::page_layout_t::PAX),
+               std::invalid_argument);
+
+  auto contents = [](const db::HeapFile &file) {
+    std::vector<db::Tuple> all;
+    for (const db::Tuple &t : file) {
+      all.push_back(t);
+    }
+    return all;
+  };
+  std::vector<db::Tuple> expected = contents(rows);
+  std::vector<db::Tuple> actual = contents(pax);
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    for (size_t f = 0; f < td.size(); f++) {
+      EXPECT_EQ(actual[i].get_field(f), expected[i].get_field(f));
+    }
+  }
+
+  db::Projection projection(td, std::vector<size_t>{2, 1});
+  std::vector<double> prices;
+  for (db::TupleView view : pax.views(projection)) {
+    prices.push_back(view.get_double(0));
+    EXPECT_EQ(view.get_string_view(1), static_cast<int>(view.get_double(0) * 4) % 2 ? "odd" : "even");
+  }
+  EXPECT_EQ(prices.size(), expected.size());
+  EXPECT_EQ(pax.getTuple({pax, 5, 3}, projection).get_field(1), rows.getTuple({rows, 5, 3}, projection).get_field(1));
+
+  using op = db::predicate_op_t;
+  std::vector<std::vector<db::Predicate>> cases{
+      {}, {{0, op::LT, 100}}, {{2, op::BETWEEN, 10.0, 20.0}, {1, op::EQ, "odd"}}, {{1, op::PREFIX, "ev"}}};
+  for (const auto &predicates : cases) {
+    for (bool simd : {false, true}) {
+      db::Filter filter(td, predicates, simd);
+      for (size_t capacity : {7, 2048}) {
+        std::vector<int> found[2];
+        for (int layout = 0; layout < 2; layout++) {
+          db::HeapFile &file = layout ? pax : rows;
+          db::DataChunk chunk(td, capacity);
+          db::Iterator it = file.begin();
+          while (file.scan(it, chunk, filter)) {
+            found[layout].insert(found[layout].end(), chunk.ints(0).begin(), chunk.ints(0).end());
+            EXPECT_EQ(chunk.strings(1)[0], chunk.ints(0)[0] % 2 ? "odd" : "even");
+          }
+        }
+        EXPECT_EQ(found[1], found[0]);
+      }
+    }
+  }
+  db::DataChunk chunk(projection, 100);
+  std::vector<double> scanned;
+  for (db::Iterator it = pax.begin(); pax.scan(it, chunk);) {
+    scanned.insert(scanned.end(), chunk.doubles(0).begin(), chunk.doubles(0).end());
+  }
+  EXPECT_EQ(scanned, prices);
+
+  // The layout is recorded when a file is created: reopening it with the other layout throws
+  for (const std::string &name : files) {
+    db.remove(name);
+    auto layout = name == "pax" ? db::page_layout_t::PAX : db::page_layout_t::ROW;
+    auto other = name == "pax" ? db::page_layout_t::ROW : db::page_layout_t::PAX;
+    EXPECT_THROW(db::HeapFile(name, td, other), std::invalid_argument);
+    db.add(std::make_unique<db::HeapFile>(name, td, layout));
+  }
+  EXPECT_EQ(contents(dynamic_cast<db::HeapFile &>(db.get("pax"))).size(), expected.size());
+  EXPECT_EQ(contents(dynamic_cast<db::HeapFile &>(db.get("rows"))).size(), expected.size());
+
+  for (const std::string &name : files) {
+    db.remove(name);
+    std::remove(name.c_str());
+    std::remove((name + ".fsm").c_str());
+  }
+  std::remove("pax_varchar");
+  std::remove("pax_varchar.fsm");
+}
+
+TEST(HeapFileTest, ZoneMap) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = 64});
+  const std::string files[] = {"zones_plain", "zones"};
+  for (int zoned = 0; zoned < 2; zoned++) {
+    std::remove(files[zoned].c_str());
+    std::remove((files[zoned] + ".fsm").c_str());
+    std::remove((files[zoned] + ".zm").c_str());
+    db.add(std::make_unique<db::HeapFile>(files[zoned], td, db::page_layout_t::ROW, zoned));
+  }
+  auto &plain = dynamic_cast<db::HeapFile &>(db.get(files[0]));
+  auto &zones = dynamic_cast<db::HeapFile &>(db.get(files[1]));
+  EXPECT_EQ(plain.getZoneMap(), nullptr);
+  ASSERT_NE(zones.getZoneMap(), nullptr);
+
+  // Clustered ids: page p holds the ids [53 * p, 53 * p + 52]
+  constexpr size_t capacity = 53;
+  constexpr int num_pages = 20;
+  std::vector<db::Tuple> tuples;
+  for (size_t i = 0; i < capacity * num_pages; i++) {
+    tuples.push_back({{static_cast<int>(i), i % 2 ? "odd" : "even", i * 0.5}});
+    plain.insertTuple(tuples.back());
+  }
+  zones.insertTuples(tuples);
+  const db::ZoneMap &map = *zones.getZoneMap();
+  EXPECT_EQ(map.count(3), capacity);
+  EXPECT_EQ(map.range(3, 0), std::make_pair(159.0, 211.0));
+  EXPECT_EQ(map.range(3, 2), std::make_pair(79.5, 105.5));
+  EXPECT_THROW(map.range(3, 1), std::invalid_argument);
+
+  // Empty page 0, and widen it again with an insert that reuses its slots
+  for (size_t slot = 0; slot < capacity; slot++) {
+    plain.deleteTuple({plain, 0, slot});
+    zones.deleteTuple({zones, 0, slot});
+  }
+  EXPECT_EQ(map.count(0), 0);
+  plain.deleteTuple({plain, 4, 0});
+  zones.deleteTuple({zones, 4, 0});
+  EXPECT_EQ(map.count(4), capacity - 1);
+  EXPECT_EQ(map.range(4, 0), std::make_pair(212.0, 264.0));
+  plain.insertTuple({{100000, "big", -1.0}});
+  zones.insertTuple({{100000, "big", -1.0}});
+  EXPECT_EQ(map.range(0, 0), std::make_pair(100000.0, 100000.0));
+
+  using op = db::predicate_op_t;
+  struct Case {
+    std::vector<db::Predicate> predicates;
+    size_t read;
+  };
+  std::vector<Case> cases{
+      {{{0, op::BETWEEN, 200, 260}}, 2},
+      {{{0, op::GE, 99999}}, 1},
+      {{{0, op::NE, 100000}}, num_pages - 1},
+      {{{2, op::LT, 0.0}, {1, op::EQ, "big"}}, 1},
+      {{{0, op::LT, 500}, {2, op::GT, 200.0}}, 3},
+      {{{1, op::EQ, "odd"}}, num_pages},
+  };
+  db::BufferPool &pool = db.getBufferPool();
+  for (const Case &c : cases) {
+    db::Filter filter(td, c.predicates);
+    std::vector<int> found[2];
+    db::BufferPoolStats before[2];
+    db::ZoneMapStats zone_before = map.getStats();
+    for (int zoned = 0; zoned < 2; zoned++) {
+      db::HeapFile &file = zoned ? zones : plain;
+      // One call per scan, which fetches each page it reads once
+      db::DataChunk chunk(td, 2048);
+      before[zoned] = pool.getStats();
+      for (db::Iterator it = file.begin(); file.scan(it, chunk, filter);) {
+        found[zoned].insert(found[zoned].end(), chunk.ints(0).begin(), chunk.ints(0).end());
+      }
+    }
+    db::BufferPoolStats after = pool.getStats();
+    db::ZoneMapStats zone_after = map.getStats();
+    EXPECT_EQ(found[1], found[0]);
+    EXPECT_EQ(zone_after.pages_skipped - zone_before.pages_skipped, num_pages - c.read);
+    EXPECT_EQ(zone_after.bytes_skipped - zone_before.bytes_skipped, (num_pages - c.read) * db::DEFAULT_PAGE_SIZE);
+    // The page read by begin(), then the pages that were not skipped
+    EXPECT_EQ(after.hits + after.misses - before[1].hits - before[1].misses, 1 + c.read);
+  }
+
+  // The map is written when the file is closed, and loaded again when it is opened
+  db.remove(files[1]);
+  db.add(std::make_unique<db::HeapFile>(files[1], td, db::page_layout_t::ROW, true));
+  const db::ZoneMap &reopened = *dynamic_cast<db::HeapFile &>(db.get(files[1])).getZoneMap();
+  EXPECT_TRUE(reopened.covers(num_pages - 1));
+  EXPECT_EQ(reopened.count(4), capacity - 1);
+  EXPECT_EQ(reopened.range(0, 0), std::make_pair(100000.0, 100000.0));
+  EXPECT_EQ(reopened.range(3, 2), std::make_pair(79.5, 105.5));
+
+  // A map changed after it was last written is discarded
+  {
+    db::ZoneMap changed("zones_changed.zm", td, 0);
+    changed.add(0, {{1, "one", 1.0}});
+    changed.flush();
+    changed.add(0, {{2, "two", 2.0}});
+    db::ZoneMap loaded("zones_changed.zm", td, 1);
+    EXPECT_FALSE(loaded.covers(0));
+  }
+  {
+    db::ZoneMap loaded("zones_changed.zm", td, 1);
+    EXPECT_EQ(loaded.range(0, 0), std::make_pair(1.0, 2.0));
+  }
+
+  for (const std::string &name : files) {
+    db.remove(name);
+    std::remove(name.c_str());
+    std::remove((name + ".fsm").c_str());
+    std::remove((name + ".zm").c_str());
+  }
+  std::remove("zones_changed.zm");
+}
+
+TEST(HeapFileTest, Vacuum) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+  db::TupleDesc varchar_td({db::type_t::INT, db::type_t::VARCHAR}, {"id", "name"});
+
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = 64});
+  const std::string files[] = {"vacuum", "vacuum_varchar"};
+  for (const std::string &name : files) {
+    std::remove(name.c_str());
+    std::remove((name + ".fsm").c_str());
+    std::remove((name + ".zm").c_str());
+  }
+  db.add(std::make_unique<db::HeapFile>(files[0], td, db::page_layout_t::ROW, true));
+  db.add(std::make_unique<db::HeapFile>(files[1], varchar_td));
+  for (const std::string &name : files) {
+    auto &file = dynamic_cast<db::HeapFile &>(db.get(name));
+    bool varchar = &name == &files[1];
+    constexpr int num_tuples = 53 * 20;
+    for (int i = 0; i < num_tuples; i++) {
+      file.insertTuple(varchar ? db::Tuple({i, std::string(i % 50, 'x')}) : db::Tuple({i, "name", i * 0.5}));
+    }
+    // Keep one tuple in four, and a whole page at the start
+    std::map<std::pair<size_t, size_t>, int> ids;
+    std::vector<int> expected;
+    for (db::Iterator it = file.begin(); it != file.end(); ++it) {
+      int id = std::get<int>((*it).get_field(0));
+      if (id % 4 == 0 || id < 53) {
+        ids[{it.page, it.slot}] = id;
+        expected.push_back(id);
+      } else {
+        file.deleteTuple(it);
+      }
+    }
+    size_t pages = file.getNumPages();
+
+    db::HeapVacuum vacuum(file, {.moves_per_step = 7});
+    size_t steps = 0;
+    size_t truncated = vacuum.run([&](std::span<const db::TupleMove> moves) {
+      EXPECT_LE(moves.size(), 7);
+      steps++;
+      for (const db::TupleMove &move : moves) {
+        EXPECT_LT(move.to_page, move.from_page);
+        auto node = ids.extract({move.from_page, move.from_slot});
+        ASSERT_FALSE(node.empty());
+        node.key() = {move.to_page, move.to_slot};
+        ASSERT_TRUE(ids.insert(std::move(node)).inserted);
+      }
+    });
+    EXPECT_TRUE(vacuum.done());
+    EXPECT_GT(steps, 1);
+    EXPECT_EQ(file.getNumPages(), pages - truncated);
+    EXPECT_LT(file.getNumPages(), pages / 2);
+
+    // Every tuple is where the moves say it is
+    std::vector<int> found;
+    for (db::Iterator it = file.begin(); it != file.end(); ++it) {
+      int id = std::get<int>((*it).get_field(0));
+      EXPECT_EQ(ids[std::make_pair(it.page, it.slot)], id);
+      found.push_back(id);
+    }
+    EXPECT_EQ(found.size(), expected.size());
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(found, expected);
+    if (!varchar) {
+      // 53 tuples per page
+      EXPECT_EQ(file.getNumPages(), (expected.size() + 52) / 53);
+      db::Filter filter(td, std::vector<db::Predicate>{{0, db::predicate_op_t::GE, 1000}});
+      db::DataChunk chunk(td);
+      db::Iterator it = file.begin();
+      file.scan(it, chunk, filter);
+      EXPECT_EQ(chunk.size(), std::count_if(expected.begin(), expected.end(), [](int id) { return id >= 1000; }));
+    }
+
+    // Nothing is left to move, and the file grows back from its new end
+    EXPECT_TRUE(db::HeapVacuum(file).step().empty());
+    for (int i = 0; i < 200; i++) {
+      file.insertTuple(varchar ? db::Tuple({-1, std::string("y")}) : db::Tuple({-1, "name", 0.0}));
+    }
+    size_t count = 0;
+    for (db::Iterator it = file.begin(); it != file.end(); ++it) {
+      count++;
+    }
+    EXPECT_EQ(count, expected.size() + 200);
+  }
+  for (const std::string &name : files) {
+    db.remove(name);
+    std::remove(name.c_str());
+    std::remove((name + ".fsm").c_str());
+    std::remove((name + ".zm").c_str());
+  }
+}
+
+TEST(HeapFileTest, ParallelScan) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+
+  const char *name = "parallel";
+  std::remove(name);
+  std::remove("parallel.fsm");
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = 32, .num_shards = 4});
+  db.add(std::make_unique<db::HeapFile>(name, td));
+  auto &file = dynamic_cast<db::HeapFile &>(db.get(name));
+  constexpr int num_tuples = 53 * 100;
+  for (int i = 0; i < num_tuples; i++) {
+    file.insertTuple({{i, i % 2 ? "odd" : "even", i * 0.5}});
+  }
+  for (size_t slot = 0; slot < 53; slot++) {
+    // Empty pages are scanned too
+    file.deleteTuple({file, 7, slot});
+  }
+
+  db::ThreadPool pool(4);
+  ASSERT_EQ(pool.size(), 4);
+  EXPECT_THROW(db::ThreadPool(0), std::invalid_argument);
+  db::ParallelScan scan(file, pool, 3);
+
+  // Every page is handed out once
+  std::vector<std::atomic<int>> visits(file.getNumPages());
+  db::ParallelScanStats stats = scan.run([&](size_t worker, size_t first, size_t end) {
+    EXPECT_LT(worker, pool.size());
+    EXPECT_LE(end - first, 3);
+    for (size_t page = first; page < end; page++) {
+      visits[page]++;
+    }
+  });
+  for (const std::atomic<int> &v : visits) {
+    EXPECT_EQ(v, 1);
+  }
+  // At most one short morsel at the end of each range, and of each steal
+  EXPECT_GE(stats.morsels, (file.getNumPages() + 2) / 3);
+  EXPECT_LE(stats.morsels, (file.getNumPages() + 2) / 3 + pool.size() + stats.steals);
+
+  db::Projection projection(td, {0, 2});
+  std::vector<int> expected;
+  for (int i = 0; i < num_tuples; i++) {
+    if (i / 53 != 7) {
+      expected.push_back(i);
+    }
+  }
+  for (bool filtered : {false, true}) {
+    std::vector<std::vector<int>> found(pool.size());
+    db::Filter filter(td, std::vector<db::Predicate>{{1, db::predicate_op_t::EQ, "odd"}});
+    auto consume = [&](size_t worker, const db::DataChunk &chunk) {
+      EXPECT_EQ(chunk.getTupleDesc().size(), 2);
+      for (size_t i = 0; i < chunk.size(); i++) {
+        EXPECT_EQ(chunk.doubles(1)[i], chunk.ints(0)[i] * 0.5);
+      }
+      found[worker].insert(found[worker].end(), chunk.ints(0).begin(), chunk.ints(0).end());
+    };
+    filtered ? scan.run(projection, filter, consume) : scan.run(projection, consume);
+    std::vector<int> all;
+    for (const std::vector<int> &ids : found) {
+      all.insert(all.end(), ids.begin(), ids.end());
+    }
+    std::sort(all.begin(), all.end());
+    std::vector<int> want;
+    std::copy_if(expected.begin(), expected.end(), std::back_inserter(want), [&](int id) { return !filtered || id % 2; });
+    EXPECT_EQ(all, want);
+  }
+
+  // An exception stops its worker, and is rethrown once the others are done
+  std::atomic<size_t> scanned = 0;
+  EXPECT_THROW(scan.run([&](size_t, size_t first, size_t end) {
+    scanned += end - first;
+    if (first == 0) {
+      throw std::runtime_error("consumer failed");
+    }
+  }),
+               std::runtime_error);
+  EXPECT_LE(scanned, file.getNumPages());
+
+  db.remove(name);
+  std::remove(name);
+  std::remove("parallel.fsm");
+}
+
+TEST(HeapFileTest, Serialized) {
+  using Row = db::StaticTupleDesc<int, db::Char, double>;
+  db::TupleDesc td = Row::desc({"id", "name", "price"});
+  db::Database &db = db::getDatabase();
+  db.configureBufferPool({.num_pages = 8});
+
+  // The same tuples inserted as Tuples and as serialized rows, in a file of each layout: every read must agree
+  std::vector<std::string> files{"tuples", "rows", "pax"};
+  for (const std::string &name : files) {
+    std::remove(name.c_str());
+    std::remove((name + ".fsm").c_str());
+    std::remove((name + ".zm").c_str());
+    auto layout = name == "pax" ? db::page_layout_t::PAX : db::page_layout_t::ROW;
+    db.add(std::make_unique<db::HeapFile>(name, td, layout, true));
+  }
+  auto &tuples = dynamic_cast<db::HeapFile &>(db.get("tuples"));
+  auto &rows = dynamic_cast<db::HeapFile &>(db.get("rows"));
+  auto &pax = dynamic_cast<db::HeapFile &>(db.get("pax"));
+  for (int i = 0; i < 500; i++) {
+    Row::row_type row{i, i % 2 ? "odd" : "even", i * 0.25};
+    tuples.insertTuple(Row::tuple(row));
+    rows.insertSerialized(Row::serialize(row));
+    pax.insertSerialized(Row::serialize(row));
+  }
+  for (db::HeapFile *file : {&tuples, &rows, &pax}) {
+    file->deleteTuple({*file, 2, 5});
+  }
+  rows.insertSerialized(Row::serialize({-1, "odd", -0.25}));
+  pax.insertSerialized(Row::serialize({-1, "odd", -0.25}));
+  tuples.insertTuple({{-1, "odd", -0.25}});
+  EXPECT_THROW(rows.insertSerialized(std::vector<uint8_t>(td.length() - 1)), std::invalid_argument);
+
+  auto contents = [](const db::HeapFile &file) {
+    std::vector<Row::row_type> all;
+    for (const db::Tuple &t : file) {
+      all.push_back(Row::row(t));
+    }
+    return all;
+  };
+  std::vector<Row::row_type> expected = contents(tuples);
+  EXPECT_EQ(expected.size(), 500);
+  EXPECT_EQ(contents(rows), expected);
+  EXPECT_EQ(contents(pax), expected);
+  for (db::HeapFile *file : {&rows, &pax}) {
+    EXPECT_EQ(file->getNumPages(), tuples.getNumPages());
+    EXPECT_EQ(file->getZoneMap()->range(0, 0), tuples.getZoneMap()->range(0, 0));
+    EXPECT_EQ(file->getZoneMap()->range(2, 2), tuples.getZoneMap()->range(2, 2));
+  }
+  // The fields of a row are read in place from the views of a row page
+  int sum = 0;
+  for (db::TupleView view : rows.views()) {
+    sum += Row::get<0>(view.bytes());
+    EXPECT_EQ(Row::get<1>(view.bytes()), Row::get<0>(view.bytes()) % 2 ? "odd" : "even");
+  }
+  EXPECT_EQ(sum, 499 * 500 / 2 - (2 * 53 + 5) - 1);
+
+  // Rows with VARCHAR fields, as serialized by the TupleDesc
+  db::TupleDesc varchar({db::type_t::INT, db::type_t::VARCHAR}, {"id", "note"});
+  std::remove("notes");
+  std::remove("notes.fsm");
+  db.add(std::make_unique<db::HeapFile>("notes", varchar));
+  auto &notes = dynamic_cast<db::HeapFile &>(db.get("notes"));
+  for (int i = 0; i < 200; i++) {
+    db::Tuple t({i, std::string(i, 'x')});
+    std::vector<uint8_t> row(varchar.length(t));
+    varchar.serialize(row.data(), t);
+    notes.insertSerialized(row);
+  }
+  EXPECT_THROW(notes.insertSerialized(std::vector<uint8_t>(varchar.length() - 1)), std::invalid_argument);
+  EXPECT_THROW(notes.insertSerialized(std::vector<uint8_t>(db::SlottedPage::CAPACITY + 1)), std::invalid_argument);
+  {
+    // The characters of a VARCHAR field past the end of the row, or over its fixed-size fields
+    db::Tuple t({-1, std::string("bad")});
+    std::vector<uint8_t> row(varchar.length(t));
+    varchar.serialize(row.data(), t);
+    size_t field = varchar.offset_of(1);
+    uint16_t size = 4;
+    std::memcpy(row.data() + field + sizeof(uint16_t), &size, sizeof(uint16_t));
+    EXPECT_THROW(notes.insertSerialized(row), std::invalid_argument);
+    varchar.serialize(row.data(), t);
+    uint16_t at = 0;
+    std::memcpy(row.data() + field, &at, sizeof(uint16_t));
+    EXPECT_THROW(notes.insertSerialized(row), std::invalid_argument);
+  }
+  int i = 0;
+  for (const db::Tuple &t : notes) {
+    EXPECT_EQ(t.get_field(1), db::field_t(std::string(std::get<int>(t.get_field(0)), 'x')));
+    i++;
+  }
+  EXPECT_EQ(i, 200);
+
+  files.push_back("notes");
+  for (const std::string &name : files) {
+    db.remove(name);
+    std::remove(name.c_str());
+    std::remove((name + ".fsm").c_str());
+    std::remove((name + ".zm").c_str());
+  }
+}
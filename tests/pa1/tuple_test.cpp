@@ -1,4 +1,7 @@
-#include <db/Tuple.hpp>
+#include <db/DataChunk.hpp>
+#include <db/Projection.hpp>
+#include <db/StaticTupleDesc.hpp>
+#include <db/TupleView.hpp>
 #include <gtest/gtest.h>
 
 TEST(TupleTest, Constructor) {
@@ -105,3 +108,182 @@ TEST(TupleTest, MergeConflict) {
 
   EXPECT_ANY_THROW(db::TupleDesc::merge(td1, td2));  // Non-unique names
 }
+
+TEST(TupleTest, View) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+
+  std::vector<uint8_t> data(td.length());
+  td.serialize(data.data(), {{7, "Hello", 3.14}});
+  db::TupleView view(td, data.data());
+  EXPECT_EQ(view.size(), 3);
+  EXPECT_EQ(view.field_type(1), db::type_t::CHAR);
+  EXPECT_EQ(view.get_int(0), 7);
+  EXPECT_EQ(view.get_string_view(1), "Hello");
+  EXPECT_EQ(view.get_double(2), 3.14);
+  EXPECT_EQ(view.get_field(1), db::field_t("Hello"));
+  EXPECT_THROW(view.get_double(0), std::logic_error);
+  EXPECT_THROW(view.get_int(3), std::out_of_range);
+
+  db::Tuple t = view.materialize();
+  EXPECT_EQ(t.get_field(0), db::field_t(7));
+  EXPECT_EQ(t.get_field(2), db::field_t(3.14));
+
+  // A string that fills the field has no terminating NUL
+  std::string full(db::CHAR_SIZE, 'x');
+  td.serialize(data.data(), {{7, full, 3.14}});
+  EXPECT_EQ(view.get_string_view(1), full);
+}
+
+TEST(TupleTest, DataChunk) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+
+  std::vector<uint8_t> data(3 * td.length());
+  std::vector<const uint8_t *> rows;
+  for (int i = 0; i < 3; i++) {
+    td.serialize(&data[i * td.length()], {{i, std::string(i + 1, 'a'), i * 0.5}});
+    rows.push_back(&data[i * td.length()]);
+  }
+  EXPECT_THROW(db::DataChunk(td, 0), std::invalid_argument);
+  db::DataChunk chunk(td, 4);
+  chunk.append({rows.data(), 2});
+  chunk.append({rows.data() + 2, 1});
+  EXPECT_EQ(chunk.size(), 3);
+  EXPECT_FALSE(chunk.full());
+  EXPECT_THROW(chunk.append(rows), std::length_error);
+  EXPECT_EQ(std::vector<int>(chunk.ints(0).begin(), chunk.ints(0).end()), std::vector<int>({0, 1, 2}));
+  EXPECT_EQ(chunk.strings(1)[2], "aaa");
+  EXPECT_EQ(chunk.doubles(2)[1], 0.5);
+  EXPECT_THROW(chunk.doubles(0), std::bad_variant_access);
+  EXPECT_EQ(chunk.getTuple(1).get_field(1), db::field_t("aa"));
+  EXPECT_THROW(chunk.getTuple(3), std::out_of_range);
+
+  // The strings are copied: they outlive the rows
+  std::fill(data.begin(), data.end(), 0);
+  EXPECT_EQ(chunk.strings(1)[0], "a");
+  chunk.clear();
+  EXPECT_EQ(chunk.size(), 0);
+  EXPECT_TRUE(chunk.ints(0).empty());
+}
+
+TEST(TupleTest, Projection) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE};
+  std::vector<std::string> names{"id", "name", "price"};
+  db::TupleDesc td(types, names);
+
+  db::TupleDesc projected = td.project(std::vector<size_t>{2, 0});
+  EXPECT_EQ(projected.size(), 2);
+  EXPECT_EQ(projected.index_of("price"), 0);
+  EXPECT_EQ(projected.type_of(1), db::type_t::INT);
+  EXPECT_EQ(projected.length(), db::DOUBLE_SIZE + db::INT_SIZE);
+  EXPECT_THROW(td.project(std::vector<size_t>{3}), std::out_of_range);
+  EXPECT_THROW(td.project(std::vector<size_t>{0, 0}), std::logic_error);
+
+  std::vector<uint8_t> data(td.length());
+  td.serialize(data.data(), {{7, "Hello", 3.14}});
+  db::Projection projection(td, std::vector<std::string>{"price", "id"});
+  EXPECT_EQ(projection.getColumns(), std::vector<size_t>({2, 0}));
+  db::TupleView view = projection.view(data.data());
+  EXPECT_EQ(view.size(), 2);
+  EXPECT_EQ(view.get_double(0), 3.14);
+  EXPECT_EQ(view.get_int(1), 7);
+  EXPECT_THROW(view.get_int(2), std::out_of_range);
+  db::Tuple t = projection.project(data.data());
+  EXPECT_EQ(t.size(), 2);
+  EXPECT_EQ(t.get_field(0), db::field_t(3.14));
+  EXPECT_EQ(t.get_field(1), db::field_t(7));
+  EXPECT_THROW(db::Projection(td, std::vector<std::string>{"missing"}), std::out_of_range);
+
+  db::DataChunk chunk(projection, 2);
+  const uint8_t *row = data.data();
+  chunk.append({&row, 1});
+  EXPECT_EQ(chunk.doubles(0)[0], 3.14);
+  EXPECT_EQ(chunk.ints(1)[0], 7);
+}
+
+TEST(TupleTest, Varchar) {
+  std::vector<db::type_t> types{db::type_t::INT, db::type_t::VARCHAR, db::type_t::DOUBLE, db::type_t::VARCHAR};
+  std::vector<std::string> names{"id", "name", "price", "note"};
+  db::TupleDesc td(types, names);
+  EXPECT_TRUE(td.variable_length());
+  EXPECT_FALSE(td.project(std::vector<size_t>{0, 2}).variable_length());
+  EXPECT_EQ(td.length(), db::INT_SIZE + 2 * db::VARCHAR_SIZE + db::DOUBLE_SIZE);
+  EXPECT_TRUE(td.compatible({{1, "a", 1.0, ""}}));
+  EXPECT_FALSE(td.compatible({{1, 2, 1.0, ""}}));
+
+  // Longer than a CHAR field: nothing is truncated
+  std::string long_name(3 * db::CHAR_SIZE, 'n');
+  db::Tuple t({7, long_name, 3.14, ""});
+  EXPECT_EQ(td.length(t), td.length() + long_name.size());
+  std::vector<uint8_t> data(td.length(t));
+  td.serialize(data.data(), t);
+  db::Tuple copy = td.deserialize(data.data());
+  for (size_t i = 0; i < t.size(); i++) {
+    EXPECT_EQ(copy.get_field(i), t.get_field(i));
+  }
+
+  db::TupleView view(td, data.data());
+  EXPECT_EQ(view.get_string_view(1), long_name);
+  EXPECT_EQ(view.get_string_view(3), "");
+  EXPECT_EQ(view.get_field(1), db::field_t(long_name));
+  db::Projection projection(td, std::vector<size_t>{3, 1});
+  EXPECT_EQ(projection.view(data.data()).get_string_view(1), long_name);
+
+  // The characters of the values of a chunk are copied, and stay valid as the chunk grows
+  db::DataChunk chunk(projection, 64);
+  std::vector<std::vector<uint8_t>> rows;
+  std::vector<const uint8_t *> pointers;
+  for (int i = 0; i < 64; i++) {
+    db::Tuple row({i, std::string(i * 10, 'a' + i % 26), 0.0, std::to_string(i)});
+    rows.emplace_back(td.length(row));
+    td.serialize(rows.back().data(), row);
+    pointers.push_back(rows.back().data());
+  }
+  chunk.append({pointers.data(), 1});
+  chunk.append({pointers.data() + 1, 63});
+  rows.clear();
+  for (int i = 0; i < 64; i++) {
+    EXPECT_EQ(chunk.strings(0)[i], std::to_string(i));
+    EXPECT_EQ(chunk.strings(1)[i], std::string(i * 10, 'a' + i % 26));
+  }
+  EXPECT_EQ(chunk.getTuple(5).get_field(1), db::field_t(std::string(50, 'f')));
+}
+
+TEST(TupleTest, Static) {
+  using Row = db::StaticTupleDesc<int, db::Char, double>;
+  static_assert(Row::length() == db::INT_SIZE + db::CHAR_SIZE + db::DOUBLE_SIZE);
+  static_assert(Row::offset_of(2) == db::INT_SIZE + db::CHAR_SIZE);
+  static_assert(Row::type_of(1) == db::type_t::CHAR);
+  db::TupleDesc td = Row::desc({"id", "name", "price"});
+  EXPECT_TRUE(Row::matches(td));
+  EXPECT_EQ(td.length(), Row::length());
+  for (size_t i = 0; i < Row::size(); i++) {
+    EXPECT_EQ(td.offset_of(i), Row::offset_of(i));
+  }
+  EXPECT_FALSE(Row::matches(db::TupleDesc({db::type_t::INT, db::type_t::CHAR}, {"id", "name"})));
+  db::TupleDesc varchar({db::type_t::INT, db::type_t::VARCHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  EXPECT_FALSE(Row::matches(varchar));
+  EXPECT_THROW(Row::desc({"id"}), std::logic_error);
+
+  // The same bytes as the TupleDesc, including the truncated CHAR and its padding
+  std::string long_name(2 * db::CHAR_SIZE, 'n');
+  for (const Row::row_type &row : {Row::row_type{7, "apple", 3.5}, Row::row_type{-1, long_name, -0.25}}) {
+    auto bytes = Row::serialize(row);
+    std::vector<uint8_t> expected(td.length(), 0xff);
+    td.serialize(expected.data(), Row::tuple(row));
+    EXPECT_TRUE(std::equal(bytes.begin(), bytes.end(), expected.begin()));
+
+    Row::row_type copy = Row::deserialize(bytes.data());
+    EXPECT_EQ(std::get<0>(copy), std::get<0>(row));
+    EXPECT_EQ(std::get<1>(copy), std::get<1>(row).substr(0, db::CHAR_SIZE));
+    EXPECT_EQ(std::get<2>(copy), std::get<2>(row));
+    EXPECT_EQ(Row::row(td.deserialize(bytes.data())), copy);
+    EXPECT_EQ(Row::get<0>(bytes.data()), std::get<0>(row));
+    EXPECT_EQ(Row::get<1>(bytes.data()), std::get<1>(copy));
+    EXPECT_EQ(Row::get<2>(bytes.data()), db::TupleView(td, bytes.data()).get_double(2));
+  }
+  EXPECT_THROW(Row::row({{1, 2, 3.0}}), std::bad_variant_access);
+}
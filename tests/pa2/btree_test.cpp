@@ -1,5 +1,7 @@
 #include <db/BTreeFile.hpp>
+#include <db/BufferPool.hpp>
 #include <db/Database.hpp>
+#include <db/StaticTupleDesc.hpp>
 #include <gtest/gtest.h>
 
 TEST(BTreeTest, Empty) {
@@ -51,3 +53,99 @@ TEST(BTreeTest, Random) {
   }
   EXPECT_EQ(i, 1000000);
 }
+
+TEST(BTreeTest, Views) {
+  const char *name = "views.db";
+  std::remove(name);
+  db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  db::getDatabase().add(std::make_unique<db::BTreeFile>(name, td, 0));
+  auto &file = db::getDatabase().get(name);
+  for (int i = 1000; i > 0; i--) {
+    file.insertTuple({{i, "apple", i * 0.5}});
+  }
+  int i = 1;
+  for (db::TupleView t : file.views()) {
+    EXPECT_EQ(t.get_int(0), i);
+    EXPECT_EQ(t.get_string_view(1), "apple");
+    EXPECT_EQ(t.get_double(2), i * 0.5);
+    i++;
+  }
+  EXPECT_EQ(i, 1001);
+  db::getDatabase().remove(name);
+  std::remove(name);
+}
+
+TEST(BTreeTest, Chunks) {
+  const char *name = "chunks.db";
+  std::remove(name);
+  db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  db::getDatabase().add(std::make_unique<db::BTreeFile>(name, td, 0));
+  auto &file = db::getDatabase().get(name);
+  for (int i = 1000; i > 0; i--) {
+    file.insertTuple({{i, "apple", i * 0.5}});
+  }
+  db::DataChunk chunk(td, 300);
+  db::Iterator it = file.begin();
+  int expected = 1;
+  while (size_t rows = file.scan(it, chunk)) {
+    EXPECT_EQ(rows, std::min(300, 1001 - expected));
+    for (size_t r = 0; r < rows; r++, expected++) {
+      EXPECT_EQ(chunk.ints(0)[r], expected);
+      EXPECT_EQ(chunk.strings(1)[r], "apple");
+      EXPECT_EQ(chunk.doubles(2)[r], expected * 0.5);
+    }
+  }
+  EXPECT_EQ(expected, 1001);
+  EXPECT_EQ(it, file.end());
+  db::getDatabase().remove(name);
+  std::remove(name);
+}
+
+TEST(BTreeTest, Pushdown) {
+  const char *name = "pushdown.db";
+  std::remove(name);
+  db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+  db::getDatabase().add(std::make_unique<db::BTreeFile>(name, td, 0));
+  auto &file = db::getDatabase().get(name);
+  for (int i = 1000; i > 0; i--) {
+    file.insertTuple({{i, "apple", i * 0.5}});
+  }
+  db::Filter filter(td, std::vector<db::Predicate>{{0, db::predicate_op_t::BETWEEN, 100, 349}});
+  db::DataChunk chunk(td, 100);
+  db::Iterator it = file.begin();
+  std::vector<int> ids;
+  while (file.scan(it, chunk, filter)) {
+    ids.insert(ids.end(), chunk.ints(0).begin(), chunk.ints(0).end());
+  }
+  ASSERT_EQ(ids.size(), 250);
+  EXPECT_EQ(ids.front(), 100);
+  EXPECT_EQ(ids.back(), 349);
+  db::getDatabase().remove(name);
+  std::remove(name);
+}
+
+TEST(BTreeTest, Serialized) {
+  const char *name = "serialized.db";
+  std::remove(name);
+  using Row = db::StaticTupleDesc<double, int, db::Char>;
+  db::TupleDesc td = Row::desc({"price", "id", "name"});
+  db::getDatabase().add(std::make_unique<db::BTreeFile>(name, td, 1));
+  auto &file = dynamic_cast<db::BTreeFile &>(db::getDatabase().get(name));
+  for (int i = 0; i < 100000; i++) {
+    int k = i % 2 ? 100000 - i : i;
+    file.insertSerialized(Row::serialize({k * 0.5, k, "apple"}));
+  }
+  // Replaces the tuple of the key
+  file.insertSerialized(Row::serialize({-1.0, 42, "pear"}));
+  EXPECT_THROW(file.insertSerialized(std::vector<uint8_t>(td.length() + 1)), std::invalid_argument);
+  int i = 0;
+  for (db::TupleView t : file.views()) {
+    EXPECT_EQ(Row::get<1>(t.bytes()), i);
+    EXPECT_EQ(Row::get<0>(t.bytes()), i == 42 ? -1.0 : i * 0.5);
+    EXPECT_EQ(Row::get<2>(t.bytes()), i == 42 ? "pear" : "apple");
+    i++;
+  }
+  EXPECT_EQ(i, 100000);
+  db::getDatabase().remove(name);
+  std::remove(name);
+}